@@ -20,15 +20,132 @@
 
 #include "agg_file.h"
 
+#include <algorithm>
 #include <cctype>
 #include <cstdint>
 #include <iterator>
 #include <string>
 
+#if defined( _WIN32 )
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif !defined( __EMSCRIPTEN__ ) && !defined( TARGET_PS_VITA ) && !defined( TARGET_NINTENDO_SWITCH )
+#define FHEROES2_AGG_MMAP_SUPPORTED
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "logging.h"
+
+namespace
+{
+    // FNV-1a hash.
+    uint32_t calculateHash( const uint8_t * data, const size_t size, uint32_t hash = 2166136261U )
+    {
+        for ( size_t i = 0; i < size; ++i ) {
+            hash ^= data[i];
+            hash *= 16777619U;
+        }
+
+        return hash;
+    }
+
+    // Maps the whole file into memory for reading. Returns nullptr if memory mapping is not supported on this platform or has failed.
+    const uint8_t * mapFile( const std::string & fileName, size_t & size )
+    {
+        size = 0;
+
+#if defined( _WIN32 )
+        const HANDLE file = CreateFileA( fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+        if ( file == INVALID_HANDLE_VALUE ) {
+            return nullptr;
+        }
+
+        LARGE_INTEGER fileSize;
+        if ( !GetFileSizeEx( file, &fileSize ) || fileSize.QuadPart <= 0 ) {
+            CloseHandle( file );
+            return nullptr;
+        }
+
+        const HANDLE mapping = CreateFileMappingA( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+        // The mapping keeps a reference to the file, so the file handle is no longer needed.
+        CloseHandle( file );
+
+        if ( mapping == nullptr ) {
+            return nullptr;
+        }
+
+        const void * data = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+        // The view keeps a reference to the mapping.
+        CloseHandle( mapping );
+
+        if ( data == nullptr ) {
+            return nullptr;
+        }
+
+        size = static_cast<size_t>( fileSize.QuadPart );
+
+        return static_cast<const uint8_t *>( data );
+#elif defined( FHEROES2_AGG_MMAP_SUPPORTED )
+        const int fd = ::open( fileName.c_str(), O_RDONLY );
+        if ( fd < 0 ) {
+            return nullptr;
+        }
+
+        struct stat fileStat;
+        if ( fstat( fd, &fileStat ) != 0 || fileStat.st_size <= 0 ) {
+            ::close( fd );
+            return nullptr;
+        }
+
+        void * data = mmap( nullptr, static_cast<size_t>( fileStat.st_size ), PROT_READ, MAP_PRIVATE, fd, 0 );
+        // The mapping keeps a reference to the file, so the file descriptor is no longer needed.
+        ::close( fd );
+
+        if ( data == MAP_FAILED ) {
+            return nullptr;
+        }
+
+        size = static_cast<size_t>( fileStat.st_size );
+
+        return static_cast<const uint8_t *>( data );
+#else
+        (void)fileName;
+
+        return nullptr;
+#endif
+    }
+
+    void unmapFile( const uint8_t * data, const size_t size )
+    {
+#if defined( _WIN32 )
+        (void)size;
+
+        UnmapViewOfFile( data );
+#elif defined( FHEROES2_AGG_MMAP_SUPPORTED )
+        munmap( const_cast<uint8_t *>( data ), size );
+#else
+        (void)data;
+        (void)size;
+#endif
+    }
+}
+
 namespace fheroes2
 {
+    AGGFile::~AGGFile()
+    {
+        _unmap();
+    }
+
     bool AGGFile::open( const std::string & fileName )
     {
+        _unmap();
+        _files.clear();
+        _contentHash.reset();
+
         if ( !_stream.open( fileName, "rb" ) ) {
             return false;
         }
@@ -61,15 +178,76 @@ namespace fheroes2
             _files.try_emplace( std::move( name ), std::make_pair( fileSize, fileOffset ) );
         }
 
-        if ( _files.size() != count ) {
+        if ( _files.size() != count || _stream.fail() ) {
             _files.clear();
             return false;
         }
 
-        return !_stream.fail();
+        _mappedData = mapFile( fileName, _mappedSize );
+        if ( _mappedData == nullptr ) {
+            DEBUG_LOG( DBG_ENGINE, DBG_INFO, "Unable to memory-map the file " << fileName << ", its contents will be read on demand" )
+            return true;
+        }
+
+        if ( _mappedSize != size ) {
+            // The file has been changed while it was being opened.
+            _unmap();
+            _files.clear();
+            return false;
+        }
+
+        // All reads are done from the mapped memory.
+        _stream.close();
+
+        return true;
+    }
+
+    uint32_t AGGFile::getContentHash()
+    {
+        if ( _contentHash ) {
+            return *_contentHash;
+        }
+
+        if ( _mappedData != nullptr ) {
+            _contentHash = calculateHash( _mappedData, _mappedSize );
+            return *_contentHash;
+        }
+
+        // Read the file in chunks to avoid keeping its whole contents in memory.
+        const size_t chunkSize = 1024 * 1024;
+        const size_t size = _stream.size();
+
+        uint32_t hash = calculateHash( nullptr, 0 );
+
+        _stream.seek( 0 );
+
+        for ( size_t offset = 0; offset < size && !_stream.fail(); offset += chunkSize ) {
+            const std::vector<uint8_t> chunk = _stream.getRaw( std::min( chunkSize, size - offset ) );
+            hash = calculateHash( chunk.data(), chunk.size(), hash );
+        }
+
+        _contentHash = hash;
+        return hash;
     }
 
     std::vector<uint8_t> AGGFile::read( const std::string & fileName )
+    {
+        if ( _mappedData == nullptr ) {
+            readView( fileName );
+
+            // Make sure that the returned container is not a reference, so returning it will invoke a move constructor.
+            std::vector<uint8_t> buf = std::move( _buffer );
+            _buffer.clear();
+
+            return buf;
+        }
+
+        const auto [data, size] = readView( fileName );
+
+        return { data, data + size };
+    }
+
+    std::pair<const uint8_t *, size_t> AGGFile::readView( const std::string & fileName )
     {
         auto it = _files.find( fileName );
         if ( it == _files.end() ) {
@@ -77,12 +255,35 @@ namespace fheroes2
         }
 
         const auto [fileSize, fileOffset] = it->second;
-        if ( fileSize > 0 ) {
-            _stream.seek( fileOffset );
-            return _stream.getRaw( fileSize );
+        if ( fileSize == 0 ) {
+            return {};
+        }
+
+        if ( _mappedData != nullptr ) {
+            if ( static_cast<size_t>( fileOffset ) + fileSize > _mappedSize ) {
+                // This is a corrupted AGG file.
+                return {};
+            }
+
+            return { _mappedData + fileOffset, fileSize };
+        }
+
+        _stream.seek( fileOffset );
+        _buffer = _stream.getRaw( fileSize );
+
+        return { _buffer.data(), _buffer.size() };
+    }
+
+    void AGGFile::_unmap()
+    {
+        if ( _mappedData == nullptr ) {
+            return;
         }
 
-        return {};
+        unmapFile( _mappedData, _mappedSize );
+
+        _mappedData = nullptr;
+        _mappedSize = 0;
     }
 
     uint32_t calculateAggFilenameHash( const std::string_view str )
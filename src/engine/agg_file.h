@@ -24,6 +24,7 @@
 #include <cstdint>
 #include <functional>
 #include <map>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -33,22 +34,57 @@
 
 namespace fheroes2
 {
+    // If the platform supports it, the whole AGG file is memory-mapped, so the contents of the files stored in it can be read in
+    // place without copying. Otherwise the files are read from the disk on demand.
     class AGGFile
     {
     public:
+        AGGFile() = default;
+        AGGFile( const AGGFile & ) = delete;
+
+        ~AGGFile();
+
+        AGGFile & operator=( const AGGFile & ) = delete;
+
         bool isGood() const
         {
-            return !_stream.fail() && !_files.empty();
+            return ( _mappedData != nullptr || !_stream.fail() ) && !_files.empty();
+        }
+
+        bool isMemoryMapped() const
+        {
+            return _mappedData != nullptr;
         }
 
         bool open( const std::string & fileName );
+
+        // Returns the hash of the whole contents of the AGG file. It is calculated on the first call, which reads the whole file
+        // if it is not memory-mapped.
+        uint32_t getContentHash();
+
+        // Returns a copy of the contents of the given file.
         std::vector<uint8_t> read( const std::string & fileName );
 
+        // Returns a view of the contents of the given file or an empty view if there is no such file. If the AGG file is memory-mapped,
+        // then the view remains valid as long as this object is not destroyed or reopened. Otherwise the data is read into an internal
+        // buffer and the view remains valid only until the next call of read() or readView().
+        std::pair<const uint8_t *, size_t> readView( const std::string & fileName );
+
     private:
         static const size_t _maxFilenameSize = 15; // 8.3 ASCIIZ file name + 2-bytes padding
 
+        void _unmap();
+
         StreamFile _stream;
         std::map<std::string, std::pair<uint32_t, uint32_t>, std::less<>> _files;
+
+        std::optional<uint32_t> _contentHash;
+
+        const uint8_t * _mappedData{ nullptr };
+        size_t _mappedSize{ 0 };
+
+        // Used only if the AGG file is not memory-mapped.
+        std::vector<uint8_t> _buffer;
     };
 
     struct ICNHeader
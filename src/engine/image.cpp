@@ -26,8 +26,14 @@
 #include <cstddef>
 #include <cstdlib>
 #include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 #include "image_palette.h"
+#include "image_simd.h"
 
 namespace
 {
@@ -393,6 +399,73 @@ namespace
         return rgbToId[red + green * 64 + blue * 64 * 64];
     }
 
+    uint8_t blendColors( const uint8_t * gamePalette, const uint8_t inValue, const uint8_t outValue, const uint8_t alphaValue )
+    {
+        const uint8_t behindValue = 255 - alphaValue;
+
+        const uint8_t * inPAL = gamePalette + static_cast<ptrdiff_t>( inValue ) * 3;
+        const uint8_t * outPAL = gamePalette + static_cast<ptrdiff_t>( outValue ) * 3;
+
+        const uint32_t red = static_cast<uint32_t>( *inPAL ) * alphaValue + static_cast<uint32_t>( *outPAL ) * behindValue;
+        const uint32_t green = static_cast<uint32_t>( *( inPAL + 1 ) ) * alphaValue + static_cast<uint32_t>( *( outPAL + 1 ) ) * behindValue;
+        const uint32_t blue = static_cast<uint32_t>( *( inPAL + 2 ) ) * alphaValue + static_cast<uint32_t>( *( outPAL + 2 ) ) * behindValue;
+        return GetPALColorId( static_cast<uint8_t>( red / 255 ), static_cast<uint8_t>( green / 255 ), static_cast<uint8_t>( blue / 255 ) );
+    }
+
+    // Blend tables contain the results of blending of all pairs of colors for a certain alpha value, indexed by ( inValue * 256 + outValue ).
+    // Only a few alpha values are used at the same time (mostly for fading effects) so the number of cached tables is limited.
+    class AlphaBlendTableCache
+    {
+    public:
+        // Returns nullptr if it is faster to blend the given number of pixels directly.
+        std::shared_ptr<const std::vector<uint8_t>> get( const uint8_t alphaValue, const int64_t pixelCount )
+        {
+            const std::lock_guard<std::mutex> guard( _mutex );
+
+            auto iter = std::find_if( _tables.begin(), _tables.end(), [alphaValue]( const auto & table ) { return table.first == alphaValue; } );
+            if ( iter != _tables.end() ) {
+                _tables.splice( _tables.begin(), _tables, iter );
+                return _tables.front().second;
+            }
+
+            if ( pixelCount < _minPixelCount ) {
+                return {};
+            }
+
+            auto table = std::make_shared<std::vector<uint8_t>>( 256 * 256 );
+
+            const uint8_t * gamePalette = fheroes2::getGamePalette();
+            uint8_t * value = table->data();
+
+            for ( uint32_t inValue = 0; inValue < 256; ++inValue ) {
+                for ( uint32_t outValue = 0; outValue < 256; ++outValue, ++value ) {
+                    *value = blendColors( gamePalette, static_cast<uint8_t>( inValue ), static_cast<uint8_t>( outValue ), alphaValue );
+                }
+            }
+
+            if ( _tables.size() >= _maxTableCount ) {
+                _tables.pop_back();
+            }
+
+            _tables.emplace_front( alphaValue, std::move( table ) );
+
+            return _tables.front().second;
+        }
+
+    private:
+        // The calculation of a table takes about the same time as direct blending of this number of pixels.
+        static constexpr int64_t _minPixelCount = 256 * 256;
+
+        static constexpr size_t _maxTableCount = 16;
+
+        std::mutex _mutex;
+
+        // The most recently used tables are at the front.
+        std::list<std::pair<uint8_t, std::shared_ptr<const std::vector<uint8_t>>>> _tables;
+    };
+
+    AlphaBlendTableCache alphaBlendTableCache;
+
     void ApplyRawPalette( const fheroes2::Image & in, int32_t inX, int32_t inY, fheroes2::Image & out, int32_t outX, int32_t outY, int32_t width, int32_t height,
                           const uint8_t * palette )
     {
@@ -403,38 +476,13 @@ namespace
         const int32_t widthIn = in.width();
         const int32_t widthOut = out.width();
 
-        const uint8_t * imageInY = in.image() + static_cast<ptrdiff_t>( inY ) * widthIn + inX;
-        uint8_t * imageOutY = out.image() + static_cast<ptrdiff_t>( outY ) * widthOut + outX;
-        const uint8_t * imageInYEnd = imageInY + static_cast<ptrdiff_t>( height ) * widthIn;
+        const ptrdiff_t offsetIn = static_cast<ptrdiff_t>( inY ) * widthIn + inX;
 
-        if ( in.singleLayer() ) {
-            // All pixels in a single-layer image do not have any transform values so there is no need to check for them.
-            for ( ; imageInY != imageInYEnd; imageInY += widthIn, imageOutY += widthOut ) {
-                const uint8_t * imageInX = imageInY;
-                uint8_t * imageOutX = imageOutY;
-                const uint8_t * imageInXEnd = imageInX + width;
-
-                for ( ; imageInX != imageInXEnd; ++imageInX, ++imageOutX ) {
-                    *imageOutX = palette[*imageInX];
-                }
-            }
-        }
-        else {
-            const uint8_t * transformInY = in.transform() + static_cast<ptrdiff_t>( inY ) * widthIn + inX;
-
-            for ( ; imageInY != imageInYEnd; imageInY += widthIn, transformInY += widthIn, imageOutY += widthOut ) {
-                const uint8_t * imageInX = imageInY;
-                const uint8_t * transformInX = transformInY;
-                uint8_t * imageOutX = imageOutY;
-                const uint8_t * imageInXEnd = imageInX + width;
+        // All pixels in a single-layer image do not have any transform values so there is no need to check for them.
+        const uint8_t * transformIn = in.singleLayer() ? nullptr : in.transform() + offsetIn;
 
-                for ( ; imageInX != imageInXEnd; ++imageInX, ++imageOutX, ++transformInX ) {
-                    if ( *transformInX == 0 ) { // only modify pixels with data
-                        *imageOutX = palette[*imageInX];
-                    }
-                }
-            }
-        }
+        fheroes2::applyPalette8Bit( in.image() + offsetIn, transformIn, widthIn, out.image() + static_cast<ptrdiff_t>( outY ) * widthOut + outX, widthOut, width,
+                                    height, palette );
     }
 }
 
@@ -918,10 +966,19 @@ namespace fheroes2
         const int32_t widthIn = in.width();
         const int32_t widthOut = out.width();
 
-        const uint8_t behindValue = 255 - alphaValue;
-
         const uint8_t * gamePalette = getGamePalette();
 
+        const std::shared_ptr<const std::vector<uint8_t>> blendTable = alphaBlendTableCache.get( alphaValue, static_cast<int64_t>( width ) * height );
+        const uint8_t * blendTableData = blendTable ? blendTable->data() : nullptr;
+
+        const auto blend = [gamePalette, blendTableData, alphaValue]( const uint8_t inValue, const uint8_t outValue ) {
+            if ( blendTableData != nullptr ) {
+                return blendTableData[inValue * 256 + outValue];
+            }
+
+            return blendColors( gamePalette, inValue, outValue, alphaValue );
+        };
+
         if ( flip ) {
             const int32_t offsetInY = inY * widthIn + widthIn - 1 - inX;
             const uint8_t * imageInY = in.image() + offsetInY;
@@ -937,13 +994,7 @@ namespace fheroes2
                     const uint8_t * imageOutXEnd = imageOutX + width;
 
                     for ( ; imageOutX != imageOutXEnd; --imageInX, ++imageOutX ) {
-                        const uint8_t * inPAL = gamePalette + static_cast<ptrdiff_t>( *imageInX ) * 3;
-                        const uint8_t * outPAL = gamePalette + static_cast<ptrdiff_t>( *imageOutX ) * 3;
-
-                        const uint32_t red = static_cast<uint32_t>( *inPAL ) * alphaValue + static_cast<uint32_t>( *outPAL ) * behindValue;
-                        const uint32_t green = static_cast<uint32_t>( *( inPAL + 1 ) ) * alphaValue + static_cast<uint32_t>( *( outPAL + 1 ) ) * behindValue;
-                        const uint32_t blue = static_cast<uint32_t>( *( inPAL + 2 ) ) * alphaValue + static_cast<uint32_t>( *( outPAL + 2 ) ) * behindValue;
-                        *imageOutX = GetPALColorId( static_cast<uint8_t>( red / 255 ), static_cast<uint8_t>( green / 255 ), static_cast<uint8_t>( blue / 255 ) );
+                        *imageOutX = blend( *imageInX, *imageOutX );
                     }
                 }
             }
@@ -966,13 +1017,7 @@ namespace fheroes2
                             inValue = *( transformTable + static_cast<ptrdiff_t>( *transformInX ) * 256 + *imageOutX );
                         }
 
-                        const uint8_t * inPAL = gamePalette + static_cast<ptrdiff_t>( inValue ) * 3;
-                        const uint8_t * outPAL = gamePalette + static_cast<ptrdiff_t>( *imageOutX ) * 3;
-
-                        const uint32_t red = static_cast<uint32_t>( *inPAL ) * alphaValue + static_cast<uint32_t>( *outPAL ) * behindValue;
-                        const uint32_t green = static_cast<uint32_t>( *( inPAL + 1 ) ) * alphaValue + static_cast<uint32_t>( *( outPAL + 1 ) ) * behindValue;
-                        const uint32_t blue = static_cast<uint32_t>( *( inPAL + 2 ) ) * alphaValue + static_cast<uint32_t>( *( outPAL + 2 ) ) * behindValue;
-                        *imageOutX = GetPALColorId( static_cast<uint8_t>( red / 255 ), static_cast<uint8_t>( green / 255 ), static_cast<uint8_t>( blue / 255 ) );
+                        *imageOutX = blend( inValue, *imageOutX );
                     }
                 }
             }
@@ -991,13 +1036,7 @@ namespace fheroes2
                     const uint8_t * imageInXEnd = imageInX + width;
 
                     for ( ; imageInX != imageInXEnd; ++imageInX, ++imageOutX ) {
-                        const uint8_t * inPAL = gamePalette + static_cast<ptrdiff_t>( *imageInX ) * 3;
-                        const uint8_t * outPAL = gamePalette + static_cast<ptrdiff_t>( *imageOutX ) * 3;
-
-                        const uint32_t red = static_cast<uint32_t>( *inPAL ) * alphaValue + static_cast<uint32_t>( *outPAL ) * behindValue;
-                        const uint32_t green = static_cast<uint32_t>( *( inPAL + 1 ) ) * alphaValue + static_cast<uint32_t>( *( outPAL + 1 ) ) * behindValue;
-                        const uint32_t blue = static_cast<uint32_t>( *( inPAL + 2 ) ) * alphaValue + static_cast<uint32_t>( *( outPAL + 2 ) ) * behindValue;
-                        *imageOutX = GetPALColorId( static_cast<uint8_t>( red / 255 ), static_cast<uint8_t>( green / 255 ), static_cast<uint8_t>( blue / 255 ) );
+                        *imageOutX = blend( *imageInX, *imageOutX );
                     }
                 }
             }
@@ -1020,13 +1059,7 @@ namespace fheroes2
                             inValue = *( transformTable + static_cast<ptrdiff_t>( *transformInX ) * 256 + *imageOutX );
                         }
 
-                        const uint8_t * inPAL = gamePalette + static_cast<ptrdiff_t>( inValue ) * 3;
-                        const uint8_t * outPAL = gamePalette + static_cast<ptrdiff_t>( *imageOutX ) * 3;
-
-                        const uint32_t red = static_cast<uint32_t>( *inPAL ) * alphaValue + static_cast<uint32_t>( *outPAL ) * behindValue;
-                        const uint32_t green = static_cast<uint32_t>( *( inPAL + 1 ) ) * alphaValue + static_cast<uint32_t>( *( outPAL + 1 ) ) * behindValue;
-                        const uint32_t blue = static_cast<uint32_t>( *( inPAL + 2 ) ) * alphaValue + static_cast<uint32_t>( *( outPAL + 2 ) ) * behindValue;
-                        *imageOutX = GetPALColorId( static_cast<uint8_t>( red / 255 ), static_cast<uint8_t>( green / 255 ), static_cast<uint8_t>( blue / 255 ) );
+                        *imageOutX = blend( inValue, *imageOutX );
                     }
                 }
             }
@@ -1106,35 +1139,13 @@ namespace fheroes2
         }
 
         const int32_t imageWidth = image.width();
+        const ptrdiff_t offset = static_cast<ptrdiff_t>( y ) * imageWidth + x;
 
-        uint8_t * imageY = image.image() + y * imageWidth + x;
-        const uint8_t * imageYEnd = imageY + height * imageWidth;
+        // A transform table is applied the same way as a palette.
+        const uint8_t * transform = image.singleLayer() ? nullptr : image.transform() + offset;
+        uint8_t * imageIn = image.image() + offset;
 
-        if ( image.singleLayer() ) {
-            for ( ; imageY != imageYEnd; imageY += imageWidth ) {
-                uint8_t * imageX = imageY;
-                const uint8_t * imageXEnd = imageX + width;
-
-                for ( ; imageX != imageXEnd; ++imageX ) {
-                    *imageX = *( transformTable + transformId * 256 + *imageX );
-                }
-            }
-        }
-        else {
-            const uint8_t * transformY = image.transform() + y * imageWidth + x;
-
-            for ( ; imageY != imageYEnd; imageY += imageWidth, transformY += imageWidth ) {
-                uint8_t * imageX = imageY;
-                const uint8_t * transformX = transformY;
-                const uint8_t * imageXEnd = imageX + width;
-
-                for ( ; imageX != imageXEnd; ++imageX, ++transformX ) {
-                    if ( *transformX == 0 ) {
-                        *imageX = *( transformTable + transformId * 256 + *imageX );
-                    }
-                }
-            }
-        }
+        applyPalette8Bit( imageIn, transform, imageWidth, imageIn, imageWidth, width, height, transformTable + transformId * 256 );
     }
 
     void Blit( const Image & in, Image & out, const bool flip /* = false */ )
@@ -1227,59 +1238,18 @@ namespace fheroes2
             }
         }
         else {
-            const int32_t offsetInY = inY * widthIn + inX;
-            const uint8_t * imageInY = in.image() + offsetInY;
-            const uint8_t * transformInY = in.transform() + offsetInY;
-
-            const int32_t offsetOutY = outY * widthOut + outX;
-            uint8_t * imageOutY = out.image() + offsetOutY;
-            const uint8_t * imageInYEnd = imageInY + height * widthIn;
+            const int32_t offsetIn = inY * widthIn + inX;
+            const int32_t offsetOut = outY * widthOut + outX;
 
+            uint8_t * transformOut = nullptr;
             if ( out.singleLayer() ) {
                 assert( !in.singleLayer() );
-                for ( ; imageInY != imageInYEnd; imageInY += widthIn, transformInY += widthIn, imageOutY += widthOut ) {
-                    const uint8_t * imageInX = imageInY;
-                    const uint8_t * transformInX = transformInY;
-                    uint8_t * imageOutX = imageOutY;
-                    const uint8_t * imageInXEnd = imageInX + width;
-
-                    for ( ; imageInX != imageInXEnd; ++imageInX, ++transformInX, ++imageOutX ) {
-                        if ( *transformInX > 0 ) { // apply a transformation
-                            if ( *transformInX != 1 ) { // skip pixel
-                                *imageOutX = *( transformTable + ( *transformInX ) * 256 + *imageOutX );
-                            }
-                        }
-                        else { // copy a pixel
-                            *imageOutX = *imageInX;
-                        }
-                    }
-                }
             }
             else {
-                uint8_t * transformOutY = out.transform() + offsetOutY;
-
-                for ( ; imageInY != imageInYEnd; imageInY += widthIn, transformInY += widthIn, imageOutY += widthOut, transformOutY += widthOut ) {
-                    const uint8_t * imageInX = imageInY;
-                    const uint8_t * transformInX = transformInY;
-                    uint8_t * imageOutX = imageOutY;
-                    uint8_t * transformOutX = transformOutY;
-                    const uint8_t * imageInXEnd = imageInX + width;
-
-                    for ( ; imageInX != imageInXEnd; ++imageInX, ++transformInX, ++imageOutX, ++transformOutX ) {
-                        if ( *transformInX == 1 ) { // skip pixel
-                            continue;
-                        }
-
-                        if ( *transformInX > 0 && *transformOutX == 0 ) { // apply a transformation
-                            *imageOutX = *( transformTable + ( *transformInX ) * 256 + *imageOutX );
-                        }
-                        else { // copy a pixel
-                            *transformOutX = *transformInX;
-                            *imageOutX = *imageInX;
-                        }
-                    }
-                }
+                transformOut = out.transform() + offsetOut;
             }
+
+            blitMasked8Bit( in.image() + offsetIn, in.transform() + offsetIn, widthIn, out.image() + offsetOut, transformOut, widthOut, width, height, transformTable );
         }
     }
 
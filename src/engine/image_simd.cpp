@@ -0,0 +1,697 @@
+/***************************************************************************
+ *   fheroes2: https://github.com/ihhub/fheroes2                           *
+ *   Copyright (C) 2025                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "image_simd.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+
+#if defined( __x86_64__ ) || defined( __i386__ ) || defined( _M_X64 ) || defined( _M_IX86 )
+#define FHEROES2_SIMD_X86
+#include <immintrin.h>
+#if defined( _MSC_VER )
+#include <intrin.h>
+#endif
+#elif defined( __aarch64__ ) || defined( _M_ARM64 )
+#define FHEROES2_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+// GCC and Clang allow to use intrinsics of instruction sets which are not enabled for the whole project only within functions marked
+// by the corresponding target attribute. MSVC does not have such a restriction.
+#if defined( FHEROES2_SIMD_X86 ) && !defined( _MSC_VER )
+#define FHEROES2_TARGET_SSE2 __attribute__( ( target( "sse2" ) ) )
+#define FHEROES2_TARGET_AVX2 __attribute__( ( target( "avx2" ) ) )
+#else
+#define FHEROES2_TARGET_SSE2
+#define FHEROES2_TARGET_AVX2
+#endif
+
+namespace
+{
+    void convert8BitTo32BitScalar( const uint8_t * in, const int32_t inWidth, uint32_t * out, const int32_t outWidth, const int32_t width, const int32_t height,
+                                   const uint32_t * palette )
+    {
+        for ( int32_t y = 0; y < height; ++y, in += inWidth, out += outWidth ) {
+            uint32_t * outX = out;
+            const uint32_t * outXEnd = outX + width;
+            const uint8_t * inX = in;
+
+            for ( ; outX != outXEnd; ++outX, ++inX ) {
+                *outX = *( palette + *inX );
+            }
+        }
+    }
+
+    // Processes a single row following the rules of fheroes2::Blit().
+    void blitMaskedRowScalar( const uint8_t * imageIn, const uint8_t * transformIn, uint8_t * imageOut, uint8_t * transformOut, const int32_t width,
+                              const uint8_t * transformTable )
+    {
+        const uint8_t * imageInEnd = imageIn + width;
+
+        if ( transformOut == nullptr ) {
+            for ( ; imageIn != imageInEnd; ++imageIn, ++transformIn, ++imageOut ) {
+                if ( *transformIn == 0 ) {
+                    *imageOut = *imageIn;
+                }
+                else if ( *transformIn > 1 ) {
+                    *imageOut = *( transformTable + static_cast<ptrdiff_t>( *transformIn ) * 256 + *imageOut );
+                }
+            }
+
+            return;
+        }
+
+        for ( ; imageIn != imageInEnd; ++imageIn, ++transformIn, ++imageOut, ++transformOut ) {
+            if ( *transformIn == 1 ) {
+                continue;
+            }
+
+            if ( *transformIn > 0 && *transformOut == 0 ) {
+                *imageOut = *( transformTable + static_cast<ptrdiff_t>( *transformIn ) * 256 + *imageOut );
+            }
+            else {
+                *transformOut = *transformIn;
+                *imageOut = *imageIn;
+            }
+        }
+    }
+
+    void blitMaskedScalar( const uint8_t * imageIn, const uint8_t * transformIn, const int32_t inWidth, uint8_t * imageOut, uint8_t * transformOut,
+                           const int32_t outWidth, const int32_t width, const int32_t height, const uint8_t * transformTable )
+    {
+        for ( int32_t y = 0; y < height; ++y, imageIn += inWidth, transformIn += inWidth, imageOut += outWidth ) {
+            blitMaskedRowScalar( imageIn, transformIn, imageOut, transformOut, width, transformTable );
+
+            if ( transformOut != nullptr ) {
+                transformOut += outWidth;
+            }
+        }
+    }
+
+    void applyPaletteScalar( const uint8_t * imageIn, const uint8_t * transformIn, const int32_t inWidth, uint8_t * imageOut, const int32_t outWidth,
+                             const int32_t width, const int32_t height, const uint8_t * palette )
+    {
+        for ( int32_t y = 0; y < height; ++y, imageIn += inWidth, imageOut += outWidth ) {
+            if ( transformIn == nullptr ) {
+                for ( int32_t x = 0; x < width; ++x ) {
+                    imageOut[x] = palette[imageIn[x]];
+                }
+
+                continue;
+            }
+
+            for ( int32_t x = 0; x < width; ++x ) {
+                // Only pixels with data are modified.
+                if ( transformIn[x] == 0 ) {
+                    imageOut[x] = palette[imageIn[x]];
+                }
+            }
+
+            transformIn += inWidth;
+        }
+    }
+
+#if defined( FHEROES2_SIMD_X86 )
+    // Non-temporal stores bypass the cache. This is faster for big images since their content would be evicted from the cache anyway.
+    constexpr int64_t streamingStoreThreshold = 1024 * 1024;
+
+    bool isSse2Supported()
+    {
+#if defined( __x86_64__ ) || defined( _M_X64 )
+        // SSE2 is a mandatory part of x86-64.
+        return true;
+#elif defined( _MSC_VER )
+        int info[4];
+        __cpuid( info, 1 );
+
+        return ( info[3] & ( 1 << 26 ) ) != 0;
+#else
+        return __builtin_cpu_supports( "sse2" );
+#endif
+    }
+
+    bool isAvx2Supported()
+    {
+#if defined( _MSC_VER )
+        int info[4];
+        __cpuid( info, 0 );
+        if ( info[0] < 7 ) {
+            return false;
+        }
+
+        // The processor must support AVX and the operating system must save the state of YMM registers.
+        __cpuid( info, 1 );
+        if ( ( info[2] & ( 1 << 27 ) ) == 0 || ( info[2] & ( 1 << 28 ) ) == 0 || ( _xgetbv( 0 ) & 0x6 ) != 0x6 ) {
+            return false;
+        }
+
+        __cpuidex( info, 7, 0 );
+
+        return ( info[1] & ( 1 << 5 ) ) != 0;
+#else
+        return __builtin_cpu_supports( "avx2" );
+#endif
+    }
+
+    FHEROES2_TARGET_SSE2 __m128i lookUp4PixelsSse2( const uint8_t * in, const uint32_t * palette )
+    {
+        return _mm_setr_epi32( static_cast<int>( palette[in[0]] ), static_cast<int>( palette[in[1]] ), static_cast<int>( palette[in[2]] ),
+                               static_cast<int>( palette[in[3]] ) );
+    }
+
+    // SSE2 has no gather instructions so the palette lookup itself remains scalar. The gain comes from wider and non-temporal stores.
+    FHEROES2_TARGET_SSE2 void convert8BitTo32BitSse2( const uint8_t * in, const int32_t inWidth, uint32_t * out, const int32_t outWidth, const int32_t width,
+                                                      const int32_t height, const uint32_t * palette )
+    {
+        const bool useStreamingStores = static_cast<int64_t>( width ) * height >= streamingStoreThreshold;
+
+        for ( int32_t y = 0; y < height; ++y, in += inWidth, out += outWidth ) {
+            int32_t x = 0;
+
+            if ( useStreamingStores ) {
+                // Non-temporal stores require 16-byte aligned addresses.
+                for ( ; x < width && ( reinterpret_cast<uintptr_t>( out + x ) & 15 ) != 0; ++x ) {
+                    out[x] = palette[in[x]];
+                }
+
+                for ( ; x + 4 <= width; x += 4 ) {
+                    _mm_stream_si128( reinterpret_cast<__m128i *>( out + x ), lookUp4PixelsSse2( in + x, palette ) );
+                }
+            }
+            else {
+                for ( ; x + 4 <= width; x += 4 ) {
+                    _mm_storeu_si128( reinterpret_cast<__m128i *>( out + x ), lookUp4PixelsSse2( in + x, palette ) );
+                }
+            }
+
+            for ( ; x < width; ++x ) {
+                out[x] = palette[in[x]];
+            }
+        }
+
+        if ( useStreamingStores ) {
+            _mm_sfence();
+        }
+    }
+
+    FHEROES2_TARGET_AVX2 void convert8BitTo32BitAvx2( const uint8_t * in, const int32_t inWidth, uint32_t * out, const int32_t outWidth, const int32_t width,
+                                                      const int32_t height, const uint32_t * palette )
+    {
+        const int * table = reinterpret_cast<const int *>( palette );
+
+        for ( int32_t y = 0; y < height; ++y, in += inWidth, out += outWidth ) {
+            int32_t x = 0;
+
+            for ( ; x + 16 <= width; x += 16 ) {
+                const __m128i indices = _mm_loadu_si128( reinterpret_cast<const __m128i *>( in + x ) );
+
+                const __m256i first = _mm256_i32gather_epi32( table, _mm256_cvtepu8_epi32( indices ), 4 );
+                const __m256i second = _mm256_i32gather_epi32( table, _mm256_cvtepu8_epi32( _mm_srli_si128( indices, 8 ) ), 4 );
+
+                _mm256_storeu_si256( reinterpret_cast<__m256i *>( out + x ), first );
+                _mm256_storeu_si256( reinterpret_cast<__m256i *>( out + x + 8 ), second );
+            }
+
+            for ( ; x < width; ++x ) {
+                out[x] = palette[in[x]];
+            }
+        }
+    }
+
+    // Masked blits check the transform layer of 16 or 32 pixels at once. Blocks containing only copied and skipped pixels (which is the most common case
+    // for sprites) are written by a single blend operation, blocks with transformed pixels are processed one by one.
+    FHEROES2_TARGET_SSE2 void blitMaskedSse2( const uint8_t * imageIn, const uint8_t * transformIn, const int32_t inWidth, uint8_t * imageOut, uint8_t * transformOut,
+                                              const int32_t outWidth, const int32_t width, const int32_t height, const uint8_t * transformTable )
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i one = _mm_set1_epi8( 1 );
+        const __m128i allSet = _mm_cmpeq_epi8( zero, zero );
+
+        for ( int32_t y = 0; y < height; ++y, imageIn += inWidth, transformIn += inWidth, imageOut += outWidth ) {
+            int32_t x = 0;
+
+            for ( ; x + 16 <= width; x += 16 ) {
+                const __m128i transformInValue = _mm_loadu_si128( reinterpret_cast<const __m128i *>( transformIn + x ) );
+                __m128i copyMask = _mm_cmpeq_epi8( transformInValue, zero );
+                __m128i transformMask = _mm_andnot_si128( _mm_or_si128( copyMask, _mm_cmpeq_epi8( transformInValue, one ) ), allSet );
+
+                __m128i transformOutValue = zero;
+                if ( transformOut != nullptr ) {
+                    // Transformations are applied only to pixels with data. Other pixels take both layers from the input image.
+                    transformOutValue = _mm_loadu_si128( reinterpret_cast<const __m128i *>( transformOut + x ) );
+                    const __m128i hasData = _mm_cmpeq_epi8( transformOutValue, zero );
+
+                    copyMask = _mm_or_si128( copyMask, _mm_andnot_si128( hasData, transformMask ) );
+                    transformMask = _mm_and_si128( transformMask, hasData );
+                }
+
+                if ( _mm_movemask_epi8( transformMask ) != 0 ) {
+                    blitMaskedRowScalar( imageIn + x, transformIn + x, imageOut + x, ( transformOut != nullptr ) ? transformOut + x : nullptr, 16, transformTable );
+                    continue;
+                }
+
+                const int copyBits = _mm_movemask_epi8( copyMask );
+                if ( copyBits == 0 ) {
+                    continue;
+                }
+
+                __m128i imageValue = _mm_loadu_si128( reinterpret_cast<const __m128i *>( imageIn + x ) );
+
+                if ( copyBits != 0xFFFF ) {
+                    const __m128i imageOutValue = _mm_loadu_si128( reinterpret_cast<const __m128i *>( imageOut + x ) );
+                    imageValue = _mm_or_si128( _mm_and_si128( copyMask, imageValue ), _mm_andnot_si128( copyMask, imageOutValue ) );
+                }
+
+                _mm_storeu_si128( reinterpret_cast<__m128i *>( imageOut + x ), imageValue );
+
+                if ( transformOut != nullptr ) {
+                    const __m128i transformValue = _mm_or_si128( _mm_and_si128( copyMask, transformInValue ), _mm_andnot_si128( copyMask, transformOutValue ) );
+                    _mm_storeu_si128( reinterpret_cast<__m128i *>( transformOut + x ), transformValue );
+                }
+            }
+
+            blitMaskedRowScalar( imageIn + x, transformIn + x, imageOut + x, ( transformOut != nullptr ) ? transformOut + x : nullptr, width - x, transformTable );
+
+            if ( transformOut != nullptr ) {
+                transformOut += outWidth;
+            }
+        }
+    }
+
+    FHEROES2_TARGET_AVX2 void blitMaskedAvx2( const uint8_t * imageIn, const uint8_t * transformIn, const int32_t inWidth, uint8_t * imageOut, uint8_t * transformOut,
+                                              const int32_t outWidth, const int32_t width, const int32_t height, const uint8_t * transformTable )
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i one = _mm256_set1_epi8( 1 );
+        const __m256i allSet = _mm256_cmpeq_epi8( zero, zero );
+
+        for ( int32_t y = 0; y < height; ++y, imageIn += inWidth, transformIn += inWidth, imageOut += outWidth ) {
+            int32_t x = 0;
+
+            for ( ; x + 32 <= width; x += 32 ) {
+                const __m256i transformInValue = _mm256_loadu_si256( reinterpret_cast<const __m256i *>( transformIn + x ) );
+                __m256i copyMask = _mm256_cmpeq_epi8( transformInValue, zero );
+                __m256i transformMask = _mm256_andnot_si256( _mm256_or_si256( copyMask, _mm256_cmpeq_epi8( transformInValue, one ) ), allSet );
+
+                __m256i transformOutValue = zero;
+                if ( transformOut != nullptr ) {
+                    transformOutValue = _mm256_loadu_si256( reinterpret_cast<const __m256i *>( transformOut + x ) );
+                    const __m256i hasData = _mm256_cmpeq_epi8( transformOutValue, zero );
+
+                    copyMask = _mm256_or_si256( copyMask, _mm256_andnot_si256( hasData, transformMask ) );
+                    transformMask = _mm256_and_si256( transformMask, hasData );
+                }
+
+                if ( _mm256_movemask_epi8( transformMask ) != 0 ) {
+                    blitMaskedRowScalar( imageIn + x, transformIn + x, imageOut + x, ( transformOut != nullptr ) ? transformOut + x : nullptr, 32, transformTable );
+                    continue;
+                }
+
+                const int copyBits = _mm256_movemask_epi8( copyMask );
+                if ( copyBits == 0 ) {
+                    continue;
+                }
+
+                __m256i imageValue = _mm256_loadu_si256( reinterpret_cast<const __m256i *>( imageIn + x ) );
+
+                if ( copyBits != -1 ) {
+                    const __m256i imageOutValue = _mm256_loadu_si256( reinterpret_cast<const __m256i *>( imageOut + x ) );
+                    imageValue = _mm256_blendv_epi8( imageOutValue, imageValue, copyMask );
+                }
+
+                _mm256_storeu_si256( reinterpret_cast<__m256i *>( imageOut + x ), imageValue );
+
+                if ( transformOut != nullptr ) {
+                    _mm256_storeu_si256( reinterpret_cast<__m256i *>( transformOut + x ), _mm256_blendv_epi8( transformOutValue, transformInValue, copyMask ) );
+                }
+            }
+
+            blitMaskedRowScalar( imageIn + x, transformIn + x, imageOut + x, ( transformOut != nullptr ) ? transformOut + x : nullptr, width - x, transformTable );
+
+            if ( transformOut != nullptr ) {
+                transformOut += outWidth;
+            }
+        }
+    }
+
+    // The palette is expanded to 32-bit values to be used by gather instructions. Then the lowest byte of every gathered value is packed back.
+    FHEROES2_TARGET_AVX2 void applyPaletteAvx2( const uint8_t * imageIn, const uint8_t * transformIn, const int32_t inWidth, uint8_t * imageOut,
+                                                const int32_t outWidth, const int32_t width, const int32_t height, const uint8_t * palette )
+    {
+        std::array<int, 256> table;
+        for ( size_t i = 0; i < table.size(); ++i ) {
+            table[i] = palette[i];
+        }
+
+        // Moves the lowest bytes of all 32-bit values of every 128-bit lane into the first 4 bytes of the lane.
+        const __m256i packBytes = _mm256_setr_epi8( 0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                                    -1 );
+        // Moves the first 4 bytes of both lanes into the first 8 bytes of the register.
+        const __m256i packLanes = _mm256_setr_epi32( 0, 4, 0, 0, 0, 0, 0, 0 );
+        const __m128i zero = _mm_setzero_si128();
+
+        for ( int32_t y = 0; y < height; ++y, imageIn += inWidth, imageOut += outWidth ) {
+            int32_t x = 0;
+
+            for ( ; x + 8 <= width; x += 8 ) {
+                const __m256i indices = _mm256_cvtepu8_epi32( _mm_loadl_epi64( reinterpret_cast<const __m128i *>( imageIn + x ) ) );
+                const __m256i values = _mm256_i32gather_epi32( table.data(), indices, 4 );
+                __m128i result = _mm256_castsi256_si128( _mm256_permutevar8x32_epi32( _mm256_shuffle_epi8( values, packBytes ), packLanes ) );
+
+                if ( transformIn != nullptr ) {
+                    const __m128i hasData = _mm_cmpeq_epi8( _mm_loadl_epi64( reinterpret_cast<const __m128i *>( transformIn + x ) ), zero );
+                    result = _mm_blendv_epi8( _mm_loadl_epi64( reinterpret_cast<const __m128i *>( imageOut + x ) ), result, hasData );
+                }
+
+                _mm_storel_epi64( reinterpret_cast<__m128i *>( imageOut + x ), result );
+            }
+
+            applyPaletteScalar( imageIn + x, ( transformIn != nullptr ) ? transformIn + x : nullptr, inWidth, imageOut + x, outWidth, width - x, 1, palette );
+
+            if ( transformIn != nullptr ) {
+                transformIn += inWidth;
+            }
+        }
+    }
+#endif
+
+#if defined( FHEROES2_SIMD_NEON )
+    // NEON has no gather instructions but it can look up 16 bytes at once in a table of up to 64 bytes. The palette is split into 4 byte planes
+    // (one per channel) of 256 elements, each of them is looked up as 4 tables of 64 elements. The resulting planes are interleaved back by the store.
+    void convert8BitTo32BitNeon( const uint8_t * in, const int32_t inWidth, uint32_t * out, const int32_t outWidth, const int32_t width, const int32_t height,
+                                 const uint32_t * palette )
+    {
+        const uint8_t * paletteBytes = reinterpret_cast<const uint8_t *>( palette );
+
+        std::array<uint8_t, 256 * 4> planes;
+        for ( size_t i = 0; i < 256; ++i ) {
+            for ( size_t channel = 0; channel < 4; ++channel ) {
+                planes[channel * 256 + i] = paletteBytes[i * 4 + channel];
+            }
+        }
+
+        std::array<std::array<uint8x16x4_t, 4>, 4> tables;
+        for ( size_t channel = 0; channel < 4; ++channel ) {
+            for ( size_t tableId = 0; tableId < 4; ++tableId ) {
+                for ( size_t i = 0; i < 4; ++i ) {
+                    tables[channel][tableId].val[i] = vld1q_u8( planes.data() + channel * 256 + tableId * 64 + i * 16 );
+                }
+            }
+        }
+
+        const uint8x16_t tableSize = vdupq_n_u8( 64 );
+
+        for ( int32_t y = 0; y < height; ++y, in += inWidth, out += outWidth ) {
+            int32_t x = 0;
+
+            for ( ; x + 16 <= width; x += 16 ) {
+                // Indices which are out of a table range wrap around to big values and are ignored by the lookup.
+                const uint8x16_t index0 = vld1q_u8( in + x );
+                const uint8x16_t index1 = vsubq_u8( index0, tableSize );
+                const uint8x16_t index2 = vsubq_u8( index1, tableSize );
+                const uint8x16_t index3 = vsubq_u8( index2, tableSize );
+
+                uint8x16x4_t pixels;
+                for ( size_t channel = 0; channel < 4; ++channel ) {
+                    uint8x16_t value = vqtbl4q_u8( tables[channel][0], index0 );
+                    value = vqtbx4q_u8( value, tables[channel][1], index1 );
+                    value = vqtbx4q_u8( value, tables[channel][2], index2 );
+                    pixels.val[channel] = vqtbx4q_u8( value, tables[channel][3], index3 );
+                }
+
+                vst4q_u8( reinterpret_cast<uint8_t *>( out + x ), pixels );
+            }
+
+            for ( ; x < width; ++x ) {
+                out[x] = palette[in[x]];
+            }
+        }
+    }
+
+    void blitMaskedNeon( const uint8_t * imageIn, const uint8_t * transformIn, const int32_t inWidth, uint8_t * imageOut, uint8_t * transformOut,
+                         const int32_t outWidth, const int32_t width, const int32_t height, const uint8_t * transformTable )
+    {
+        const uint8x16_t zero = vdupq_n_u8( 0 );
+        const uint8x16_t one = vdupq_n_u8( 1 );
+
+        for ( int32_t y = 0; y < height; ++y, imageIn += inWidth, transformIn += inWidth, imageOut += outWidth ) {
+            int32_t x = 0;
+
+            for ( ; x + 16 <= width; x += 16 ) {
+                const uint8x16_t transformInValue = vld1q_u8( transformIn + x );
+                uint8x16_t copyMask = vceqq_u8( transformInValue, zero );
+                uint8x16_t transformMask = vmvnq_u8( vorrq_u8( copyMask, vceqq_u8( transformInValue, one ) ) );
+
+                uint8x16_t transformOutValue = zero;
+                if ( transformOut != nullptr ) {
+                    transformOutValue = vld1q_u8( transformOut + x );
+                    const uint8x16_t hasData = vceqq_u8( transformOutValue, zero );
+
+                    copyMask = vorrq_u8( copyMask, vbicq_u8( transformMask, hasData ) );
+                    transformMask = vandq_u8( transformMask, hasData );
+                }
+
+                if ( vmaxvq_u8( transformMask ) != 0 ) {
+                    blitMaskedRowScalar( imageIn + x, transformIn + x, imageOut + x, ( transformOut != nullptr ) ? transformOut + x : nullptr, 16, transformTable );
+                    continue;
+                }
+
+                if ( vmaxvq_u8( copyMask ) == 0 ) {
+                    continue;
+                }
+
+                vst1q_u8( imageOut + x, vbslq_u8( copyMask, vld1q_u8( imageIn + x ), vld1q_u8( imageOut + x ) ) );
+
+                if ( transformOut != nullptr ) {
+                    vst1q_u8( transformOut + x, vbslq_u8( copyMask, transformInValue, transformOutValue ) );
+                }
+            }
+
+            blitMaskedRowScalar( imageIn + x, transformIn + x, imageOut + x, ( transformOut != nullptr ) ? transformOut + x : nullptr, width - x, transformTable );
+
+            if ( transformOut != nullptr ) {
+                transformOut += outWidth;
+            }
+        }
+    }
+
+    // The palette of 256 elements is looked up as 4 tables of 64 elements, the same way as in convert8BitTo32BitNeon().
+    void applyPaletteNeon( const uint8_t * imageIn, const uint8_t * transformIn, const int32_t inWidth, uint8_t * imageOut, const int32_t outWidth,
+                           const int32_t width, const int32_t height, const uint8_t * palette )
+    {
+        std::array<uint8x16x4_t, 4> tables;
+        for ( size_t tableId = 0; tableId < 4; ++tableId ) {
+            for ( size_t i = 0; i < 4; ++i ) {
+                tables[tableId].val[i] = vld1q_u8( palette + tableId * 64 + i * 16 );
+            }
+        }
+
+        const uint8x16_t tableSize = vdupq_n_u8( 64 );
+        const uint8x16_t zero = vdupq_n_u8( 0 );
+
+        for ( int32_t y = 0; y < height; ++y, imageIn += inWidth, imageOut += outWidth ) {
+            int32_t x = 0;
+
+            for ( ; x + 16 <= width; x += 16 ) {
+                const uint8x16_t index0 = vld1q_u8( imageIn + x );
+                const uint8x16_t index1 = vsubq_u8( index0, tableSize );
+                const uint8x16_t index2 = vsubq_u8( index1, tableSize );
+                const uint8x16_t index3 = vsubq_u8( index2, tableSize );
+
+                uint8x16_t result = vqtbl4q_u8( tables[0], index0 );
+                result = vqtbx4q_u8( result, tables[1], index1 );
+                result = vqtbx4q_u8( result, tables[2], index2 );
+                result = vqtbx4q_u8( result, tables[3], index3 );
+
+                if ( transformIn != nullptr ) {
+                    result = vbslq_u8( vceqq_u8( vld1q_u8( transformIn + x ), zero ), result, vld1q_u8( imageOut + x ) );
+                }
+
+                vst1q_u8( imageOut + x, result );
+            }
+
+            applyPaletteScalar( imageIn + x, ( transformIn != nullptr ) ? transformIn + x : nullptr, inWidth, imageOut + x, outWidth, width - x, 1, palette );
+
+            if ( transformIn != nullptr ) {
+                transformIn += inWidth;
+            }
+        }
+    }
+#endif
+
+    std::vector<fheroes2::SimdInstructionSet> detectSupportedInstructionSets()
+    {
+        std::vector<fheroes2::SimdInstructionSet> instructionSets{ fheroes2::SimdInstructionSet::NONE };
+
+#if defined( FHEROES2_SIMD_X86 )
+        if ( isSse2Supported() ) {
+            instructionSets.push_back( fheroes2::SimdInstructionSet::SSE2 );
+
+            if ( isAvx2Supported() ) {
+                instructionSets.push_back( fheroes2::SimdInstructionSet::AVX2 );
+            }
+        }
+#elif defined( FHEROES2_SIMD_NEON )
+        // NEON is a mandatory part of AArch64.
+        instructionSets.push_back( fheroes2::SimdInstructionSet::NEON );
+#endif
+
+        return instructionSets;
+    }
+
+    const std::vector<fheroes2::SimdInstructionSet> & supportedInstructionSets()
+    {
+        static const std::vector<fheroes2::SimdInstructionSet> instructionSets = detectSupportedInstructionSets();
+        return instructionSets;
+    }
+
+    fheroes2::SimdInstructionSet & currentInstructionSet()
+    {
+        // The best supported instruction set is the last one.
+        static fheroes2::SimdInstructionSet instructionSet = supportedInstructionSets().back();
+        return instructionSet;
+    }
+}
+
+namespace fheroes2
+{
+    std::vector<SimdInstructionSet> getSupportedSimdInstructionSets()
+    {
+        return supportedInstructionSets();
+    }
+
+    SimdInstructionSet getSimdInstructionSet()
+    {
+        return currentInstructionSet();
+    }
+
+    bool setSimdInstructionSet( const SimdInstructionSet instructionSet )
+    {
+        const std::vector<SimdInstructionSet> & instructionSets = supportedInstructionSets();
+        if ( std::find( instructionSets.begin(), instructionSets.end(), instructionSet ) == instructionSets.end() ) {
+            return false;
+        }
+
+        currentInstructionSet() = instructionSet;
+        return true;
+    }
+
+    const char * getSimdInstructionSetName( const SimdInstructionSet instructionSet )
+    {
+        switch ( instructionSet ) {
+        case SimdInstructionSet::NONE:
+            return "scalar";
+        case SimdInstructionSet::SSE2:
+            return "SSE2";
+        case SimdInstructionSet::AVX2:
+            return "AVX2";
+        case SimdInstructionSet::NEON:
+            return "NEON";
+        default:
+            // Did you add a new instruction set? Add the logic above!
+            assert( 0 );
+            break;
+        }
+
+        return "unknown";
+    }
+
+    void convert8BitTo32Bit( const uint8_t * in, const int32_t inWidth, uint32_t * out, const int32_t outWidth, const int32_t width, const int32_t height,
+                             const uint32_t * palette )
+    {
+        assert( in != nullptr && out != nullptr && palette != nullptr );
+        assert( width >= 0 && height >= 0 && inWidth >= width && outWidth >= width );
+
+        switch ( currentInstructionSet() ) {
+#if defined( FHEROES2_SIMD_X86 )
+        case SimdInstructionSet::SSE2:
+            convert8BitTo32BitSse2( in, inWidth, out, outWidth, width, height, palette );
+            return;
+        case SimdInstructionSet::AVX2:
+            convert8BitTo32BitAvx2( in, inWidth, out, outWidth, width, height, palette );
+            return;
+#endif
+#if defined( FHEROES2_SIMD_NEON )
+        case SimdInstructionSet::NEON:
+            convert8BitTo32BitNeon( in, inWidth, out, outWidth, width, height, palette );
+            return;
+#endif
+        default:
+            break;
+        }
+
+        convert8BitTo32BitScalar( in, inWidth, out, outWidth, width, height, palette );
+    }
+
+    void blitMasked8Bit( const uint8_t * imageIn, const uint8_t * transformIn, const int32_t inWidth, uint8_t * imageOut, uint8_t * transformOut,
+                         const int32_t outWidth, const int32_t width, const int32_t height, const uint8_t * transformTable )
+    {
+        assert( imageIn != nullptr && transformIn != nullptr && imageOut != nullptr && transformTable != nullptr );
+        assert( width >= 0 && height >= 0 && inWidth >= width && outWidth >= width );
+
+        switch ( currentInstructionSet() ) {
+#if defined( FHEROES2_SIMD_X86 )
+        case SimdInstructionSet::SSE2:
+            blitMaskedSse2( imageIn, transformIn, inWidth, imageOut, transformOut, outWidth, width, height, transformTable );
+            return;
+        case SimdInstructionSet::AVX2:
+            blitMaskedAvx2( imageIn, transformIn, inWidth, imageOut, transformOut, outWidth, width, height, transformTable );
+            return;
+#endif
+#if defined( FHEROES2_SIMD_NEON )
+        case SimdInstructionSet::NEON:
+            blitMaskedNeon( imageIn, transformIn, inWidth, imageOut, transformOut, outWidth, width, height, transformTable );
+            return;
+#endif
+        default:
+            break;
+        }
+
+        blitMaskedScalar( imageIn, transformIn, inWidth, imageOut, transformOut, outWidth, width, height, transformTable );
+    }
+
+    void applyPalette8Bit( const uint8_t * imageIn, const uint8_t * transformIn, const int32_t inWidth, uint8_t * imageOut, const int32_t outWidth,
+                           const int32_t width, const int32_t height, const uint8_t * palette )
+    {
+        assert( imageIn != nullptr && imageOut != nullptr && palette != nullptr );
+        assert( width >= 0 && height >= 0 && inWidth >= width && outWidth >= width );
+
+        switch ( currentInstructionSet() ) {
+#if defined( FHEROES2_SIMD_X86 )
+        case SimdInstructionSet::AVX2:
+            applyPaletteAvx2( imageIn, transformIn, inWidth, imageOut, outWidth, width, height, palette );
+            return;
+#endif
+#if defined( FHEROES2_SIMD_NEON )
+        case SimdInstructionSet::NEON:
+            applyPaletteNeon( imageIn, transformIn, inWidth, imageOut, outWidth, width, height, palette );
+            return;
+#endif
+        default:
+            // SSE2 has neither gather nor byte shuffle instructions.
+            break;
+        }
+
+        applyPaletteScalar( imageIn, transformIn, inWidth, imageOut, outWidth, width, height, palette );
+    }
+}
@@ -0,0 +1,64 @@
+/***************************************************************************
+ *   fheroes2: https://github.com/ihhub/fheroes2                           *
+ *   Copyright (C) 2025                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace fheroes2
+{
+    enum class SimdInstructionSet : uint8_t
+    {
+        // Plain C++ code.
+        NONE,
+        SSE2,
+        AVX2,
+        // Only 64-bit ARM processors are supported.
+        NEON
+    };
+
+    // Returns all instruction sets supported by the current CPU. The scalar implementation is always the first one.
+    std::vector<SimdInstructionSet> getSupportedSimdInstructionSets();
+
+    // Returns the instruction set which is used by the image processing functions. By default it is the best supported one.
+    SimdInstructionSet getSimdInstructionSet();
+
+    // Forces the use of the given instruction set. Returns false if it is not supported by the current CPU.
+    // This function is intended for benchmarks and must not be called while images are being processed in other threads.
+    bool setSimdInstructionSet( const SimdInstructionSet instructionSet );
+
+    const char * getSimdInstructionSetName( const SimdInstructionSet instructionSet );
+
+    // Converts a rectangular area of an 8-bit image into 32-bit pixels using the given palette of 256 elements.
+    // Widths of the input and output buffers are given in pixels.
+    void convert8BitTo32Bit( const uint8_t * in, const int32_t inWidth, uint32_t * out, const int32_t outWidth, const int32_t width, const int32_t height,
+                             const uint32_t * palette );
+
+    // Blits an image with a transform layer following the rules of fheroes2::Blit(): pixels with transform value 0 are copied, 1 are skipped
+    // and other values apply the corresponding transform table to the output. The transform layer of the output image is optional.
+    void blitMasked8Bit( const uint8_t * imageIn, const uint8_t * transformIn, const int32_t inWidth, uint8_t * imageOut, uint8_t * transformOut,
+                         const int32_t outWidth, const int32_t width, const int32_t height, const uint8_t * transformTable );
+
+    // Applies the palette of 256 elements to the pixels with transform value 0. If there is no transform layer all pixels are modified.
+    // Input and output areas can be the same.
+    void applyPalette8Bit( const uint8_t * imageIn, const uint8_t * transformIn, const int32_t inWidth, uint8_t * imageOut, const int32_t outWidth,
+                           const int32_t width, const int32_t height, const uint8_t * palette );
+}
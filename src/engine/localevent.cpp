@@ -1227,18 +1227,21 @@ bool LocalEvent::HandleEvents( const bool sleepAfterEventProcessing /* = true */
 
     fheroes2::Display & display = fheroes2::Display::instance();
 
-    // To maintain color cycling animation we need to render the whole frame with an updated palette.
-    if ( isDisplayRefreshRequired || fheroes2::RenderProcessor::instance().isCyclingUpdateRequired() ) {
+    if ( isDisplayRefreshRequired ) {
         renderRoi = { 0, 0, display.width(), display.height() };
     }
     else {
         renderRoi = _mouseCursorRenderArea;
     }
 
+    // To maintain color cycling animation we need to render a frame with an updated palette.
+    // The display renders only areas containing cycling colors in such case so there is no need to render the whole frame.
+    const bool isCyclingUpdateRequired = fheroes2::RenderProcessor::instance().isCyclingUpdateRequired();
+
     static_assert( globalLoopSleepTime == 1, "Since you have changed the sleep time, make sure that the sleep does not last too long." );
 
     if ( sleepAfterEventProcessing ) {
-        if ( renderRoi != fheroes2::Rect() ) {
+        if ( renderRoi != fheroes2::Rect() || isCyclingUpdateRequired ) {
             display.render( renderRoi );
         }
 
@@ -20,6 +20,7 @@
 
 #include "pal.h"
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cstring>
@@ -166,15 +167,15 @@ namespace
         uint8_t length;
         bool forward;
     };
+
+    const std::array<CyclingColorSet, 4> cycleSet{ CyclingColorSet{ 214, 4, false }, CyclingColorSet{ 218, 4, false }, CyclingColorSet{ 231, 5, true },
+                                                   CyclingColorSet{ 238, 4, false } };
 }
 
 std::vector<uint8_t> PAL::GetCyclingPalette( const uint32_t stepId )
 {
     std::vector<uint8_t> palette = PAL::GetPalette( PaletteType::STANDARD );
 
-    static const std::array<CyclingColorSet, 4> cycleSet{ CyclingColorSet{ 214, 4, false }, CyclingColorSet{ 218, 4, false }, CyclingColorSet{ 231, 5, true },
-                                                          CyclingColorSet{ 238, 4, false } };
-
     for ( const CyclingColorSet & colorSet : cycleSet ) {
         for ( uint32_t id = 0; id < colorSet.length; ++id ) {
             uint32_t newColorID;
@@ -193,6 +194,12 @@ std::vector<uint8_t> PAL::GetCyclingPalette( const uint32_t stepId )
     return palette;
 }
 
+bool PAL::IsCyclingColor( const uint8_t colorId )
+{
+    return std::any_of( cycleSet.begin(), cycleSet.end(),
+                        [colorId]( const CyclingColorSet & colorSet ) { return colorId >= colorSet.start && colorId < colorSet.start + colorSet.length; } );
+}
+
 const std::vector<uint8_t> & PAL::GetPalette( const PaletteType type )
 {
     switch ( type ) {
@@ -45,6 +45,10 @@ namespace PAL
     };
 
     std::vector<uint8_t> GetCyclingPalette( const uint32_t stepId );
+
+    // Returns true if the color is changed by the cycling palette.
+    bool IsCyclingColor( const uint8_t colorId );
+
     const std::vector<uint8_t> & GetPalette( const PaletteType type );
     std::vector<uint8_t> CombinePalettes( const std::vector<uint8_t> & first, const std::vector<uint8_t> & second );
 }
@@ -168,6 +168,30 @@ namespace Rand
 
     PCG32 & CurrentThreadRandomDevice();
 
+    // Replaces the random generator of the current thread for the lifetime of this object. Functions like Get() or Shuffle() then
+    // produce reproducible results regardless of the thread they are called from.
+    class ThreadRandomDeviceOverride
+    {
+    public:
+        explicit ThreadRandomDeviceOverride( const PCG32 & gen )
+            : _previousGen( CurrentThreadRandomDevice() )
+        {
+            CurrentThreadRandomDevice() = gen;
+        }
+
+        ThreadRandomDeviceOverride( const ThreadRandomDeviceOverride & ) = delete;
+
+        ~ThreadRandomDeviceOverride()
+        {
+            CurrentThreadRandomDevice() = _previousGen;
+        }
+
+        ThreadRandomDeviceOverride & operator=( const ThreadRandomDeviceOverride & ) = delete;
+
+    private:
+        const PCG32 _previousGen;
+    };
+
     uint32_t Get( uint32_t from, uint32_t to = 0 );
 
     template <typename T, std::enable_if_t<std::is_enum_v<T>, bool> = true>
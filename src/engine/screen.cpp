@@ -19,8 +19,10 @@
  ***************************************************************************/
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <iterator>
@@ -60,8 +62,10 @@
 #endif
 
 #include "image_palette.h"
+#include "image_simd.h"
 #include "logging.h"
 #include "math_tools.h"
+#include "pal.h"
 #include "screen.h"
 #include "system.h"
 
@@ -218,6 +222,47 @@ namespace
         return palette.data();
     }
 
+    // Merging of two screen areas is worth it if it adds no more than this number of pixels since every screen update has its own overhead.
+    constexpr int64_t maxExtraPixelsOnMerge = 64 * 64;
+
+    int64_t getArea( const fheroes2::Rect & roi )
+    {
+        return static_cast<int64_t>( roi.width ) * roi.height;
+    }
+
+    // Returns the number of pixels which belong to the boundary rectangle of both rectangles but not to the rectangles themselves.
+    int64_t getExtraPixelsOnMerge( const fheroes2::Rect & first, const fheroes2::Rect & second )
+    {
+        const int32_t intersectionWidth = std::min( first.x + first.width, second.x + second.width ) - std::max( first.x, second.x );
+        const int32_t intersectionHeight = std::min( first.y + first.height, second.y + second.height ) - std::max( first.y, second.y );
+
+        int64_t intersectionArea = 0;
+        if ( intersectionWidth > 0 && intersectionHeight > 0 ) {
+            intersectionArea = static_cast<int64_t>( intersectionWidth ) * intersectionHeight;
+        }
+
+        return getArea( fheroes2::getBoundaryRect( first, second ) ) - getArea( first ) - getArea( second ) + intersectionArea;
+    }
+
+    // The size of a square screen tile used to track areas with cycling colors.
+    constexpr int32_t cyclingTileSize = 32;
+
+    // Cycling colors occupy only small parts of the screen so rendering them as a few dozens of rectangles is cheaper than rendering the whole frame.
+    constexpr size_t maxCyclingRectCount = 64;
+
+    const std::array<uint8_t, 256> & getCyclingColorTable()
+    {
+        static const std::array<uint8_t, 256> table = []() {
+            std::array<uint8_t, 256> output{ 0 };
+            for ( size_t i = 0; i < output.size(); ++i ) {
+                output[i] = PAL::IsCyclingColor( static_cast<uint8_t>( i ) ) ? 1 : 0;
+            }
+            return output;
+        }();
+
+        return table;
+    }
+
     // Updates `roi` to be only inside {0, 0, width, height} rectangle.
     // Returns false if `roi` is out of such rectangle.
     bool getActiveArea( fheroes2::Rect & roi, const int32_t width, const int32_t height )
@@ -293,13 +338,9 @@ namespace
 
             if ( fullFrame ) {
                 if ( surface->format->BitsPerPixel == 32 ) {
-                    uint32_t * out = static_cast<uint32_t *>( surface->pixels );
-                    const uint32_t * outEnd = out + imageWidth * imageHeight;
-                    const uint8_t * in = imageIn;
-                    const uint32_t * transform = _palette32Bit.data();
-
-                    for ( ; out != outEnd; ++out, ++in )
-                        *out = *( transform + *in );
+                    // The whole image is converted as a single row since there are no gaps between rows.
+                    const int32_t pixelCount = imageWidth * imageHeight;
+                    fheroes2::convert8BitTo32Bit( imageIn, pixelCount, static_cast<uint32_t *>( surface->pixels ), pixelCount, pixelCount, 1, _palette32Bit.data() );
                 }
                 else if ( ( surface->format->BitsPerPixel == 8 ) && ( surface->pixels != imageIn ) ) {
                     if ( imageWidth % 4 != 0 ) {
@@ -315,19 +356,8 @@ namespace
             }
             else {
                 if ( surface->format->BitsPerPixel == 32 ) {
-                    uint32_t * outY = static_cast<uint32_t *>( surface->pixels );
-                    const uint32_t * outYEnd = outY + imageWidth * roi.height;
-                    const uint8_t * inY = imageIn + roi.x + roi.y * imageWidth;
-                    const uint32_t * transform = _palette32Bit.data();
-
-                    for ( ; outY != outYEnd; outY += imageWidth, inY += imageWidth ) {
-                        uint32_t * outX = outY;
-                        const uint32_t * outXEnd = outX + roi.width;
-                        const uint8_t * inX = inY;
-
-                        for ( ; outX != outXEnd; ++outX, ++inX )
-                            *outX = *( transform + *inX );
-                    }
+                    fheroes2::convert8BitTo32Bit( imageIn + roi.x + roi.y * imageWidth, imageWidth, static_cast<uint32_t *>( surface->pixels ), imageWidth, roi.width,
+                                                  roi.height, _palette32Bit.data() );
                 }
                 else if ( ( surface->format->BitsPerPixel == 8 ) && ( surface->pixels != imageIn ) ) {
                     const int32_t screenWidth = ( imageWidth / 4 ) * 4 + 4;
@@ -715,10 +745,8 @@ namespace
             return true;
         }
 
-        void render( const fheroes2::Display & display, const fheroes2::Rect & roi ) override
+        void render( const fheroes2::Display & display, const fheroes2::DirtyRegion & /* region */ ) override
         {
-            (void)roi;
-
             if ( _texBuffer == nullptr )
                 return;
 
@@ -1062,7 +1090,7 @@ namespace
             _windowedSize = {};
         }
 
-        void render( const fheroes2::Display & display, const fheroes2::Rect & roi ) override
+        void render( const fheroes2::Display & display, const fheroes2::DirtyRegion & region ) override
         {
             if ( _surface == nullptr ) {
                 return;
@@ -1070,28 +1098,36 @@ namespace
 
             assert( _renderer != nullptr && _texture != nullptr );
 
-            copyImageToSurface( display, _surface, roi );
+            for ( const fheroes2::Rect & roi : region.rects() ) {
+                // Every area is converted into the beginning of the surface so it must be uploaded before the next one is converted.
+                copyImageToSurface( display, _surface, roi );
 
-            const bool fullFrame = ( roi.width == display.width() ) && ( roi.height == display.height() );
-            if ( fullFrame ) {
-                const int returnCode = SDL_UpdateTexture( _texture, nullptr, _surface->pixels, _surface->pitch );
-                if ( returnCode < 0 ) {
-                    ERROR_LOG( "Failed to update texture. The error value: " << returnCode << ", description: " << SDL_GetError() )
+                const bool fullFrame = ( roi.width == display.width() ) && ( roi.height == display.height() );
+                if ( fullFrame ) {
+                    const int returnCode = SDL_UpdateTexture( _texture, nullptr, _surface->pixels, _surface->pitch );
+                    if ( returnCode < 0 ) {
+                        ERROR_LOG( "Failed to update texture. The error value: " << returnCode << ", description: " << SDL_GetError() )
+                    }
                 }
-            }
-            else {
-                SDL_Rect area;
-                area.x = roi.x;
-                area.y = roi.y;
-                area.w = roi.width;
-                area.h = roi.height;
+                else {
+                    SDL_Rect area;
+                    area.x = roi.x;
+                    area.y = roi.y;
+                    area.w = roi.width;
+                    area.h = roi.height;
 
-                const int returnCode = SDL_UpdateTexture( _texture, &area, _surface->pixels, _surface->pitch );
-                if ( returnCode < 0 ) {
-                    ERROR_LOG( "Failed to update texture. The error value: " << returnCode << ", description: " << SDL_GetError() )
+                    const int returnCode = SDL_UpdateTexture( _texture, &area, _surface->pixels, _surface->pitch );
+                    if ( returnCode < 0 ) {
+                        ERROR_LOG( "Failed to update texture. The error value: " << returnCode << ", description: " << SDL_GetError() )
+                    }
                 }
             }
 
+            // Before the areas were tracked separately their whole boundary rectangle had been uploaded.
+            DEBUG_LOG( DBG_ENGINE, DBG_TRACE,
+                       "Uploaded " << region.area() * _surface->format->BytesPerPixel << " bytes in " << region.rects().size() << " areas instead of "
+                                   << getArea( region.boundary() ) * _surface->format->BytesPerPixel << " bytes" )
+
             int returnCode = SDL_RenderClear( _renderer );
             if ( returnCode < 0 ) {
                 ERROR_LOG( "Failed to clear renderer. The error value: " << returnCode << ", description: " << SDL_GetError() )
@@ -1410,7 +1446,7 @@ namespace fheroes2
         // deallocate engine resources
         _engine->clear();
 
-        _prevRoi = {};
+        _prevRegion.clear();
 
         // allocate engine resources
         if ( !_engine->allocate( info, isFullScreen ) ) {
@@ -1420,6 +1456,10 @@ namespace fheroes2
         Image::resize( info.gameWidth, info.gameHeight );
         Image::reset();
 
+        // The image is filled by a non-cycling color after the reset.
+        _cyclingTileColumns = ( info.gameWidth + cyclingTileSize - 1 ) / cyclingTileSize;
+        _cyclingTiles.assign( static_cast<size_t>( _cyclingTileColumns ) * static_cast<size_t>( ( info.gameHeight + cyclingTileSize - 1 ) / cyclingTileSize ), 0 );
+
         _screenSize = { info.screenWidth, info.screenHeight };
     }
 
@@ -1434,13 +1474,97 @@ namespace fheroes2
         return display;
     }
 
+    void DirtyRegion::add( const Rect & roi )
+    {
+        if ( roi.width <= 0 || roi.height <= 0 ) {
+            return;
+        }
+
+        // A merged rectangle can become close enough to other rectangles so the merging is repeated until there is nothing to merge.
+        Rect merged = roi;
+
+        bool isMerged = true;
+        while ( isMerged ) {
+            isMerged = false;
+
+            for ( auto iter = _rects.begin(); iter != _rects.end(); ++iter ) {
+                if ( getExtraPixelsOnMerge( *iter, merged ) <= maxExtraPixelsOnMerge ) {
+                    merged = getBoundaryRect( *iter, merged );
+                    _rects.erase( iter );
+                    isMerged = true;
+                    break;
+                }
+            }
+        }
+
+        _rects.push_back( merged );
+
+        while ( _rects.size() > _maxRectCount ) {
+            size_t bestFirst = 0;
+            size_t bestSecond = 1;
+            int64_t minExtraPixels = INT64_MAX;
+
+            for ( size_t first = 0; first < _rects.size(); ++first ) {
+                for ( size_t second = first + 1; second < _rects.size(); ++second ) {
+                    const int64_t extraPixels = getExtraPixelsOnMerge( _rects[first], _rects[second] );
+                    if ( extraPixels < minExtraPixels ) {
+                        minExtraPixels = extraPixels;
+                        bestFirst = first;
+                        bestSecond = second;
+                    }
+                }
+            }
+
+            _rects[bestFirst] = getBoundaryRect( _rects[bestFirst], _rects[bestSecond] );
+            _rects.erase( _rects.begin() + static_cast<ptrdiff_t>( bestSecond ) );
+        }
+    }
+
+    int64_t DirtyRegion::area() const
+    {
+        int64_t total = 0;
+        for ( const Rect & roi : _rects ) {
+            total += getArea( roi );
+        }
+
+        return total;
+    }
+
+    Rect DirtyRegion::boundary() const
+    {
+        Rect output;
+        for ( const Rect & roi : _rects ) {
+            output = getBoundaryRect( output, roi );
+        }
+
+        return output;
+    }
+
     void Display::render( const Rect & roi )
     {
-        Rect temp( roi );
-        if ( !getActiveArea( temp, width(), height() ) ) {
+        DirtyRegion region;
+        region.add( roi );
+
+        render( region );
+    }
+
+    void Display::render( const DirtyRegion & region )
+    {
+        DirtyRegion current;
+        for ( Rect roi : region.rects() ) {
+            if ( getActiveArea( roi, width(), height() ) ) {
+                current.add( roi );
+            }
+        }
+
+        // Without the pre-processing step there is nothing to render. Otherwise, the step can change the palette and it has to be applied.
+        if ( current.empty() && !_preprocessing ) {
             return;
         }
 
+        // Previous areas must be updated as well to avoid ghost effect, for example, from the previous position of cursor.
+        DirtyRegion frameRegion = _prevRegion;
+
         if ( _cursor->isVisible() && _cursor->isSoftwareEmulation() && !_cursor->_image.empty() ) {
             const Sprite & cursorImage = _cursor->_image;
             Rect cursorROI( cursorImage.x(), cursorImage.y(), cursorImage.width(), cursorImage.height() );
@@ -1455,11 +1579,15 @@ namespace fheroes2
 
             // ROI must include cursor's area as well, otherwise cursor won't be rendered.
             if ( !backup.empty() && getActiveArea( cursorROI, width(), height() ) ) {
-                temp = getBoundaryRect( temp, cursorROI );
+                current.add( cursorROI );
             }
 
-            // Previous position of cursor must be updated as well to avoid ghost effect.
-            _renderFrame( getBoundaryRect( temp, _prevRoi ) );
+            frameRegion.add( current );
+
+            // Areas added by pre-processing step through updateNextRenderRoi() method must be kept for the next frame.
+            _prevRegion = std::move( current );
+
+            _renderFrame( frameRegion );
 
             if ( _postprocessing ) {
                 _postprocessing();
@@ -1468,24 +1596,32 @@ namespace fheroes2
             Copy( backup, 0, 0, *this, backup.x(), backup.y(), backup.width(), backup.height() );
         }
         else {
-            _renderFrame( getBoundaryRect( temp, _prevRoi ) );
+            frameRegion.add( current );
+
+            _prevRegion = std::move( current );
+
+            _renderFrame( frameRegion );
 
             if ( _postprocessing ) {
                 _postprocessing();
             }
         }
-
-        _prevRoi = temp;
     }
 
     void Display::updateNextRenderRoi( const Rect & roi )
     {
-        _prevRoi = getBoundaryRect( _prevRoi, roi );
-        getActiveArea( _prevRoi, width(), height() );
+        Rect temp( roi );
+        if ( getActiveArea( temp, width(), height() ) ) {
+            _prevRegion.add( temp );
+        }
     }
 
-    void Display::_renderFrame( const Rect & roi ) const
+    void Display::_renderFrame( const DirtyRegion & region )
     {
+        if ( _renderSurface == nullptr ) {
+            _updateCyclingTiles( region );
+        }
+
         bool updateImage = true;
         if ( _preprocessing ) {
             std::vector<uint8_t> palette;
@@ -1494,16 +1630,102 @@ namespace fheroes2
                 // when we change a palette for 8-bit image we unwillingly call render so we don't need to re-render the same frame again
                 updateImage = ( _renderSurface == nullptr );
                 if ( updateImage ) {
-                    // Pre-processing step is applied to the whole image so we forcefully render the full frame.
-                    _engine->render( *this, { 0, 0, width(), height() } );
+                    // The new palette affects only pixels of cycling colors so only the tiles containing them are rendered on top of the requested areas.
+                    DirtyRegion cyclingRegion = _getCyclingRegion();
+                    cyclingRegion.add( region );
+
+                    if ( !cyclingRegion.empty() ) {
+                        _engine->render( *this, cyclingRegion );
+                    }
                     return;
                 }
             }
         }
 
-        if ( updateImage ) {
-            _engine->render( *this, roi );
+        if ( updateImage && !region.empty() ) {
+            _engine->render( *this, region );
+        }
+    }
+
+    void Display::_updateCyclingTiles( const DirtyRegion & region )
+    {
+        const int32_t imageWidth = width();
+        const int32_t imageHeight = height();
+
+        if ( _cyclingTileColumns <= 0 || imageWidth <= 0 || imageHeight <= 0 ) {
+            return;
+        }
+
+        const std::array<uint8_t, 256> & cyclingColors = getCyclingColorTable();
+        const uint8_t * imageY = Image::image();
+
+        for ( const Rect & roi : region.rects() ) {
+            const int32_t firstTileX = roi.x / cyclingTileSize;
+            const int32_t lastTileX = ( roi.x + roi.width - 1 ) / cyclingTileSize;
+            const int32_t firstTileY = roi.y / cyclingTileSize;
+            const int32_t lastTileY = ( roi.y + roi.height - 1 ) / cyclingTileSize;
+
+            for ( int32_t tileY = firstTileY; tileY <= lastTileY; ++tileY ) {
+                const int32_t offsetY = tileY * cyclingTileSize;
+                const int32_t tileHeight = std::min( cyclingTileSize, imageHeight - offsetY );
+
+                for ( int32_t tileX = firstTileX; tileX <= lastTileX; ++tileX ) {
+                    const int32_t offsetX = tileX * cyclingTileSize;
+                    const int32_t tileWidth = std::min( cyclingTileSize, imageWidth - offsetX );
+
+                    // The whole tile is scanned, not only its part within the area, because the rest of the tile might have been changed as well.
+                    uint8_t hasCyclingColors = 0;
+
+                    const uint8_t * rowY = imageY + static_cast<ptrdiff_t>( offsetY ) * imageWidth + offsetX;
+                    const uint8_t * rowYEnd = rowY + static_cast<ptrdiff_t>( tileHeight ) * imageWidth;
+
+                    for ( ; rowY != rowYEnd && hasCyclingColors == 0; rowY += imageWidth ) {
+                        const uint8_t * rowXEnd = rowY + tileWidth;
+                        for ( const uint8_t * rowX = rowY; rowX != rowXEnd; ++rowX ) {
+                            hasCyclingColors |= cyclingColors[*rowX];
+                        }
+                    }
+
+                    _cyclingTiles[static_cast<size_t>( tileY ) * static_cast<size_t>( _cyclingTileColumns ) + static_cast<size_t>( tileX )] = hasCyclingColors;
+                }
+            }
+        }
+    }
+
+    DirtyRegion Display::_getCyclingRegion() const
+    {
+        DirtyRegion region( maxCyclingRectCount );
+
+        if ( _cyclingTileColumns <= 0 ) {
+            return region;
+        }
+
+        const int32_t tileRows = static_cast<int32_t>( _cyclingTiles.size() / static_cast<size_t>( _cyclingTileColumns ) );
+
+        for ( int32_t tileY = 0; tileY < tileRows; ++tileY ) {
+            const uint8_t * tileRow = _cyclingTiles.data() + static_cast<size_t>( tileY ) * static_cast<size_t>( _cyclingTileColumns );
+
+            // Neighboring marked tiles within a row are joined into a single rectangle.
+            int32_t tileX = 0;
+            while ( tileX < _cyclingTileColumns ) {
+                if ( tileRow[tileX] == 0 ) {
+                    ++tileX;
+                    continue;
+                }
+
+                const int32_t firstTileX = tileX;
+                while ( tileX < _cyclingTileColumns && tileRow[tileX] != 0 ) {
+                    ++tileX;
+                }
+
+                Rect roi( firstTileX * cyclingTileSize, tileY * cyclingTileSize, ( tileX - firstTileX ) * cyclingTileSize, cyclingTileSize );
+                if ( getActiveArea( roi, width(), height() ) ) {
+                    region.add( roi );
+                }
+            }
         }
+
+        return region;
     }
 
     uint8_t * Display::image()
@@ -1522,7 +1744,9 @@ namespace fheroes2
         _cursor.reset();
         clear();
 
-        _prevRoi = {};
+        _prevRegion.clear();
+        _cyclingTiles.clear();
+        _cyclingTileColumns = 0;
     }
 
     void Display::changePalette( const uint8_t * palette, const bool forceDefaultPaletteUpdate ) const
@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -81,6 +83,53 @@ namespace fheroes2
         int32_t screenHeight{ 0 };
     };
 
+    // A set of screen areas which need to be updated. Every update of the screen has its own overhead so areas which are close to each other
+    // are merged together when the merged area contains only a few extra pixels.
+    class DirtyRegion
+    {
+    public:
+        explicit DirtyRegion( const size_t maxRectCount = 8 )
+            : _maxRectCount( maxRectCount )
+        {
+            assert( _maxRectCount > 0 );
+        }
+
+        void add( const Rect & roi );
+
+        void add( const DirtyRegion & region )
+        {
+            for ( const Rect & roi : region._rects ) {
+                add( roi );
+            }
+        }
+
+        void clear()
+        {
+            _rects.clear();
+        }
+
+        bool empty() const
+        {
+            return _rects.empty();
+        }
+
+        const std::vector<Rect> & rects() const
+        {
+            return _rects;
+        }
+
+        // Returns the total number of pixels in the region.
+        int64_t area() const;
+
+        Rect boundary() const;
+
+    private:
+        // No more than this number of rectangles is kept, the closest ones are merged when this limit is exceeded.
+        size_t _maxRectCount;
+
+        std::vector<Rect> _rects;
+    };
+
     class BaseRenderEngine
     {
     public:
@@ -162,7 +211,8 @@ namespace fheroes2
             // Do nothing.
         }
 
-        virtual void render( const Display &, const Rect & )
+        // The region is never empty and all its rectangles are within the display.
+        virtual void render( const Display &, const DirtyRegion & )
         {
             // Do nothing.
         }
@@ -215,6 +265,9 @@ namespace fheroes2
         // Render a part of frame on screen.
         void render( const Rect & roi );
 
+        // Render several parts of frame on screen.
+        void render( const DirtyRegion & region );
+
         // Update the area which will be rendered on the next render() call.
         void updateNextRenderRoi( const Rect & roi );
 
@@ -271,8 +324,13 @@ namespace fheroes2
 
         uint8_t * _renderSurface{ nullptr };
 
-        // Previous area drawn on the screen.
-        Rect _prevRoi;
+        // Previous areas drawn on the screen.
+        DirtyRegion _prevRegion;
+
+        // The screen is split into square tiles and every tile is marked if it contains at least one pixel of cycling colors.
+        // Only these tiles must be rendered when the palette is being cycled.
+        std::vector<uint8_t> _cyclingTiles;
+        int32_t _cyclingTileColumns{ 0 };
 
         Size _screenSize;
 
@@ -284,7 +342,11 @@ namespace fheroes2
 
         Display();
 
-        void _renderFrame( const Rect & roi ) const; // prepare and render a frame
+        void _renderFrame( const DirtyRegion & region ); // prepare and render a frame
+
+        void _updateCyclingTiles( const DirtyRegion & region );
+
+        DirtyRegion _getCyclingRegion() const;
     };
 
     class Cursor
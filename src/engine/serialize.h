@@ -597,6 +597,8 @@ class ROStreamBuf final : public StreamBufTmpl<const uint8_t>
 public:
     // Creates a non-owning stream on top of an external buffer ("view mode")
     explicit ROStreamBuf( const std::vector<uint8_t> & buf );
+    // Creates a non-owning stream on top of an external memory block ("view mode")
+    ROStreamBuf( const uint8_t * data, const size_t size );
     // Takes ownership of the given buffer (through the move operation) and creates a stream on top of it
     explicit ROStreamBuf( std::vector<uint8_t> && buf );
 
@@ -313,6 +313,16 @@ bool System::Unlink( const std::string_view path )
     return std::filesystem::remove( path, ec );
 }
 
+bool System::Rename( const std::string_view from, const std::string_view to )
+{
+    std::error_code ec;
+
+    // Using the non-throwing overload
+    std::filesystem::rename( from, to, ec );
+
+    return !ec;
+}
+
 std::string System::concatPath( const std::string_view left, const std::string_view right )
 {
     return fsPathToString( std::filesystem::path{ left }.append( right ) );
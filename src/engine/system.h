@@ -44,6 +44,8 @@ namespace System
 
     bool MakeDirectory( const std::string_view path );
     bool Unlink( const std::string_view path );
+    // Replaces the destination file by the source file if the destination file already exists.
+    bool Rename( const std::string_view from, const std::string_view to );
 
     std::string concatPath( const std::string_view left, const std::string_view right );
 
@@ -22,6 +22,7 @@
 
 #include <cassert>
 #include <memory>
+#include <utility>
 
 #if defined( __EMSCRIPTEN__ ) && !defined( __EMSCRIPTEN_PTHREADS__ )
 namespace
@@ -150,4 +151,153 @@ namespace MultiThreading
             manager->executeTask();
         }
     }
+
+    WorkerPool::WorkerPool( const size_t workerCount )
+    {
+#if !defined( __EMSCRIPTEN__ ) || defined( __EMSCRIPTEN_PTHREADS__ )
+        size_t count = workerCount;
+        if ( count == 0 ) {
+            const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+
+            // The calling thread also takes part in the processing.
+            count = ( hardwareThreads > 1 ) ? hardwareThreads - 1 : 0;
+        }
+
+        _workers.reserve( count );
+
+        for ( size_t i = 0; i < count; ++i ) {
+            // Thread id 0 is reserved for the calling thread.
+            _workers.emplace_back( WorkerPool::_workerThread, this, i + 1 );
+        }
+#else
+        (void)workerCount;
+#endif
+    }
+
+    WorkerPool::~WorkerPool()
+    {
+        {
+            const std::scoped_lock<std::mutex> lock( _mutex );
+
+            _exitFlag = true;
+        }
+
+        _workerNotification.notify_all();
+
+        for ( std::thread & worker : _workers ) {
+            worker.join();
+        }
+    }
+
+    void WorkerPool::parallelFor( const size_t itemCount, const std::function<void( size_t, size_t )> & job )
+    {
+        if ( itemCount == 0 ) {
+            return;
+        }
+
+        // There is no reason to wake up workers for a single item.
+        if ( _workers.empty() || itemCount == 1 ) {
+            for ( size_t itemId = 0; itemId < itemCount; ++itemId ) {
+                job( itemId, 0 );
+            }
+
+            return;
+        }
+
+        {
+            const std::scoped_lock<std::mutex> lock( _mutex );
+
+            assert( _job == nullptr && _activeWorkerCount == 0 );
+
+            _job = &job;
+            _itemCount = itemCount;
+            _nextItemId = 0;
+            _activeWorkerCount = _workers.size();
+            ++_jobGeneration;
+        }
+
+        _workerNotification.notify_all();
+
+        _processItems( 0 );
+
+        std::exception_ptr exception;
+
+        {
+            std::unique_lock<std::mutex> lock( _mutex );
+
+            _masterNotification.wait( lock, [this] { return _activeWorkerCount == 0; } );
+
+            _job = nullptr;
+
+            exception = std::exchange( _exception, nullptr );
+        }
+
+        if ( exception ) {
+            std::rethrow_exception( exception );
+        }
+    }
+
+    void WorkerPool::_processItems( const size_t threadId )
+    {
+        assert( _job != nullptr );
+
+        while ( true ) {
+            const size_t itemId = _nextItemId.fetch_add( 1 );
+            if ( itemId >= _itemCount ) {
+                break;
+            }
+
+            try {
+                ( *_job )( itemId, threadId );
+            }
+            catch ( ... ) {
+                const std::scoped_lock<std::mutex> lock( _mutex );
+
+                if ( !_exception ) {
+                    _exception = std::current_exception();
+                }
+
+                // Skip the remaining items.
+                _nextItemId = _itemCount;
+            }
+        }
+    }
+
+    void WorkerPool::_workerThread( WorkerPool * pool, const size_t threadId )
+    {
+        assert( pool != nullptr );
+
+        uint64_t processedJobGeneration = 0;
+
+        while ( true ) {
+            {
+                std::unique_lock<std::mutex> lock( pool->_mutex );
+
+                pool->_workerNotification.wait( lock, [pool, processedJobGeneration] { return pool->_exitFlag || pool->_jobGeneration != processedJobGeneration; } );
+
+                if ( pool->_exitFlag ) {
+                    break;
+                }
+
+                processedJobGeneration = pool->_jobGeneration;
+            }
+
+            pool->_processItems( threadId );
+
+            bool isLastWorker = false;
+
+            {
+                const std::scoped_lock<std::mutex> lock( pool->_mutex );
+
+                assert( pool->_activeWorkerCount > 0 );
+
+                --pool->_activeWorkerCount;
+                isLastWorker = ( pool->_activeWorkerCount == 0 );
+            }
+
+            if ( isLastWorker ) {
+                pool->_masterNotification.notify_one();
+            }
+        }
+    }
 }
@@ -22,9 +22,14 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 namespace MultiThreading
 {
@@ -70,4 +75,57 @@ namespace MultiThreading
 
         static void _workerThread( AsyncManager * manager );
     };
+
+    // Pool of worker threads that execute the same job for every item of a range. Unlike AsyncManager, which runs
+    // tasks in the background, the caller is blocked until all items are processed and takes part in the processing
+    // itself, so the pool is suitable for splitting a heavy read-only computation into parts.
+    class WorkerPool
+    {
+    public:
+        // If the worker count is 0 then it is chosen based on the number of hardware threads. The calling thread is not
+        // counted as a worker.
+        explicit WorkerPool( const size_t workerCount = 0 );
+        WorkerPool( const WorkerPool & ) = delete;
+
+        ~WorkerPool();
+
+        WorkerPool & operator=( const WorkerPool & ) = delete;
+
+        // Returns the total number of threads (including the calling one) which process items.
+        size_t threadCount() const
+        {
+            return _workers.size() + 1;
+        }
+
+        // Calls job( itemId, threadId ) for every itemId in range [0, itemCount) and waits for all calls to complete. The
+        // threadId is in range [0, threadCount()) and no two concurrent calls receive the same threadId, so it can be used
+        // to access per-thread data without synchronization. The order of items is not defined. If any call throws then
+        // the remaining items are skipped and the first exception is rethrown. This method is not designed to be executed
+        // concurrently.
+        void parallelFor( const size_t itemCount, const std::function<void( size_t, size_t )> & job );
+
+    private:
+        std::vector<std::thread> _workers;
+
+        std::mutex _mutex;
+        std::condition_variable _masterNotification;
+        std::condition_variable _workerNotification;
+
+        const std::function<void( size_t, size_t )> * _job{ nullptr };
+        size_t _itemCount{ 0 };
+        std::atomic<size_t> _nextItemId{ 0 };
+
+        // Number of workers which are still processing items of the current job.
+        size_t _activeWorkerCount{ 0 };
+        // Incremented for each new job, so that workers can distinguish it from a spurious wakeup.
+        uint64_t _jobGeneration{ 0 };
+
+        std::exception_ptr _exception;
+
+        bool _exitFlag{ false };
+
+        void _processItems( const size_t threadId );
+
+        static void _workerThread( WorkerPool * pool, const size_t threadId );
+    };
 }
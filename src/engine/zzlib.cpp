@@ -1,6 +1,6 @@
 /***************************************************************************
  *   fheroes2: https://github.com/ihhub/fheroes2                           *
- *   Copyright (C) 2019 - 2024                                             *
+ *   Copyright (C) 2019 - 2025                                             *
  *                                                                         *
  *   Free Heroes2 Engine: http://sourceforge.net/projects/fheroes2         *
  *   Copyright (C) 2009 by Andrey Afletdinov <fheroes2@gmail.com>          *
@@ -23,7 +23,12 @@
 
 #include "zzlib.h"
 
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
 #include <cstring>
+#include <limits>
 #include <ostream>
 
 #include <zconf.h>
@@ -35,6 +40,9 @@
 namespace
 {
     constexpr uint16_t FORMAT_VERSION_0 = 0;
+
+    // The size of the chunks of the uncompressed and compressed data used by the streaming compression and decompression
+    constexpr size_t streamChunkSize = 64 * 1024;
 }
 
 std::vector<uint8_t> Compression::unzipData( const uint8_t * src, const size_t srcSize, size_t realSize /* = 0 */ )
@@ -174,6 +182,365 @@ bool Compression::zipStreamBuf( const IStreamBuf & inputStream, OStreamBase & ou
     return !outputStream.fail();
 }
 
+Compression::ZipOStream::ZipOStream( StreamFile & outputStream )
+    : _outputStream( outputStream )
+    , _zstream( std::make_unique<z_stream>() )
+    , _outputBuffer( streamChunkSize )
+{
+    _inputBuffer.reserve( streamChunkSize );
+
+    // The format of the compressed data is the same as the one produced by compress()
+    const int ret = deflateInit( _zstream.get(), Z_DEFAULT_COMPRESSION );
+    if ( ret != Z_OK ) {
+        ERROR_LOG( "zlib error: " << ret )
+
+        _zstream.reset();
+        setFail();
+
+        return;
+    }
+
+    // The sizes of the data are not known yet, they will be written by finish()
+    _headerPos = _outputStream.tell();
+
+    _outputStream.put32( 0 );
+    _outputStream.put32( 0 );
+    _outputStream.put16( FORMAT_VERSION_0 );
+    _outputStream.put16( 0 ); // Unused bytes
+
+    if ( _outputStream.fail() ) {
+        setFail();
+    }
+}
+
+Compression::ZipOStream::~ZipOStream()
+{
+    if ( _zstream ) {
+        deflateEnd( _zstream.get() );
+    }
+}
+
+void Compression::ZipOStream::putBE16( uint16_t v )
+{
+    const std::array<uint8_t, 2> data{ static_cast<uint8_t>( v >> 8 ), static_cast<uint8_t>( v & 0xFF ) };
+
+    putRaw( data.data(), data.size() );
+}
+
+void Compression::ZipOStream::putLE16( uint16_t v )
+{
+    const std::array<uint8_t, 2> data{ static_cast<uint8_t>( v & 0xFF ), static_cast<uint8_t>( v >> 8 ) };
+
+    putRaw( data.data(), data.size() );
+}
+
+void Compression::ZipOStream::putBE32( uint32_t v )
+{
+    const std::array<uint8_t, 4> data{ static_cast<uint8_t>( v >> 24 ), static_cast<uint8_t>( ( v >> 16 ) & 0xFF ), static_cast<uint8_t>( ( v >> 8 ) & 0xFF ),
+                                       static_cast<uint8_t>( v & 0xFF ) };
+
+    putRaw( data.data(), data.size() );
+}
+
+void Compression::ZipOStream::putLE32( uint32_t v )
+{
+    const std::array<uint8_t, 4> data{ static_cast<uint8_t>( v & 0xFF ), static_cast<uint8_t>( ( v >> 8 ) & 0xFF ), static_cast<uint8_t>( ( v >> 16 ) & 0xFF ),
+                                       static_cast<uint8_t>( v >> 24 ) };
+
+    putRaw( data.data(), data.size() );
+}
+
+void Compression::ZipOStream::putRaw( const void * ptr, size_t size )
+{
+    assert( !_isFinished );
+
+    const uint8_t * data = static_cast<const uint8_t *>( ptr );
+
+    while ( size > 0 && !fail() ) {
+        const size_t sizeToCopy = std::min( size, streamChunkSize - _inputBuffer.size() );
+
+        _inputBuffer.insert( _inputBuffer.end(), data, data + sizeToCopy );
+
+        data += sizeToCopy;
+        size -= sizeToCopy;
+
+        if ( _inputBuffer.size() == streamChunkSize && !deflateBuffer( false ) ) {
+            setFail();
+        }
+    }
+}
+
+void Compression::ZipOStream::put8( const uint8_t v )
+{
+    putRaw( &v, 1 );
+}
+
+bool Compression::ZipOStream::deflateBuffer( const bool isLastChunk )
+{
+    assert( _zstream );
+
+    _zstream->next_in = _inputBuffer.data();
+    _zstream->avail_in = static_cast<uInt>( _inputBuffer.size() );
+
+    _rawSize += _inputBuffer.size();
+
+    while ( true ) {
+        _zstream->next_out = _outputBuffer.data();
+        _zstream->avail_out = static_cast<uInt>( _outputBuffer.size() );
+
+        const int ret = deflate( _zstream.get(), isLastChunk ? Z_FINISH : Z_NO_FLUSH );
+        if ( ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR ) {
+            ERROR_LOG( "zlib error: " << ret )
+            return false;
+        }
+
+        const size_t compressedSize = _outputBuffer.size() - _zstream->avail_out;
+
+        _outputStream.putRaw( _outputBuffer.data(), compressedSize );
+        if ( _outputStream.fail() ) {
+            return false;
+        }
+
+        _zipSize += compressedSize;
+
+        // Without flushing all the input data is consumed as soon as there is some space left in the output buffer
+        if ( isLastChunk ? ret == Z_STREAM_END : _zstream->avail_out != 0 ) {
+            break;
+        }
+    }
+
+    assert( _zstream->avail_in == 0 );
+
+    _inputBuffer.clear();
+
+    return true;
+}
+
+bool Compression::ZipOStream::finish()
+{
+    assert( !_isFinished );
+
+    _isFinished = true;
+
+    if ( fail() || !deflateBuffer( true ) ) {
+        setFail();
+        return false;
+    }
+
+    if ( _rawSize > std::numeric_limits<uint32_t>::max() || _zipSize > std::numeric_limits<uint32_t>::max() ) {
+        ERROR_LOG( "The size of the data is too large" )
+
+        setFail();
+        return false;
+    }
+
+    const size_t endPos = _outputStream.tell();
+
+    _outputStream.seek( _headerPos );
+    _outputStream.put32( static_cast<uint32_t>( _rawSize ) );
+    _outputStream.put32( static_cast<uint32_t>( _zipSize ) );
+    _outputStream.seek( endPos );
+
+    if ( _outputStream.fail() ) {
+        setFail();
+        return false;
+    }
+
+    return true;
+}
+
+Compression::UnzipIStream::UnzipIStream( IStreamBase & inputStream )
+    : _inputStream( inputStream )
+    , _outputBuffer( streamChunkSize )
+{
+    _rawSize = _inputStream.get32();
+    _zipSizeLeft = _inputStream.get32();
+
+    const uint16_t version = _inputStream.get16();
+
+    _inputStream.skip( 2 ); // Unused bytes
+
+    if ( _inputStream.fail() || _zipSizeLeft == 0 || version != FORMAT_VERSION_0 ) {
+        setFail();
+        return;
+    }
+
+    _zstream = std::make_unique<z_stream>();
+
+    const int ret = inflateInit( _zstream.get() );
+    if ( ret != Z_OK ) {
+        ERROR_LOG( "zlib error: " << ret )
+
+        _zstream.reset();
+        setFail();
+    }
+}
+
+Compression::UnzipIStream::~UnzipIStream()
+{
+    if ( _zstream ) {
+        inflateEnd( _zstream.get() );
+    }
+}
+
+void Compression::UnzipIStream::skip( size_t size )
+{
+    while ( size > 0 ) {
+        if ( _outputPos == _outputSize && !inflateChunk() ) {
+            setFail();
+            return;
+        }
+
+        const size_t sizeToSkip = std::min( size, _outputSize - _outputPos );
+
+        _outputPos += sizeToSkip;
+        size -= sizeToSkip;
+    }
+}
+
+uint16_t Compression::UnzipIStream::getBE16()
+{
+    uint16_t v = ( static_cast<uint16_t>( get8() ) << 8 );
+
+    v |= get8();
+
+    return v;
+}
+
+uint16_t Compression::UnzipIStream::getLE16()
+{
+    uint16_t v = get8();
+
+    v |= ( static_cast<uint16_t>( get8() ) << 8 );
+
+    return v;
+}
+
+uint32_t Compression::UnzipIStream::getBE32()
+{
+    uint32_t v = ( static_cast<uint32_t>( get8() ) << 24 );
+
+    v |= ( static_cast<uint32_t>( get8() ) << 16 );
+    v |= ( static_cast<uint32_t>( get8() ) << 8 );
+    v |= get8();
+
+    return v;
+}
+
+uint32_t Compression::UnzipIStream::getLE32()
+{
+    uint32_t v = get8();
+
+    v |= ( static_cast<uint32_t>( get8() ) << 8 );
+    v |= ( static_cast<uint32_t>( get8() ) << 16 );
+    v |= ( static_cast<uint32_t>( get8() ) << 24 );
+
+    return v;
+}
+
+std::vector<uint8_t> Compression::UnzipIStream::getRaw( size_t size )
+{
+    const bool readAll = ( size == 0 );
+
+    std::vector<uint8_t> v;
+    v.reserve( size );
+
+    while ( readAll || v.size() < size ) {
+        if ( _outputPos == _outputSize && !inflateChunk() ) {
+            // Reaching the end of the data is not an error if all the remaining data was requested
+            if ( !readAll ) {
+                setFail();
+            }
+
+            break;
+        }
+
+        const size_t sizeToCopy = readAll ? _outputSize - _outputPos : std::min( size - v.size(), _outputSize - _outputPos );
+
+        v.insert( v.end(), _outputBuffer.begin() + static_cast<std::ptrdiff_t>( _outputPos ),
+                  _outputBuffer.begin() + static_cast<std::ptrdiff_t>( _outputPos + sizeToCopy ) );
+
+        _outputPos += sizeToCopy;
+    }
+
+    return v;
+}
+
+uint8_t Compression::UnzipIStream::get8()
+{
+    if ( _outputPos == _outputSize && !inflateChunk() ) {
+        setFail();
+
+        return 0;
+    }
+
+    return _outputBuffer[_outputPos++];
+}
+
+bool Compression::UnzipIStream::inflateChunk()
+{
+    if ( _isStreamEnd || !_zstream ) {
+        return false;
+    }
+
+    _outputPos = 0;
+    _outputSize = 0;
+
+    while ( _outputSize == 0 && !_isStreamEnd ) {
+        if ( _zstream->avail_in == 0 ) {
+            if ( _zipSizeLeft == 0 ) {
+                ERROR_LOG( "Unexpected end of the compressed data" )
+
+                setFail();
+                return false;
+            }
+
+            const size_t sizeToRead = std::min<size_t>( _zipSizeLeft, streamChunkSize );
+
+            _inputBuffer = _inputStream.getRaw( sizeToRead );
+            if ( _inputStream.fail() || _inputBuffer.size() != sizeToRead ) {
+                setFail();
+                return false;
+            }
+
+            _zipSizeLeft -= static_cast<uint32_t>( sizeToRead );
+
+            _zstream->next_in = _inputBuffer.data();
+            _zstream->avail_in = static_cast<uInt>( _inputBuffer.size() );
+        }
+
+        _zstream->next_out = _outputBuffer.data();
+        _zstream->avail_out = static_cast<uInt>( _outputBuffer.size() );
+
+        const int ret = inflate( _zstream.get(), Z_NO_FLUSH );
+        if ( ret == Z_STREAM_END ) {
+            _isStreamEnd = true;
+        }
+        else if ( ret != Z_OK && ret != Z_BUF_ERROR ) {
+            ERROR_LOG( "zlib error: " << ret )
+
+            setFail();
+            return false;
+        }
+
+        _outputSize = _outputBuffer.size() - _zstream->avail_out;
+    }
+
+    _rawSizeRead += _outputSize;
+
+    if ( _rawSizeRead > _rawSize || ( _isStreamEnd && _rawSizeRead != _rawSize ) ) {
+        ERROR_LOG( "The size of the decompressed data does not match the expected size" )
+
+        _outputSize = 0;
+        _isStreamEnd = true;
+
+        setFail();
+        return false;
+    }
+
+    return _outputSize > 0;
+}
+
 fheroes2::Image Compression::CreateImageFromZlib( int32_t width, int32_t height, const uint8_t * imageData, size_t imageSize, bool doubleLayer )
 {
     if ( imageData == nullptr || imageSize == 0 || width <= 0 || height <= 0 ) {
@@ -25,13 +25,13 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 #include "image.h"
+#include "serialize.h"
 
-class IStreamBase;
-class OStreamBase;
-class IStreamBuf;
+struct z_stream_s;
 
 namespace Compression
 {
@@ -53,5 +53,95 @@ namespace Compression
     // true on success and false on error.
     bool zipStreamBuf( const IStreamBuf & inputStream, OStreamBase & outputStream );
 
+    // Output stream that compresses the written data on the fly and writes it to the given file in the same format as zipStreamBuf()
+    // does, so only a fixed-size chunk of the uncompressed data is kept in memory. The sizes of the data in the header are written by
+    // finish(), which must be called after all the data has been written.
+    class ZipOStream final : public OStreamBase
+    {
+    public:
+        explicit ZipOStream( StreamFile & outputStream );
+        ZipOStream( const ZipOStream & ) = delete;
+
+        ~ZipOStream() override;
+
+        ZipOStream & operator=( const ZipOStream & ) = delete;
+
+        void putBE16( uint16_t v ) override;
+        void putLE16( uint16_t v ) override;
+        void putBE32( uint32_t v ) override;
+        void putLE32( uint32_t v ) override;
+
+        void putRaw( const void * ptr, size_t size ) override;
+
+        // Compresses the remaining data and updates the header. Returns true on success and false on error.
+        bool finish();
+
+    private:
+        void put8( const uint8_t v ) override;
+
+        // Passes the buffered data to the compressor and writes all the compressed data available to the output stream.
+        bool deflateBuffer( const bool isLastChunk );
+
+        StreamFile & _outputStream;
+
+        std::unique_ptr<z_stream_s> _zstream;
+
+        std::vector<uint8_t> _inputBuffer;
+        std::vector<uint8_t> _outputBuffer;
+
+        size_t _headerPos{ 0 };
+        uint64_t _rawSize{ 0 };
+        uint64_t _zipSize{ 0 };
+
+        bool _isFinished{ false };
+    };
+
+    // Input stream that reads the data written by zipStreamBuf() or ZipOStream from the given stream and decompresses it on the fly,
+    // so only a fixed-size chunk of the compressed and the uncompressed data is kept in memory. The header of the data is read by the
+    // constructor, so the stream is marked as failed right away if the header is corrupted.
+    class UnzipIStream final : public IStreamBase
+    {
+    public:
+        explicit UnzipIStream( IStreamBase & inputStream );
+        UnzipIStream( const UnzipIStream & ) = delete;
+
+        ~UnzipIStream() override;
+
+        UnzipIStream & operator=( const UnzipIStream & ) = delete;
+
+        void skip( size_t size ) override;
+
+        uint16_t getBE16() override;
+        uint16_t getLE16() override;
+        uint32_t getBE32() override;
+        uint32_t getLE32() override;
+
+        // If a zero size is specified, then all still unread data is returned
+        std::vector<uint8_t> getRaw( size_t size ) override;
+
+    private:
+        uint8_t get8() override;
+
+        // Decompresses the next chunk of data into the output buffer. Returns false if there is no more data or in case of an error
+        // (the stream is marked as failed in the latter case).
+        bool inflateChunk();
+
+        IStreamBase & _inputStream;
+
+        std::unique_ptr<z_stream_s> _zstream;
+
+        std::vector<uint8_t> _inputBuffer;
+        std::vector<uint8_t> _outputBuffer;
+
+        size_t _outputPos{ 0 };
+        size_t _outputSize{ 0 };
+
+        uint32_t _rawSize{ 0 };
+        uint32_t _zipSizeLeft{ 0 };
+        uint64_t _rawSizeRead{ 0 };
+
+        bool _isStreamEnd{ false };
+    };
+
     fheroes2::Image CreateImageFromZlib( int32_t width, int32_t height, const uint8_t * imageData, size_t imageSize, bool doubleLayer );
 }
@@ -50,6 +50,34 @@ std::vector<uint8_t> AGG::getDataFromAggFile( const std::string & key, const boo
     return heroes2_agg.read( key );
 }
 
+std::pair<const uint8_t *, size_t> AGG::getDataViewFromAggFile( const std::string & key, const bool ignoreExpansion )
+{
+    if ( !ignoreExpansion && heroes2x_agg.isGood() ) {
+        const std::pair<const uint8_t *, size_t> view = heroes2x_agg.readView( key );
+        if ( view.second > 0 ) {
+            return view;
+        }
+    }
+
+    return heroes2_agg.readView( key );
+}
+
+bool AGG::areDataViewsPersistent()
+{
+    return heroes2_agg.isMemoryMapped() && ( !heroes2x_agg.isGood() || heroes2x_agg.isMemoryMapped() );
+}
+
+uint32_t AGG::getAssetsHash()
+{
+    const uint32_t hash = heroes2_agg.getContentHash();
+
+    if ( !heroes2x_agg.isGood() ) {
+        return hash;
+    }
+
+    return hash ^ ( heroes2x_agg.getContentHash() * 31 );
+}
+
 AGG::AGGInitializer::AGGInitializer()
 {
     if ( init() ) {
@@ -23,8 +23,10 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace AGG
@@ -56,4 +58,14 @@ namespace AGG
     };
 
     std::vector<uint8_t> getDataFromAggFile( const std::string & key, const bool ignoreExpansion );
+
+    // Returns a view of the data without copying it whenever possible. Unless areDataViewsPersistent() returns true, the view is valid
+    // only until the next read from the AGG files.
+    std::pair<const uint8_t *, size_t> getDataViewFromAggFile( const std::string & key, const bool ignoreExpansion );
+
+    // Returns true if the views returned by getDataViewFromAggFile() remain valid for the whole lifetime of the application.
+    bool areDataViewsPersistent();
+
+    // Returns a hash of the contents of the AGG files in use. The first call reads the whole files if they are not memory-mapped.
+    uint32_t getAssetsHash();
 }
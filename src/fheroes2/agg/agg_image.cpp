@@ -26,7 +26,9 @@
 #include <cmath>
 #include <cstddef>
 #include <initializer_list>
+#include <list>
 #include <map>
+#include <memory>
 #include <numeric>
 #include <set>
 #include <stdexcept>
@@ -40,15 +42,19 @@
 #include "exception.h"
 #include "game_language.h"
 #include "h2d.h"
+#include "h2d_file.h"
 #include "icn.h"
 #include "image.h"
 #include "image_tool.h"
+#include "logging.h"
 #include "math_base.h"
 #include "pal.h"
 #include "rand.h"
 #include "screen.h"
 #include "serialize.h"
+#include "system.h"
 #include "til.h"
+#include "timing.h"
 #include "tools.h"
 #include "translations.h"
 #include "ui_button.h"
@@ -61,14 +67,700 @@ namespace
 {
     const std::array<const char *, TIL::LASTTIL> tilFileName = { "UNKNOWN", "CLOF32.TIL", "GROUND32.TIL", "STON.TIL" };
 
-    std::vector<std::vector<fheroes2::Sprite>> _icnVsSprite( ICN::LASTICN );
+    size_t getSpriteMemorySize( const fheroes2::Sprite & sprite )
+    {
+        // Images always allocate memory for both layers.
+        return sprite.empty() ? 0 : static_cast<size_t>( sprite.width() ) * static_cast<size_t>( sprite.height() ) * 2;
+    }
+
+    uint32_t calculateSpritesChecksum( const std::vector<fheroes2::Sprite> & sprites )
+    {
+        uint32_t checksum = static_cast<uint32_t>( sprites.size() );
+
+        for ( const fheroes2::Sprite & sprite : sprites ) {
+            const std::array<int32_t, 4> properties = { sprite.x(), sprite.y(), sprite.width(), sprite.height() };
+
+            checksum = checksum * 31 + fheroes2::calculateCRC32( reinterpret_cast<const uint8_t *>( properties.data() ), sizeof( properties ) );
+
+            if ( sprite.empty() ) {
+                continue;
+            }
+
+            const size_t imageSize = static_cast<size_t>( sprite.width() ) * static_cast<size_t>( sprite.height() );
+
+            checksum = checksum * 31 + fheroes2::calculateCRC32( sprite.image(), imageSize );
+
+            if ( !sprite.singleLayer() ) {
+                checksum = checksum * 31 + fheroes2::calculateCRC32( sprite.transform(), imageSize );
+            }
+        }
+
+        return checksum;
+    }
+
+    using IcnFrameId = std::pair<int, uint32_t>;
+
+    // ICN frames which are still in the encoded form and are decoded one at a time on demand.
+    struct EncodedIcn
+    {
+        // Points either to the memory-mapped AGG file or to the owned data.
+        const uint8_t * data{ nullptr };
+        std::vector<uint8_t> ownedData;
+
+        std::vector<fheroes2::ICNHeader> headers;
+        // Offset and size of every frame's data relative to the beginning of the ICN data.
+        std::vector<std::pair<uint32_t, uint32_t>> frameDataRanges;
+
+        std::vector<bool> isDecoded;
+        // Position of every decoded frame in the LRU list.
+        std::vector<std::list<IcnFrameId>::iterator> lruPositions;
+        // Id of the safe point period during which every decoded frame has been requested last time.
+        std::vector<uint32_t> lastUsePeriods;
+        // Memory used by the scaled copy of every decoded frame.
+        std::vector<size_t> scaledFrameBytes;
+    };
+
+    // Storage of the sprites of all ICNs. Original ICNs which are used as is are decoded lazily, one frame at a time, when the frame
+    // is requested through getFrame(). Only these lazily decoded frames (and their scaled copies) count towards the memory limit and
+    // can be evicted (the least recently used first): generated and modified images are never evicted. An evicted frame becomes an
+    // empty image, and it is decoded again when it is requested next time.
+    //
+    // Frames are never evicted while they are being requested since the callers can hold references to several frames at once.
+    // Instead, evictFrames() must be called at a safe point (after every rendering of the screen), and it evicts only the frames
+    // which have not been requested since the previous safe point. The callers which hold references to frames across several
+    // safe points block the eviction until they are done.
+    //
+    // Any access to the frames of an ICN through operator[] (this is what all the image generation code does) decodes all its remaining
+    // frames and turns it into a regular ICN, so the generation code always sees fully decoded ICNs which are never evicted. Such
+    // accesses can be tracked to find out which ICNs have been modified by the generation code.
+    class IcnSpriteStorage
+    {
+    public:
+        explicit IcnSpriteStorage( const size_t icnCount )
+            : _sprites( icnCount )
+            , _scaledSprites( icnCount )
+            , _encodedIcns( icnCount )
+        {
+            // Do nothing.
+        }
+
+        IcnSpriteStorage( const IcnSpriteStorage & ) = delete;
+        IcnSpriteStorage & operator=( const IcnSpriteStorage & ) = delete;
+
+        size_t size() const
+        {
+            return _sprites.size();
+        }
+
+        std::vector<fheroes2::Sprite> & operator[]( const size_t icnId )
+        {
+            _decodeAllFrames( static_cast<int>( icnId ) );
+
+            if ( _isAccessTracked ) {
+                // The checksum is calculated before the first access since any access can modify the frames.
+                _accessedIcnChecksums.try_emplace( static_cast<int>( icnId ), calculateSpritesChecksum( _sprites[icnId] ) );
+            }
+
+            return _sprites[icnId];
+        }
+
+        // Starts recording of the ICNs accessed through operator[].
+        void startAccessTracking()
+        {
+            assert( !_isAccessTracked && _accessedIcnChecksums.empty() );
+
+            _isAccessTracked = true;
+        }
+
+        // Stops recording of the accesses and returns the ICNs whose frames have been changed since their first access.
+        std::vector<int> stopAccessTracking()
+        {
+            assert( _isAccessTracked );
+
+            _isAccessTracked = false;
+
+            std::vector<int> changedIcnIds;
+
+            for ( const auto & [icnId, checksum] : _accessedIcnChecksums ) {
+                if ( calculateSpritesChecksum( _sprites[icnId] ) != checksum ) {
+                    changedIcnIds.push_back( icnId );
+                }
+            }
+
+            _accessedIcnChecksums.clear();
+
+            return changedIcnIds;
+        }
+
+        // Returns all sprites without decoding the lazily loaded ICNs. Must be used only for the generated ICNs.
+        std::vector<std::vector<fheroes2::Sprite>> & getAllSprites()
+        {
+            return _sprites;
+        }
+
+        size_t getFrameCount( const int icnId ) const
+        {
+            return _sprites[icnId].size();
+        }
+
+        // Returns true if some frames of the ICN are still decoded on demand.
+        bool isEncoded( const int icnId ) const
+        {
+            return _encodedIcns[icnId] != nullptr;
+        }
+
+        const fheroes2::Sprite & getFrame( const int icnId, const uint32_t index )
+        {
+            fheroes2::Sprite & sprite = _sprites[icnId][index];
+
+            EncodedIcn * icn = _encodedIcns[icnId].get();
+            if ( icn == nullptr ) {
+                return sprite;
+            }
+
+            icn->lastUsePeriods[index] = _safePointPeriod;
+
+            if ( icn->isDecoded[index] ) {
+                // Move the frame to the front of the LRU list.
+                _lruFrames.splice( _lruFrames.begin(), _lruFrames, icn->lruPositions[index] );
+
+                return sprite;
+            }
+
+            _decodeFrame( *icn, index, sprite );
+
+            _lruFrames.emplace_front( icnId, index );
+            icn->lruPositions[index] = _lruFrames.begin();
+            icn->isDecoded[index] = true;
+
+            _addResidentBytes( getSpriteMemorySize( sprite ) );
+            ++_stats.residentFrames;
+
+            return sprite;
+        }
+
+        // Returns the copy of the frame scaled for the current resolution. It can be empty or have an outdated size.
+        // If the frame is decoded on demand, the scaled copy is evicted together with it.
+        fheroes2::Sprite & getScaledFrame( const int icnId, const uint32_t index )
+        {
+            std::vector<fheroes2::Sprite> & scaledSprites = _scaledSprites[icnId];
+            if ( scaledSprites.empty() ) {
+                scaledSprites.resize( _sprites[icnId].size() );
+            }
+
+            assert( index < scaledSprites.size() );
+
+            return scaledSprites[index];
+        }
+
+        // Must be called after every change of the scaled copy of the frame.
+        void updateScaledFrameMemory( const int icnId, const uint32_t index )
+        {
+            EncodedIcn * icn = _encodedIcns[icnId].get();
+            if ( icn == nullptr || !icn->isDecoded[index] ) {
+                // Scaled copies of the regular frames are not counted just like the frames themselves.
+                return;
+            }
+
+            assert( _stats.residentBytes >= icn->scaledFrameBytes[index] );
+
+            _stats.residentBytes -= icn->scaledFrameBytes[index];
+            icn->scaledFrameBytes[index] = getSpriteMemorySize( _scaledSprites[icnId][index] );
+
+            _addResidentBytes( icn->scaledFrameBytes[index] );
+        }
+
+        // All frames of the ICN are empty until they are requested.
+        void setEncodedIcn( const int icnId, EncodedIcn && icn )
+        {
+            assert( _sprites[icnId].empty() && !_encodedIcns[icnId] );
+
+            _sprites[icnId].resize( icn.headers.size() );
+
+            icn.isDecoded.resize( icn.headers.size(), false );
+            icn.lruPositions.resize( icn.headers.size(), _lruFrames.end() );
+            icn.lastUsePeriods.resize( icn.headers.size(), 0 );
+            icn.scaledFrameBytes.resize( icn.headers.size(), 0 );
+
+            _encodedIcns[icnId] = std::make_unique<EncodedIcn>( std::move( icn ) );
+        }
+
+        // The limit is applied at the next safe point.
+        void setMemoryLimit( const size_t bytes )
+        {
+            _stats.memoryLimit = bytes;
+        }
+
+        fheroes2::AGG::SpriteMemoryStats getStats() const
+        {
+            fheroes2::AGG::SpriteMemoryStats stats = _stats;
+
+            for ( const std::vector<std::vector<fheroes2::Sprite>> * allSprites : { &_sprites, &_scaledSprites } ) {
+                for ( const std::vector<fheroes2::Sprite> & sprites : *allSprites ) {
+                    for ( const fheroes2::Sprite & sprite : sprites ) {
+                        stats.totalBytes += getSpriteMemorySize( sprite );
+                    }
+                }
+            }
+
+            return stats;
+        }
+
+        // Evicts the least recently used frames until the memory limit is met. Frames requested since the previous call
+        // of this method are never evicted as references to them could still be held by the callers. Nothing is evicted
+        // while the eviction is blocked.
+        void evictFrames()
+        {
+            const uint32_t currentPeriod = _safePointPeriod;
+            ++_safePointPeriod;
+
+            if ( _stats.memoryLimit == 0 || _evictionBlockerCount > 0 ) {
+                return;
+            }
+
+            while ( _stats.residentBytes > _stats.memoryLimit && !_lruFrames.empty() ) {
+                const auto [icnId, index] = _lruFrames.back();
+
+                EncodedIcn * icn = _encodedIcns[icnId].get();
+                assert( icn != nullptr );
+
+                if ( icn->lastUsePeriods[index] == currentPeriod ) {
+                    // This and all more recently used frames are still in use.
+                    break;
+                }
+
+                fheroes2::Sprite & sprite = _sprites[icnId][index];
+
+                _forgetFrame( *icn, index, sprite );
+
+                // The objects themselves must stay in place since references to them could be held by the callers.
+                sprite = fheroes2::Sprite();
+
+                if ( !_scaledSprites[icnId].empty() ) {
+                    _scaledSprites[icnId][index] = fheroes2::Sprite();
+                }
+
+                ++_stats.evictedFrames;
+            }
+        }
+
+        void blockEviction()
+        {
+            ++_evictionBlockerCount;
+        }
+
+        void unblockEviction()
+        {
+            assert( _evictionBlockerCount > 0 );
+
+            --_evictionBlockerCount;
+        }
+
+    private:
+        static void _decodeFrame( const EncodedIcn & icn, const uint32_t index, fheroes2::Sprite & sprite )
+        {
+            const auto [offset, size] = icn.frameDataRanges[index];
+            const uint8_t * data = icn.data + offset;
+
+            sprite = fheroes2::decodeICNSprite( data, data + size, icn.headers[index] );
+        }
+
+        void _decodeAllFrames( const int icnId )
+        {
+            std::unique_ptr<EncodedIcn> & icn = _encodedIcns[icnId];
+            if ( !icn ) {
+                return;
+            }
+
+            std::vector<fheroes2::Sprite> & sprites = _sprites[icnId];
+
+            for ( uint32_t i = 0; i < sprites.size(); ++i ) {
+                if ( icn->isDecoded[i] ) {
+                    _forgetFrame( *icn, i, sprites[i] );
+                }
+                else {
+                    _decodeFrame( *icn, i, sprites[i] );
+                }
+            }
+
+            icn.reset();
+        }
+
+        // Removes the frame from the LRU list and from the statistics. The frame and its scaled copy are not changed.
+        void _forgetFrame( EncodedIcn & icn, const uint32_t index, const fheroes2::Sprite & sprite )
+        {
+            assert( icn.isDecoded[index] );
+
+            _lruFrames.erase( icn.lruPositions[index] );
+            icn.lruPositions[index] = _lruFrames.end();
+            icn.isDecoded[index] = false;
+
+            const size_t frameBytes = getSpriteMemorySize( sprite ) + icn.scaledFrameBytes[index];
+            icn.scaledFrameBytes[index] = 0;
+
+            assert( _stats.residentBytes >= frameBytes && _stats.residentFrames > 0 );
+
+            _stats.residentBytes -= frameBytes;
+            --_stats.residentFrames;
+        }
+
+        void _addResidentBytes( const size_t bytes )
+        {
+            _stats.residentBytes += bytes;
+            _stats.peakResidentBytes = std::max( _stats.peakResidentBytes, _stats.residentBytes );
+        }
+
+        std::vector<std::vector<fheroes2::Sprite>> _sprites;
+
+        // Copies of the frames scaled for the current resolution. Only the scalable ICNs have them.
+        std::vector<std::vector<fheroes2::Sprite>> _scaledSprites;
+
+        // Only the ICNs which still have frames that are decoded on demand are present here.
+        std::vector<std::unique_ptr<EncodedIcn>> _encodedIcns;
+
+        // Frames decoded on demand, the most recently used first.
+        std::list<IcnFrameId> _lruFrames;
+
+        fheroes2::AGG::SpriteMemoryStats _stats;
+
+        // Id of the period between two consecutive safe points.
+        uint32_t _safePointPeriod{ 0 };
+
+        uint32_t _evictionBlockerCount{ 0 };
+
+        // Checksums of the frames of the tracked ICNs at the moment of their first access.
+        std::map<int, uint32_t> _accessedIcnChecksums;
+        bool _isAccessTracked{ false };
+    };
+
+    IcnSpriteStorage _icnVsSprite( ICN::LASTICN );
+
+    // Optional on-disk cache of the ICNs generated or modified by the engine, stored in the H2D format. There is a separate cache file
+    // for every combination of the contents of the AGG files, engine version and language settings, so a stale cache is never used.
+    // Every entry of the cache corresponds to a single top-level ICN loading and contains all the ICNs which have been created by it
+    // (the generation code often creates several ICNs at once) as well as the already loaded ICNs which have been modified by it.
+    // Original ICNs which are used as is are never cached since they are decoded on demand.
+    class SpriteDiskCache
+    {
+    public:
+        void enable( std::string directory, std::string engineVersion )
+        {
+            _directory = std::move( directory );
+            _engineVersion = std::move( engineVersion );
+        }
+
+        bool isEnabled() const
+        {
+            return !_directory.empty();
+        }
+
+        // Language settings affect the generated images, so they are also a part of the cache file key.
+        void setLanguageKey( std::string languageKey )
+        {
+            if ( languageKey == _languageKey ) {
+                return;
+            }
+
+            save();
+
+            _languageKey = std::move( languageKey );
+            _reader.reset();
+        }
+
+        // Restores all ICNs of the cache entry of the given ICN which are not loaded yet. Returns false if there is no such entry.
+        bool load( const int icnId )
+        {
+            if ( !_reader ) {
+                _openReader();
+            }
+
+            const fheroes2::Time timer;
+
+            const std::vector<uint8_t> & data = _reader->getFile( std::to_string( icnId ) );
+            if ( data.empty() ) {
+                return false;
+            }
+
+            std::vector<CachedIcn> icns;
+            if ( !_decodeEntry( data, icns ) ) {
+                DEBUG_LOG( DBG_ENGINE, DBG_WARN, "Corrupted sprite cache entry for ICN " << icnId )
+                return false;
+            }
+
+            if ( std::none_of( icns.begin(), icns.end(), [icnId]( const CachedIcn & icn ) { return icn.icnId == icnId; } ) ) {
+                return false;
+            }
+
+            for ( CachedIcn & icn : icns ) {
+                if ( icn.isModified ) {
+                    // Apply the changes made by the generation code to the already loaded ICN.
+                    _restoreModifiedIcn( icn.icnId, std::move( icn.sprites ) );
+                }
+                else if ( _icnVsSprite.getFrameCount( icn.icnId ) == 0 ) {
+                    _icnVsSprite[icn.icnId] = std::move( icn.sprites );
+                }
+            }
+
+            ++_hitCount;
+            _loadTime += timer.getS();
+
+            return true;
+        }
+
+        void store( const int icnId, const std::vector<int> & createdIcnIds, const std::vector<int> & modifiedIcnIds, const double generationTime )
+        {
+            ++_missCount;
+            _generationTime += generationTime;
+
+            if ( createdIcnIds.empty() && modifiedIcnIds.empty() ) {
+                return;
+            }
+
+            RWStreamBuf stream;
+            stream.putLE32( static_cast<uint32_t>( createdIcnIds.size() + modifiedIcnIds.size() ) );
+
+            for ( const std::vector<int> * icnIds : { &createdIcnIds, &modifiedIcnIds } ) {
+                const bool isModified = ( icnIds == &modifiedIcnIds );
+
+                for ( const int id : *icnIds ) {
+                    const std::vector<fheroes2::Sprite> & sprites = _icnVsSprite[id];
+
+                    stream.putLE32( static_cast<uint32_t>( id ) );
+                    stream.put( isModified ? 1 : 0 );
+                    stream.putLE32( static_cast<uint32_t>( sprites.size() ) );
+
+                    for ( const fheroes2::Sprite & sprite : sprites ) {
+                        _encodeSprite( stream, sprite );
+                    }
+                }
+            }
+
+            _newEntries[std::to_string( icnId )] = stream.getRaw( 0 );
+        }
+
+        // Writes the new entries to the disk together with the existing ones.
+        void save()
+        {
+            if ( _newEntries.empty() ) {
+                return;
+            }
+
+            const std::string filePath = _getFilePath();
+            const std::string tempFilePath = filePath + ".tmp";
+
+            fheroes2::H2DWriter writer;
+
+            // New entries replace the existing ones with the same name.
+            if ( _reader ) {
+                writer.add( *_reader );
+                _reader.reset();
+            }
+
+            for ( const auto & [name, data] : _newEntries ) {
+                writer.add( name, data );
+            }
+
+            _newEntries.clear();
+
+            if ( !System::MakeDirectory( _directory ) && !System::IsDirectory( _directory ) ) {
+                ERROR_LOG( "Unable to create the sprite cache directory " << _directory )
+            }
+            else if ( !writer.write( tempFilePath ) || !System::Rename( tempFilePath, filePath ) ) {
+                ERROR_LOG( "Unable to write the sprite cache file " << filePath )
+
+                System::Unlink( tempFilePath );
+            }
+
+            DEBUG_LOG( DBG_ENGINE, DBG_INFO,
+                       "Sprite cache " << filePath << ": " << _hitCount << " entries loaded in " << _loadTime << " s, " << _missCount << " ICNs generated in "
+                                       << _generationTime << " s" )
+        }
+
+    private:
+        enum SpriteFlags : uint8_t
+        {
+            EMPTY = 0x1,
+            SINGLE_LAYER = 0x2
+        };
+
+        struct CachedIcn
+        {
+            int icnId{ ICN::UNKNOWN };
+            // The ICN had already been loaded before the generation code has modified it.
+            bool isModified{ false };
+            std::vector<fheroes2::Sprite> sprites;
+        };
+
+        // Must be increased on every change of the format of the cache entries.
+        static const uint32_t _formatVersion{ 2 };
+
+        static void _restoreModifiedIcn( const int icnId, std::vector<fheroes2::Sprite> sprites )
+        {
+            std::vector<fheroes2::Sprite> & loadedSprites = _icnVsSprite[icnId];
+
+            if ( loadedSprites.size() != sprites.size() ) {
+                loadedSprites = std::move( sprites );
+                return;
+            }
+
+            // Keep the sprite objects in place since references to them could be held by the callers.
+            std::move( sprites.begin(), sprites.end(), loadedSprites.begin() );
+        }
+
+        std::string _getFilePath() const
+        {
+            std::string key = std::to_string( _formatVersion );
+            key += '|';
+            key += _engineVersion;
+            key += '|';
+            key += std::to_string( ::AGG::getAssetsHash() );
+            key += '|';
+            key += _languageKey;
+
+            const uint32_t hash = fheroes2::calculateCRC32( reinterpret_cast<const uint8_t *>( key.data() ), key.size() );
+
+            return System::concatPath( _directory, "sprites_" + std::to_string( hash ) + ".h2d" );
+        }
+
+        void _openReader()
+        {
+            _reader = std::make_unique<fheroes2::H2DReader>();
+
+            // The cache file does not exist on the first run.
+            _reader->open( _getFilePath() );
+        }
+
+        static void _encodeSprite( RWStreamBuf & stream, const fheroes2::Sprite & sprite )
+        {
+            uint8_t flags = 0;
+            if ( sprite.empty() ) {
+                flags |= EMPTY;
+            }
+            if ( sprite.singleLayer() ) {
+                flags |= SINGLE_LAYER;
+            }
+
+            stream.put( flags );
+            stream.putLE32( static_cast<uint32_t>( sprite.x() ) );
+            stream.putLE32( static_cast<uint32_t>( sprite.y() ) );
+
+            if ( sprite.empty() ) {
+                return;
+            }
+
+            stream.putLE32( static_cast<uint32_t>( sprite.width() ) );
+            stream.putLE32( static_cast<uint32_t>( sprite.height() ) );
+
+            const size_t imageSize = static_cast<size_t>( sprite.width() ) * static_cast<size_t>( sprite.height() );
+
+            stream.putRaw( sprite.image(), imageSize );
+
+            if ( !sprite.singleLayer() ) {
+                stream.putRaw( sprite.transform(), imageSize );
+            }
+        }
+
+        static bool _decodeEntry( const std::vector<uint8_t> & data, std::vector<CachedIcn> & icns )
+        {
+            ROStreamBuf stream( data );
+
+            const uint32_t icnCount = stream.getLE32();
+            if ( icnCount > ICN::LASTICN ) {
+                return false;
+            }
+
+            icns.reserve( icnCount );
+
+            for ( uint32_t i = 0; i < icnCount && !stream.fail(); ++i ) {
+                const uint32_t icnId = stream.getLE32();
+                const uint8_t isModified = stream.get();
+                const uint32_t frameCount = stream.getLE32();
+
+                // Every frame takes at least 9 bytes.
+                if ( icnId == ICN::UNKNOWN || icnId >= ICN::LASTICN || isModified > 1 || frameCount > stream.size() / 9 ) {
+                    return false;
+                }
+
+                CachedIcn & icn = icns.emplace_back();
+                icn.icnId = static_cast<int>( icnId );
+                icn.isModified = ( isModified != 0 );
+                icn.sprites.resize( frameCount );
+
+                for ( fheroes2::Sprite & sprite : icn.sprites ) {
+                    if ( !_decodeSprite( stream, sprite ) ) {
+                        return false;
+                    }
+                }
+            }
+
+            return !stream.fail() && stream.size() == 0;
+        }
+
+        static bool _decodeSprite( ROStreamBuf & stream, fheroes2::Sprite & sprite )
+        {
+            const uint8_t flags = stream.get();
+            const int32_t x = static_cast<int32_t>( stream.getLE32() );
+            const int32_t y = static_cast<int32_t>( stream.getLE32() );
+
+            if ( flags & SINGLE_LAYER ) {
+                sprite._disableTransformLayer();
+            }
+
+            sprite.setPosition( x, y );
+
+            if ( flags & EMPTY ) {
+                return !stream.fail();
+            }
+
+            const int32_t width = static_cast<int32_t>( stream.getLE32() );
+            const int32_t height = static_cast<int32_t>( stream.getLE32() );
+
+            if ( width <= 0 || height <= 0 ) {
+                return false;
+            }
+
+            const size_t imageSize = static_cast<size_t>( width ) * static_cast<size_t>( height );
+            if ( imageSize * ( ( flags & SINGLE_LAYER ) ? 1 : 2 ) > stream.size() ) {
+                return false;
+            }
+
+            sprite.resize( width, height );
+
+            const auto [imageData, imageDataSize] = stream.getRawView( imageSize );
+            std::copy( imageData, imageData + imageDataSize, sprite.image() );
+
+            if ( flags & SINGLE_LAYER ) {
+                return true;
+            }
+
+            const auto [transformData, transformDataSize] = stream.getRawView( imageSize );
+            std::copy( transformData, transformData + transformDataSize, sprite.transform() );
+
+            return true;
+        }
+
+        std::string _directory;
+        std::string _engineVersion;
+        std::string _languageKey;
+
+        std::unique_ptr<fheroes2::H2DReader> _reader;
+        std::map<std::string, std::vector<uint8_t>, std::less<>> _newEntries;
+
+        uint32_t _hitCount{ 0 };
+        uint32_t _missCount{ 0 };
+        double _loadTime{ 0 };
+        double _generationTime{ 0 };
+    };
+
+    SpriteDiskCache spriteDiskCache;
+
+    // Depth of the nested loadICN() calls.
+    int icnLoadingDepth{ 0 };
     std::array<std::vector<std::vector<fheroes2::Image>>, TIL::LASTTIL> _tilVsImage;
     const fheroes2::Sprite errorImage;
 
     const uint32_t headerSize = 6;
 
-    std::map<int, std::vector<fheroes2::Sprite>> _icnVsScaledSprite;
-
     // Some resources are language dependent. These are mostly buttons with a text of them.
     // Once a user changes a language we have to update resources. To do this we need to clear the existing images.
 
@@ -510,8 +1202,8 @@ namespace
 
     void replacePOLAssetWithSW( const int id, const int assetIndex )
     {
-        const std::vector<uint8_t> & body = ::AGG::getDataFromAggFile( ICN::getIcnFileName( id ), true );
-        ROStreamBuf imageStream( body );
+        const auto [bodyData, bodySize] = ::AGG::getDataViewFromAggFile( ICN::getIcnFileName( id ), true );
+        ROStreamBuf imageStream( bodyData, bodySize );
 
         imageStream.seek( headerSize + assetIndex * 13 );
 
@@ -522,26 +1214,26 @@ namespace
         imageStream >> header2;
         const uint32_t dataSize = header2.offsetData - header1.offsetData;
 
-        const uint8_t * data = body.data() + headerSize + header1.offsetData;
+        const uint8_t * data = bodyData + headerSize + header1.offsetData;
         const uint8_t * dataEnd = data + dataSize;
 
         _icnVsSprite[id][assetIndex] = fheroes2::decodeICNSprite( data, dataEnd, header1 );
     }
 
-    // This function returns true if sprites were successfully loaded from AGG file.
+    // This function returns true if sprites were successfully loaded from AGG file. The frames themselves are decoded on demand.
     // WARNING: this function must be called once - only in the beginning of `loadICN()` function.
     bool readIcnFromAgg( const int id )
     {
         // If this assertion blows up then something wrong with your logic and you load resources more than once!
-        assert( _icnVsSprite[id].empty() );
+        assert( _icnVsSprite.getFrameCount( id ) == 0 );
 
-        const std::vector<uint8_t> & body = ::AGG::getDataFromAggFile( ICN::getIcnFileName( id ), false );
+        const auto [bodyData, bodySize] = ::AGG::getDataViewFromAggFile( ICN::getIcnFileName( id ), false );
 
-        if ( body.empty() ) {
+        if ( bodySize == 0 ) {
             return false;
         }
 
-        ROStreamBuf imageStream( body );
+        ROStreamBuf imageStream( bodyData, bodySize );
 
         const uint32_t count = imageStream.getLE16();
         const uint32_t blockSize = imageStream.getLE32();
@@ -549,12 +1241,14 @@ namespace
             return false;
         }
 
-        _icnVsSprite[id].resize( count );
+        EncodedIcn icn;
+        icn.headers.resize( count );
+        icn.frameDataRanges.resize( count );
 
         for ( uint32_t i = 0; i < count; ++i ) {
             imageStream.seek( headerSize + i * 13 );
 
-            fheroes2::ICNHeader header1;
+            fheroes2::ICNHeader & header1 = icn.headers[i];
             imageStream >> header1;
 
             // There should be enough frames for ICNs with animation. When animationFrames is equal to 32 then it is a Monochromatic image
@@ -570,19 +1264,28 @@ namespace
                 dataSize = blockSize - header1.offsetData;
             }
 
-            if ( headerSize + header1.offsetData + dataSize > body.size() ) {
+            if ( headerSize + header1.offsetData + dataSize > bodySize ) {
                 // This is a corrupted AGG file.
                 throw fheroes2::InvalidDataResources( "ICN Id " + std::to_string( id ) + ", index " + std::to_string( i )
                                                       + " is being corrupted. "
                                                         "Make sure that you own an official version of the game." );
             }
 
-            const uint8_t * data = body.data() + headerSize + header1.offsetData;
-            const uint8_t * dataEnd = data + dataSize;
+            icn.frameDataRanges[i] = { headerSize + header1.offsetData, dataSize };
+        }
 
-            _icnVsSprite[id][i] = fheroes2::decodeICNSprite( data, dataEnd, header1 );
+        if ( ::AGG::areDataViewsPersistent() ) {
+            // The data is decoded in place, without copying it from the AGG file.
+            icn.data = bodyData;
+        }
+        else {
+            // The encoded data is still much smaller than the decoded images.
+            icn.ownedData.assign( bodyData, bodyData + bodySize );
+            icn.data = icn.ownedData.data();
         }
 
+        _icnVsSprite.setEncodedIcn( id, std::move( icn ) );
+
         return true;
     }
 
@@ -1430,7 +2133,7 @@ namespace
         }
         case ICN::BUTTONS_NEW_GAME_MENU_GOOD: {
             // Set the size depending on whether PoL assets are present or not, in which case add 4 more for campaign buttons.
-            const bool isPoLPresent = !::AGG::getDataFromAggFile( ICN::getIcnFileName( ICN::X_TRACK1 ), false ).empty();
+            const bool isPoLPresent = ::AGG::getDataViewFromAggFile( ICN::getIcnFileName( ICN::X_TRACK1 ), false ).second > 0;
             if ( isPoLPresent ) {
                 _icnVsSprite[id].resize( 28 );
             }
@@ -1771,7 +2474,7 @@ namespace
     {
         switch ( id ) {
         case ICN::BUTTONS_NEW_GAME_MENU_GOOD: {
-            const bool isPoLPresent = !::AGG::getDataFromAggFile( ICN::getIcnFileName( ICN::X_TRACK1 ), false ).empty();
+            const bool isPoLPresent = ::AGG::getDataViewFromAggFile( ICN::getIcnFileName( ICN::X_TRACK1 ), false ).second > 0;
             if ( isPoLPresent ) {
                 _icnVsSprite[id].resize( 28 );
             }
@@ -1991,7 +2694,7 @@ namespace
     {
         switch ( id ) {
         case ICN::BUTTONS_NEW_GAME_MENU_GOOD: {
-            const bool isPoLPresent = !::AGG::getDataFromAggFile( ICN::getIcnFileName( ICN::X_TRACK1 ), false ).empty();
+            const bool isPoLPresent = ::AGG::getDataViewFromAggFile( ICN::getIcnFileName( ICN::X_TRACK1 ), false ).second > 0;
             if ( isPoLPresent ) {
                 _icnVsSprite[id].resize( 28 );
             }
@@ -2139,7 +2842,7 @@ namespace
     void processICN( const int id )
     {
         // If this assertion blows up then you are calling this function in a recursion. Check your code!
-        assert( id < ICN::LAST_VALID_FILE_ICN || _icnVsSprite[id].empty() );
+        assert( id < ICN::LAST_VALID_FILE_ICN || _icnVsSprite.getFrameCount( id ) == 0 );
 
         switch ( id ) {
         case ICN::ROUTERED:
@@ -2159,8 +2862,8 @@ namespace
                 throw std::logic_error( "The game resources are corrupted. Please use resources from a licensed version of Heroes of Might and Magic II." );
             }
 
-            const std::vector<uint8_t> & body = ::AGG::getDataFromAggFile( ICN::getIcnFileName( id ), false );
-            const uint32_t crc32 = fheroes2::calculateCRC32( body.data(), body.size() );
+            const auto [bodyData, bodySize] = ::AGG::getDataViewFromAggFile( ICN::getIcnFileName( id ), false );
+            const uint32_t crc32 = fheroes2::calculateCRC32( bodyData, bodySize );
 
             if ( id == ICN::SMALFONT ) {
                 // Small font in official Polish GoG version has all letters shifted 1 pixel down.
@@ -3105,7 +3808,7 @@ namespace
 
                 // Since we cannot access game settings from here we are checking an existence
                 // of one of POL resources as an indicator for this version.
-                if ( !::AGG::getDataFromAggFile( ICN::getIcnFileName( ICN::X_TRACK1 ), false ).empty() ) {
+                if ( ::AGG::getDataViewFromAggFile( ICN::getIcnFileName( ICN::X_TRACK1 ), false ).second > 0 ) {
                     fheroes2::Sprite editorIcon;
                     fheroes2::h2d::readImage( "main_menu_editor_icon.image", editorIcon );
 
@@ -5069,13 +5772,8 @@ namespace
         }
     }
 
-    void loadICN( const int id )
+    void generateICN( const int id )
     {
-        if ( !_icnVsSprite[id].empty() ) {
-            // The images have been loaded.
-            return;
-        }
-
         // Some images contain text. This text should be adapted to a chosen language.
         if ( isLanguageDependentIcnId( id ) ) {
             generateLanguageSpecificImages( id );
@@ -5094,18 +5792,72 @@ namespace
         // WARNING: The `processICN()` function must be called only in this place!
         processICN( id );
 
-        if ( _icnVsSprite[id].empty() ) {
+        if ( _icnVsSprite.getFrameCount( id ) == 0 ) {
             // This could happen by one reason: asking to render an ICN that simply doesn't exist within the resources.
             // In order to avoid subsequent attempts to get resources from this ICN we are making it as non-empty.
             _icnVsSprite[id].resize( 1 );
         }
     }
 
+    void loadICN( const int id )
+    {
+        if ( _icnVsSprite.getFrameCount( id ) > 0 ) {
+            // The images have been loaded.
+            return;
+        }
+
+        // Only the top-level loadings are cached since they include all the nested ones.
+        if ( !spriteDiskCache.isEnabled() || icnLoadingDepth > 0 ) {
+            generateICN( id );
+            return;
+        }
+
+        if ( spriteDiskCache.load( id ) ) {
+            return;
+        }
+
+        std::vector<size_t> frameCounts( _icnVsSprite.size() );
+        for ( size_t i = 0; i < frameCounts.size(); ++i ) {
+            frameCounts[i] = _icnVsSprite.getFrameCount( static_cast<int>( i ) );
+        }
+
+        const fheroes2::Time timer;
+
+        _icnVsSprite.startAccessTracking();
+
+        ++icnLoadingDepth;
+        generateICN( id );
+        --icnLoadingDepth;
+
+        const std::vector<int> changedIcnIds = _icnVsSprite.stopAccessTracking();
+
+        const double generationTime = timer.getS();
+
+        std::vector<int> createdIcnIds;
+        for ( size_t i = 0; i < frameCounts.size(); ++i ) {
+            const int icnId = static_cast<int>( i );
+
+            if ( frameCounts[i] == 0 && _icnVsSprite.getFrameCount( icnId ) > 0 && !_icnVsSprite.isEncoded( icnId ) ) {
+                createdIcnIds.push_back( icnId );
+            }
+        }
+
+        // The ICNs which had been loaded before the generation but have been changed by it (e.g. some frames have been fixed).
+        std::vector<int> modifiedIcnIds;
+        for ( const int icnId : changedIcnIds ) {
+            if ( frameCounts[icnId] > 0 ) {
+                modifiedIcnIds.push_back( icnId );
+            }
+        }
+
+        spriteDiskCache.store( id, createdIcnIds, modifiedIcnIds, generationTime );
+    }
+
     size_t GetMaximumICNIndex( int id )
     {
         loadICN( id );
 
-        return _icnVsSprite[id].size();
+        return _icnVsSprite.getFrameCount( id );
     }
 
     size_t GetMaximumTILIndex( const int id )
@@ -5115,24 +5867,24 @@ namespace
         if ( tilImages.empty() ) {
             tilImages.resize( 4 ); // 4 possible sides
 
-            const std::vector<uint8_t> & data = ::AGG::getDataFromAggFile( tilFileName[id], false );
-            if ( data.size() < headerSize ) {
+            const auto [data, dataSize] = ::AGG::getDataViewFromAggFile( tilFileName[id], false );
+            if ( dataSize < headerSize ) {
                 // The important resource is absent! Make sure that you are using the correct version of the game.
                 assert( 0 );
                 return 0;
             }
 
-            ROStreamBuf buffer( data );
+            ROStreamBuf buffer( data, dataSize );
 
             const size_t count = buffer.getLE16();
             const int32_t width = buffer.getLE16();
             const int32_t height = buffer.getLE16();
-            if ( count < 1 || width < 1 || height < 1 || ( headerSize + count * width * height ) != data.size() ) {
+            if ( count < 1 || width < 1 || height < 1 || ( headerSize + count * width * height ) != dataSize ) {
                 return 0;
             }
 
             std::vector<fheroes2::Image> & originalTIL = tilImages[0];
-            decodeTILImages( data.data() + headerSize, count, width, height, originalTIL );
+            decodeTILImages( data + headerSize, count, width, height, originalTIL );
 
             for ( uint32_t shapeId = 1; shapeId < 4; ++shapeId ) {
                 tilImages[shapeId].resize( count );
@@ -5172,18 +5924,14 @@ namespace
 
     const fheroes2::Sprite & GetScaledICN( const int icnId, const uint32_t index )
     {
-        const fheroes2::Sprite & originalIcn = _icnVsSprite[icnId][index];
+        const fheroes2::Sprite & originalIcn = _icnVsSprite.getFrame( icnId, index );
         const fheroes2::Display & display = fheroes2::Display::instance();
 
         if ( display.width() == fheroes2::Display::DEFAULT_WIDTH && display.height() == fheroes2::Display::DEFAULT_HEIGHT ) {
             return originalIcn;
         }
 
-        if ( _icnVsScaledSprite[icnId].empty() ) {
-            _icnVsScaledSprite[icnId].resize( _icnVsSprite[icnId].size() );
-        }
-
-        fheroes2::Sprite & resizedIcn = _icnVsScaledSprite[icnId][index];
+        fheroes2::Sprite & resizedIcn = _icnVsSprite.getScaledFrame( icnId, index );
 
         if ( originalIcn.singleLayer() && !resizedIcn.singleLayer() ) {
             resizedIcn._disableTransformLayer();
@@ -5205,6 +5953,8 @@ namespace
             resizedIcn.setPosition( static_cast<int32_t>( std::lround( originalIcn.x() * scaleFactor ) ) + offsetX,
                                     static_cast<int32_t>( std::lround( originalIcn.y() * scaleFactor ) ) + offsetY );
             Resize( originalIcn, resizedIcn );
+
+            _icnVsSprite.updateScaledFrameMemory( icnId, index );
         }
         else {
             // No need to resize but we have to update the offset.
@@ -5232,7 +5982,7 @@ namespace fheroes2::AGG
             return GetScaledICN( icnId, index );
         }
 
-        return _icnVsSprite[icnId][index];
+        return _icnVsSprite.getFrame( icnId, index );
     }
 
     uint32_t GetICNCount( int icnId )
@@ -5262,6 +6012,41 @@ namespace fheroes2::AGG
         return _tilVsImage[tilId][shapeId][index];
     }
 
+    void enableSpriteDiskCache( std::string directory, std::string engineVersion )
+    {
+        spriteDiskCache.enable( std::move( directory ), std::move( engineVersion ) );
+    }
+
+    void saveSpriteDiskCache()
+    {
+        spriteDiskCache.save();
+    }
+
+    void setSpriteMemoryLimit( const size_t bytes )
+    {
+        _icnVsSprite.setMemoryLimit( bytes );
+    }
+
+    void evictUnusedSprites()
+    {
+        _icnVsSprite.evictFrames();
+    }
+
+    SpriteMemoryStats getSpriteMemoryStats()
+    {
+        return _icnVsSprite.getStats();
+    }
+
+    SpriteEvictionBlocker::SpriteEvictionBlocker()
+    {
+        _icnVsSprite.blockEviction();
+    }
+
+    SpriteEvictionBlocker::~SpriteEvictionBlocker()
+    {
+        _icnVsSprite.unblockEviction();
+    }
+
     void updateLanguageDependentResources( const SupportedLanguage language, const bool loadOriginalAlphabet )
     {
         static bool areOriginalResourcesInUse = false;
@@ -5294,10 +6079,12 @@ namespace fheroes2::AGG
             // Restore original letters when changing language to avoid changes to them being carried over.
             alphabetPreserver.restore();
 
-            generateAlphabet( language, _icnVsSprite );
+            generateAlphabet( language, _icnVsSprite.getAllSprites() );
         }
 
-        generateButtonAlphabet( language, _icnVsSprite );
+        spriteDiskCache.setLanguageKey( std::string( getLanguageAbbreviation( language ) ) + ( loadOriginalResources ? "_original" : "" ) );
+
+        generateButtonAlphabet( language, _icnVsSprite.getAllSprites() );
 
         // Clear language dependent resources.
         for ( const int id : languageDependentIcnId ) {
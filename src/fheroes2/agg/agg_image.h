@@ -20,7 +20,9 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <string>
 
 namespace fheroes2
 {
@@ -31,12 +33,59 @@ namespace fheroes2
 
     namespace AGG
     {
+        struct SpriteMemoryStats
+        {
+            // Memory used by the frames of the original ICNs which are decoded on demand and can be evicted, including their scaled copies.
+            size_t residentBytes{ 0 };
+            size_t peakResidentBytes{ 0 };
+            uint32_t residentFrames{ 0 };
+            uint32_t evictedFrames{ 0 };
+
+            // Memory used by all ICN sprites, including the generated and modified ones.
+            size_t totalBytes{ 0 };
+
+            // 0 means no limit.
+            size_t memoryLimit{ 0 };
+        };
+
+        // The returned sprite object is never destroyed. However, if a memory limit is set, the frames of the original ICNs
+        // which are not modified by the engine can become empty once the screen has been rendered twice without requesting them
+        // (they are decoded again by the next call of this function). The code which uses the returned sprite after rendering
+        // of the screen must either request it again or keep a SpriteEvictionBlocker object alive for this time.
         const Sprite & GetICN( int icnId, uint32_t index );
         uint32_t GetICNCount( int icnId );
 
         // shapeId could be 0, 1, 2 or 3 only
         const Image & GetTIL( int tilId, uint32_t index, uint32_t shapeId );
 
+        // Sets the limit of memory used by the frames which are decoded on demand. The least recently used frames are evicted
+        // by evictUnusedSprites() once this limit is exceeded. 0 means no limit.
+        void setSpriteMemoryLimit( const size_t bytes );
+
+        // Evicts the frames which have not been requested since the previous call of this function if the memory limit is exceeded
+        // and no SpriteEvictionBlocker object exists. It must be called only after rendering of the screen.
+        void evictUnusedSprites();
+
+        SpriteMemoryStats getSpriteMemoryStats();
+
+        // No frames are evicted while at least one object of this class exists.
+        class SpriteEvictionBlocker
+        {
+        public:
+            SpriteEvictionBlocker();
+            SpriteEvictionBlocker( const SpriteEvictionBlocker & ) = delete;
+
+            ~SpriteEvictionBlocker();
+
+            SpriteEvictionBlocker & operator=( const SpriteEvictionBlocker & ) = delete;
+        };
+
+        // Enables the on-disk cache of generated sprites stored in the given directory. The cache files are bound to the given engine version.
+        void enableSpriteDiskCache( std::string directory, std::string engineVersion );
+
+        // Writes all newly generated sprites to the on-disk cache if it is enabled.
+        void saveSpriteDiskCache();
+
         // This function must be called only at the time of setting up a new language.
         void updateLanguageDependentResources( const SupportedLanguage language, const bool loadOriginalAlphabet );
     }
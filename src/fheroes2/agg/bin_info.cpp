@@ -24,6 +24,7 @@
 #include <cstdlib>
 #include <initializer_list>
 #include <map>
+#include <mutex>
 #include <ostream>
 #include <string>
 #include <utility>
@@ -48,11 +49,14 @@ namespace
         return fheroes2::getMonsterData( monsterId ).binFileName;
     }
 
+    // The cache can be accessed by several threads at once when battles are simulated in parallel.
     class MonsterAnimCache
     {
     public:
         Bin_Info::MonsterAnimInfo getAnimInfo( const int monsterID )
         {
+            const std::scoped_lock<std::mutex> lock( _mutex );
+
             auto mapIterator = _animMap.find( monsterID );
             if ( mapIterator != _animMap.end() ) {
                 return mapIterator->second;
@@ -70,6 +74,7 @@ namespace
 
     private:
         std::map<int, Bin_Info::MonsterAnimInfo> _animMap;
+        std::mutex _mutex;
     };
 
     MonsterAnimCache _infoCache;
@@ -47,6 +47,7 @@
 #include "battle_board.h"
 #include "battle_cell.h"
 #include "battle_command.h"
+#include "battle_snapshot.h"
 #include "battle_tower.h"
 #include "battle_troop.h"
 #include "castle.h"
@@ -604,7 +605,8 @@ namespace
 
 AI::BattlePlanner & AI::BattlePlanner::Get()
 {
-    static BattlePlanner ai;
+    // Battles can be simulated in parallel, one battle per thread.
+    thread_local BattlePlanner ai;
     return ai;
 }
 
@@ -1387,7 +1389,16 @@ Battle::Actions AI::BattlePlanner::archerDecision( Battle::Arena & arena, const
     // Archers are blocked and there is nowhere to retreat, they are fighting in melee
     else if ( currentUnit.isHandFighting() ) {
         BattleTargetPair target;
-        int32_t bestOutcome = INT32_MIN;
+        double bestOutcome = std::numeric_limits<double>::lowest();
+
+        // The exchange of blows with every adjacent enemy unit is played out on a copy of the battle state, which takes into account
+        // the killed monsters, the retaliation and the double attacks
+        const Battle::Snapshot snapshot( arena );
+
+        const int32_t currentUnitId = snapshot.getUnitId( currentUnit.GetUID() );
+        assert( currentUnitId != -1 );
+
+        const double myInitialStrength = snapshot.getStrength( _myColor );
 
         for ( const Battle::Unit * enemy : enemies ) {
             assert( enemy != nullptr );
@@ -1399,26 +1410,22 @@ Battle::Actions AI::BattlePlanner::archerDecision( Battle::Arena & arena, const
                 continue;
             }
 
-            const int32_t archerMeleeDmg = [&currentUnit, enemy]() {
-                if ( currentUnit.Modes( Battle::SP_CURSE ) ) {
-                    return currentUnit.CalculateMinDamage( *enemy );
-                }
+            const int32_t enemyId = snapshot.getUnitId( enemy->GetUID() );
+            assert( enemyId != -1 );
 
-                if ( currentUnit.Modes( Battle::SP_BLESS ) ) {
-                    return currentUnit.CalculateMaxDamage( *enemy );
-                }
+            const PlayerColor enemyColor = enemy->GetArmyColor();
 
-                return ( currentUnit.CalculateMinDamage( *enemy ) + currentUnit.CalculateMaxDamage( *enemy ) ) / 2;
-            }();
+            Battle::Snapshot outcome( snapshot );
+            outcome.attack( currentUnitId, enemyId );
 
-            const int32_t retaliatoryDmg = enemy->EstimateRetaliatoryDamage( archerMeleeDmg );
-            const int32_t damageDiff = archerMeleeDmg - retaliatoryDmg;
-            if ( bestOutcome < damageDiff ) {
-                bestOutcome = damageDiff;
+            const double strengthDiff = ( snapshot.getStrength( enemyColor ) - outcome.getStrength( enemyColor ) )
+                                        - ( myInitialStrength - outcome.getStrength( _myColor ) );
+            if ( bestOutcome < strengthDiff ) {
+                bestOutcome = strengthDiff;
 
                 target.unit = enemy;
 
-                DEBUG_LOG( DBG_BATTLE, DBG_TRACE, "- Set melee attack priority on " << enemy->GetName() << ", value: " << damageDiff )
+                DEBUG_LOG( DBG_BATTLE, DBG_TRACE, "- Set melee attack priority on " << enemy->GetName() << ", value: " << strengthDiff )
             }
         }
 
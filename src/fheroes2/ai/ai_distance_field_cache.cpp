@@ -0,0 +1,122 @@
+/***************************************************************************
+ *   fheroes2: https://github.com/ihhub/fheroes2                           *
+ *   Copyright (C) 2025                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "ai_distance_field_cache.h"
+
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+namespace
+{
+    const double strengthBucketsPerDoubling = 16;
+
+    int32_t toThousandths( const double value )
+    {
+        return static_cast<int32_t>( std::lround( value * 1000 ) );
+    }
+}
+
+AI::DistanceFieldCache::DistanceFieldCache( const size_t capacity )
+    : _capacity( capacity )
+{
+    assert( _capacity > 0 );
+}
+
+AI::DistanceFieldCache::Key AI::DistanceFieldCache::makeKey( const int32_t start, const PlayerColor color, const double armyStrength, const uint8_t skill,
+                                                             const double minimalArmyStrengthAdvantage, const double spellPointsReserveRatio )
+{
+    Key key;
+    key.start = start;
+    key.color = color;
+    key.skill = skill;
+    key.minimalArmyStrengthAdvantage = toThousandths( minimalArmyStrengthAdvantage );
+    key.spellPointsReserveRatio = toThousandths( spellPointsReserveRatio );
+
+    // Armies without any strength (or with a very small one) share the lowest bucket.
+    key.strengthBucket = ( armyStrength < 1.0 ) ? -1 : static_cast<int32_t>( std::floor( std::log2( armyStrength ) * strengthBucketsPerDoubling ) );
+
+    return key;
+}
+
+bool AI::DistanceFieldCache::areSettingsMatching( const Key & key, const double minimalArmyStrengthAdvantage, const double spellPointsReserveRatio )
+{
+    return key.minimalArmyStrengthAdvantage == toThousandths( minimalArmyStrengthAdvantage ) && key.spellPointsReserveRatio == toThousandths( spellPointsReserveRatio );
+}
+
+double AI::DistanceFieldCache::getBucketStrength( const int32_t strengthBucket )
+{
+    if ( strengthBucket < 0 ) {
+        return 1.0;
+    }
+
+    return std::exp2( ( strengthBucket + 1 ) / strengthBucketsPerDoubling );
+}
+
+const std::vector<uint32_t> * AI::DistanceFieldCache::find( const Key & key, const uint64_t worldGeneration )
+{
+    const auto iter = _entryLookup.find( key );
+    if ( iter == _entryLookup.end() ) {
+        ++_missCount;
+        return nullptr;
+    }
+
+    if ( iter->second->worldGeneration != worldGeneration ) {
+        // The map has changed since the field was calculated.
+        _entries.erase( iter->second );
+        _entryLookup.erase( iter );
+
+        ++_missCount;
+        return nullptr;
+    }
+
+    ++_hitCount;
+
+    // Move the field to the beginning of the list as the most recently used one.
+    _entries.splice( _entries.begin(), _entries, iter->second );
+
+    return &iter->second->distances;
+}
+
+const std::vector<uint32_t> & AI::DistanceFieldCache::insert( const Key & key, const uint64_t worldGeneration, std::vector<uint32_t> distances )
+{
+    if ( const auto iter = _entryLookup.find( key ); iter != _entryLookup.end() ) {
+        iter->second->worldGeneration = worldGeneration;
+        iter->second->distances = std::move( distances );
+        _entries.splice( _entries.begin(), _entries, iter->second );
+        return iter->second->distances;
+    }
+
+    if ( _entries.size() >= _capacity ) {
+        _entryLookup.erase( _entries.back().key );
+        _entries.pop_back();
+    }
+
+    _entries.push_front( { key, worldGeneration, std::move( distances ) } );
+    _entryLookup.emplace( key, _entries.begin() );
+
+    return _entries.front().distances;
+}
+
+void AI::DistanceFieldCache::clear()
+{
+    _entries.clear();
+    _entryLookup.clear();
+}
@@ -0,0 +1,124 @@
+/***************************************************************************
+ *   fheroes2: https://github.com/ihhub/fheroes2                           *
+ *   Copyright (C) 2025                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "color.h"
+
+namespace AI
+{
+    // LRU cache of the distance fields calculated by the AI pathfinder for armies which are not controlled by the AI itself
+    // (e.g. enemy heroes and castles), so that the same field is not calculated again and again while the map stays the same.
+    // Every field is stored together with the generation of the world changes it was calculated for.
+    class DistanceFieldCache
+    {
+    public:
+        struct Key
+        {
+            int32_t start{ -1 };
+            PlayerColor color{ PlayerColor::NONE };
+            int32_t strengthBucket{ 0 };
+            uint8_t skill{ 0 };
+
+            // Pathfinder settings the field is calculated with, in thousandths. The pathfinder itself does not distinguish smaller differences.
+            int32_t minimalArmyStrengthAdvantage{ 0 };
+            int32_t spellPointsReserveRatio{ 0 };
+
+            bool operator==( const Key & other ) const
+            {
+                return start == other.start && color == other.color && strengthBucket == other.strengthBucket && skill == other.skill
+                       && minimalArmyStrengthAdvantage == other.minimalArmyStrengthAdvantage && spellPointsReserveRatio == other.spellPointsReserveRatio;
+            }
+        };
+
+        explicit DistanceFieldCache( const size_t capacity );
+
+        DistanceFieldCache( const DistanceFieldCache & ) = delete;
+
+        ~DistanceFieldCache() = default;
+
+        DistanceFieldCache & operator=( const DistanceFieldCache & ) = delete;
+
+        // Army strength is split into buckets of about 4.4% (1/16 of the doubling of strength). Armies whose strength falls into the
+        // same bucket share the same distance field.
+        static Key makeKey( const int32_t start, const PlayerColor color, const double armyStrength, const uint8_t skill, const double minimalArmyStrengthAdvantage,
+                            const double spellPointsReserveRatio );
+
+        // Returns true if the pathfinder settings are the same as the ones of the key.
+        static bool areSettingsMatching( const Key & key, const double minimalArmyStrengthAdvantage, const double spellPointsReserveRatio );
+
+        // Returns the highest army strength of the bucket. Distance fields should be calculated using this value, so they never
+        // underestimate how close any army from this bucket can get.
+        static double getBucketStrength( const int32_t strengthBucket );
+
+        // Returns the cached distance field for the given key or nullptr if there is no such field. A field calculated for another
+        // generation of the world changes is outdated, so it is removed and nullptr is returned. The returned pointer remains valid
+        // until the next call of find(), insert() or clear().
+        const std::vector<uint32_t> * find( const Key & key, const uint64_t worldGeneration );
+
+        // Returns the stored field, the reference remains valid as long as the pointer returned by find().
+        const std::vector<uint32_t> & insert( const Key & key, const uint64_t worldGeneration, std::vector<uint32_t> distances );
+
+        // Removes all fields from the cache, but keeps the hit and miss counters.
+        void clear();
+
+        uint64_t getHitCount() const
+        {
+            return _hitCount;
+        }
+
+        uint64_t getMissCount() const
+        {
+            return _missCount;
+        }
+
+    private:
+        struct KeyHasher
+        {
+            size_t operator()( const Key & key ) const
+            {
+                return ( static_cast<size_t>( key.start ) << 24 ) ^ ( static_cast<size_t>( key.strengthBucket ) << 12 ) ^ ( static_cast<size_t>( key.color ) << 4 )
+                       ^ key.skill ^ ( static_cast<size_t>( key.minimalArmyStrengthAdvantage ) << 8 );
+            }
+        };
+
+        struct Entry
+        {
+            Key key;
+            uint64_t worldGeneration{ 0 };
+            std::vector<uint32_t> distances;
+        };
+
+        const size_t _capacity;
+
+        // The most recently used fields are at the beginning of the list.
+        std::list<Entry> _entries;
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHasher> _entryLookup;
+
+        uint64_t _hitCount{ 0 };
+        uint64_t _missCount{ 0 };
+    };
+}
@@ -22,8 +22,10 @@
 
 #include <array>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -35,6 +37,7 @@
 #include "profit.h"
 #include "resource.h"
 #include "route.h"
+#include "thread.h"
 #include "world.h"
 #include "world_pathfinding.h"
 
@@ -47,6 +50,27 @@ AI::Planner & AI::Planner::Get()
 void AI::Planner::resetPathfinder()
 {
     _pathfinder.reset();
+    _threatDistanceFields.clear();
+    _enemyHeroDistanceFields.clear();
+}
+
+void AI::Planner::invalidatePathfinderTile( const int32_t tileIndex )
+{
+    _pathfinder.invalidateTile( tileIndex );
+
+    if ( _worldChangeTrackingSuspensions == 0 ) {
+        ++_worldChangeGeneration;
+    }
+}
+
+MultiThreading::WorkerPool & AI::Planner::getWorkerPool()
+{
+    if ( !_workerPool ) {
+        _workerPool = std::make_unique<MultiThreading::WorkerPool>();
+        _workerPathfinders = std::vector<AIWorldPathfinder>( _workerPool->threadCount() );
+    }
+
+    return *_workerPool;
 }
 
 void AI::Planner::revealFog( const Maps::Tile & tile, const Kingdom & kingdom )
@@ -90,6 +114,39 @@ double AI::Planner::getTileArmyStrength( const Maps::Tile & tile )
     return iter->second;
 }
 
+void AI::Planner::prefillTileArmyStrengthValues()
+{
+    std::vector<int32_t> tileIndexes;
+    tileIndexes.reserve( _mapActionObjects.size() );
+
+    for ( const auto & [tileIndex, objectType] : _mapActionObjects ) {
+        // Heroes and castles are evaluated using their own armies.
+        if ( objectType == MP2::OBJ_HERO || objectType == MP2::OBJ_CASTLE ) {
+            continue;
+        }
+
+        if ( _tileArmyStrengthValues.find( tileIndex ) != _tileArmyStrengthValues.end() ) {
+            continue;
+        }
+
+        tileIndexes.push_back( tileIndex );
+    }
+
+    std::vector<double> strengths( tileIndexes.size(), 0.0 );
+
+    getWorkerPool().parallelFor( tileIndexes.size(), [&tileIndexes, &strengths]( const size_t itemId, const size_t /* threadId */ ) {
+        // Every thread has its own instance of the army.
+        thread_local Army tileArmy;
+        tileArmy.setFromTile( world.getTile( tileIndexes[itemId] ) );
+
+        strengths[itemId] = tileArmy.GetStrength();
+    } );
+
+    for ( size_t i = 0; i < tileIndexes.size(); ++i ) {
+        _tileArmyStrengthValues.try_emplace( tileIndexes[i], strengths[i] );
+    }
+}
+
 double AI::Planner::getResourcePriorityModifier( const int resource, const bool isMine ) const
 {
     // Not all resources are equally valuable: 1 gold does not have the same value as 1 gemstone, so we need to
@@ -23,11 +23,13 @@
 #include <array>
 #include <cassert>
 #include <cstdint>
+#include <memory>
 #include <set>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "ai_distance_field_cache.h"
 #include "resource.h"
 #include "world_pathfinding.h"
 
@@ -54,6 +56,11 @@ namespace Maps
     class Tile;
 }
 
+namespace MultiThreading
+{
+    class WorkerPool;
+}
+
 namespace Skill
 {
     class Secondary;
@@ -174,6 +181,21 @@ namespace AI
         void HeroesActionComplete( Heroes & hero, const int32_t tileIndex, const MP2::MapObjectType objectType );
 
         void resetPathfinder();
+        void invalidatePathfinderTile( const int32_t tileIndex );
+
+        // Changes of the map made between these calls are going to be reverted (e.g. heroes are temporarily removed from the map
+        // for the analysis), so they should not invalidate the cached distance fields. Calls can be nested.
+        void suspendWorldChangeTracking()
+        {
+            ++_worldChangeTrackingSuspensions;
+        }
+
+        void resumeWorldChangeTracking()
+        {
+            assert( _worldChangeTrackingSuspensions > 0 );
+
+            --_worldChangeTrackingSuspensions;
+        }
 
         void revealFog( const Maps::Tile & tile, const Kingdom & kingdom );
 
@@ -205,6 +227,14 @@ namespace AI
 
         bool recruitHero( Castle & castle, bool buyArmy );
 
+        // Scans the part of the map visible to the kingdom of the given color and fills the cache of map action objects,
+        // the list of enemy armies and the region stats. The scan itself is performed in parallel, the results are applied
+        // in the order of tile indexes so they do not depend on the number of threads.
+        void scanMap( const PlayerColor myColor, const bool isUnderViewSpell );
+
+        // Fills the cache of the strength of armies guarding the map action objects using all available threads.
+        void prefillTileArmyStrengthValues();
+
         void evaluateRegionSafety();
 
         std::vector<AICastle> getSortedCastleList( const VecCastles & castles, const std::set<int> & castlesInDanger );
@@ -234,9 +264,18 @@ namespace AI
         void updatePriorityForEnemyArmy( const Kingdom & kingdom, const EnemyArmy & enemyArmy );
         void updatePriorityForCastle( const Castle & castle );
 
+        // Returns the distance from the enemy army to the castle or 0 if the enemy army is too far away to pose a threat. The pathfinder
+        // should be configured by the caller.
+        uint32_t getThreatDistance( const Castle & castle, const EnemyArmy & enemyArmy );
+
         // Return true if the castle is in danger.
         // IMPORTANT!!! Do not call this method directly. Use other methods which call it internally.
         bool updateIndividualPriorityForCastle( const Castle & castle, const EnemyArmy & enemyArmy );
+        bool updateIndividualPriorityForCastle( const Castle & castle, const EnemyArmy & enemyArmy, const uint32_t distance );
+
+        // Returns the worker pool which is used to perform the read-only analysis of the game world. The pool and the pathfinders
+        // for its threads are created on the first call.
+        MultiThreading::WorkerPool & getWorkerPool();
 
         void removePriorityAttackTarget( const int32_t tileIndex );
         void updatePriorityAttackTarget( const Kingdom & kingdom, const Maps::Tile & tile );
@@ -272,5 +311,21 @@ namespace AI
         std::array<BudgetEntry, 7> _budget = { Resource::WOOD, Resource::MERCURY, Resource::ORE, Resource::SULFUR, Resource::CRYSTAL, Resource::GEMS, Resource::GOLD };
 
         AIWorldPathfinder _pathfinder;
+
+        // Distances from the enemy armies to all tiles of the map. They are reused until the map changes.
+        DistanceFieldCache _threatDistanceFields{ 64 };
+
+        // Distances from the enemy heroes to all tiles of the map, used to avoid the tiles threatened by them. They are calculated
+        // for every hero of the kingdom, but remain the same until the map changes.
+        DistanceFieldCache _enemyHeroDistanceFields{ 32 };
+
+        // Increased on every change of the map reported to the planner, so the distance fields calculated before the change are not used anymore.
+        uint64_t _worldChangeGeneration{ 0 };
+        uint32_t _worldChangeTrackingSuspensions{ 0 };
+
+        std::unique_ptr<MultiThreading::WorkerPool> _workerPool;
+
+        // Pathfinders for the read-only analysis, one per thread of the worker pool. They have to be reset before every use.
+        std::vector<AIWorldPathfinder> _workerPathfinders;
     };
 }
@@ -2233,16 +2233,30 @@ int AI::Planner::getPriorityTarget( Heroes & hero, double & maxPriority )
             const bool useRoughEstimate = ( Maps::GetApproximateDistance( hero.GetIndex(), enemyArmy.index ) * Maps::Ground::fastestMovePenalty
                                             > hero.GetMovePoints() + enemyArmyMovePointsThreshold );
 
+            // The same enemy heroes are evaluated for every hero of the kingdom, so their distance fields are cached until the map changes.
+            // Within the same generation of the map changes the hero is uniquely identified by its position and color.
+            const std::vector<uint32_t> * distances = nullptr;
+
             if ( !useRoughEstimate ) {
-                // Pre-cache the pathfinder database for the enemy hero
-                _pathfinder.reEvaluateIfNeeded( *enemyArmy.hero );
+                const Heroes & enemyHero = *enemyArmy.hero;
+                const uint8_t enemyHeroPathfindingSkill = static_cast<uint8_t>( enemyHero.GetLevelSkill( Skill::Secondary::PATHFINDING ) );
+                const DistanceFieldCache::Key key = DistanceFieldCache::makeKey( enemyArmy.index, enemyHero.GetColor(), enemyArmy.strength, enemyHeroPathfindingSkill,
+                                                                                 ARMY_ADVANTAGE_DESPERATE, 0.0 );
+
+                distances = _enemyHeroDistanceFields.find( key, _worldChangeGeneration );
+                if ( distances == nullptr ) {
+                    // Pre-cache the pathfinder database for the enemy hero
+                    _pathfinder.reEvaluateIfNeeded( enemyHero );
+
+                    distances = &_enemyHeroDistanceFields.insert( key, _worldChangeGeneration, _pathfinder.getDistances() );
+                }
             }
 
             for ( size_t i = 0; i < result.size(); ++i ) {
                 const int32_t tileIdx = static_cast<int32_t>( i );
                 assert( Maps::isValidAbsIndex( tileIdx ) );
 
-                const auto [distToTile, isTileConsideredSafe] = [this, enemyArmyIdx = enemyArmy.index, enemyArmyMovePointsThreshold, useRoughEstimate, tileIdx]() {
+                const auto [distToTile, isTileConsideredSafe] = [distances, enemyArmyIdx = enemyArmy.index, enemyArmyMovePointsThreshold, useRoughEstimate, tileIdx]() {
                     // The tile on which the enemy hero is located is always considered unsafe
                     if ( tileIdx == enemyArmyIdx ) {
                         return std::make_pair( static_cast<uint32_t>( 0 ), false );
@@ -2257,7 +2271,9 @@ int AI::Planner::getPriorityTarget( Heroes & hero, double & maxPriority )
                         return std::make_pair( dist, dist > enemyArmyMovePointsThreshold );
                     }
 
-                    const uint32_t dist = _pathfinder.getDistance( tileIdx );
+                    assert( distances != nullptr );
+
+                    const uint32_t dist = ( *distances )[tileIdx];
 
                     // When using an accurate estimate, a tile is considered safe if the enemy hero does not have access to it (in particular, if it is hidden from
                     // him in the fog) or he cannot reach it within one turn. The potential ability of the enemy hero to use spells to move to this tile (for example,
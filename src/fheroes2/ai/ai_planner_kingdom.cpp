@@ -60,12 +60,32 @@
 #include "route.h"
 #include "skill.h"
 #include "spell.h"
+#include "thread.h"
 #include "world.h"
 #include "world_pathfinding.h"
 #include "world_regions.h"
 
 namespace
 {
+    // 30 tiles, roughly how much maxed out hero can move in a turn.
+    const uint32_t threatDistanceLimit = 3000;
+
+    // The result of the analysis of a single map tile visible to the AI kingdom.
+    struct TileScanResult
+    {
+        int32_t index{ -1 };
+        uint32_t regionID{ 0 };
+        MP2::MapObjectType objectType{ MP2::OBJ_NONE };
+
+        // The level of the Wisdom skill of our own non-patrolling hero standing on this tile.
+        std::optional<int> friendlyHeroWisdomLevel;
+
+        bool isFriendlyCastle{ false };
+        bool isEnemyCastle{ false };
+
+        std::optional<AI::EnemyArmy> enemyArmy;
+    };
+
     struct HeroValue
     {
         Heroes * hero = nullptr;
@@ -92,6 +112,9 @@ namespace
 
         explicit TemporaryHeroEraser( const std::vector<Heroes *> & heroes )
         {
+            // Heroes are going to be returned to their places, so the map is not considered as changed.
+            AI::Planner::Get().suspendWorldChangeTracking();
+
             for ( Heroes * hero : heroes ) {
                 assert( hero != nullptr && hero->isActive() );
 
@@ -116,6 +139,8 @@ namespace
 
                 tile.setHero( hero );
             }
+
+            AI::Planner::Get().resumeWorldChangeTracking();
         }
 
         TemporaryHeroEraser & operator=( const TemporaryHeroEraser & ) = delete;
@@ -267,6 +292,35 @@ namespace
 
         return {};
     }
+
+    bool isTooFarToBeThreat( const Castle & castle, const AI::EnemyArmy & enemyArmy )
+    {
+        return Maps::GetApproximateDistance( enemyArmy.index, castle.GetIndex() ) * Maps::Ground::fastestMovePenalty > threatDistanceLimit;
+    }
+
+    AI::DistanceFieldCache::Key getThreatDistanceFieldKey( const PlayerColor castleColor, const AI::EnemyArmy & enemyArmy, const double minimalArmyStrengthAdvantage,
+                                                           const double spellPointsReserveRatio )
+    {
+        // When estimating the distance using the pathfinder, it should be taken into account that although the enemy army may be close to the castle, the castle
+        // may still be invisible to the enemy army due to the fog of war, therefore, it is necessary to use an assessment of the path from the castle owner's point
+        // of view, who obviously sees both the castle and the enemy army at the same time.
+        //
+        // Of course, on the other hand, it may be the other way around - the enemy army may have access to some path that is not yet visible to the castle owner,
+        // but since the castle owner doesn't know about this for sure, using this option smacks of cheating.
+        return AI::DistanceFieldCache::makeKey( enemyArmy.index, castleColor, enemyArmy.strength, Skill::Level::EXPERT, minimalArmyStrengthAdvantage,
+                                                spellPointsReserveRatio );
+    }
+
+    // This function does not modify the game world, so it can be called from multiple threads, each with its own pathfinder.
+    std::vector<uint32_t> calculateThreatDistanceField( AIWorldPathfinder & pathfinder, const AI::DistanceFieldCache::Key & key )
+    {
+        // The pathfinder should be configured by the caller according to the key.
+        assert( AI::DistanceFieldCache::areSettingsMatching( key, pathfinder.getMinimalArmyStrengthAdvantage(), pathfinder.getSpellPointsReserveRatio() ) );
+
+        pathfinder.reEvaluateIfNeeded( key.start, key.color, AI::DistanceFieldCache::getBucketStrength( key.strengthBucket ), key.skill );
+
+        return pathfinder.getDistances();
+    }
 }
 
 bool AI::Planner::recruitHero( Castle & castle, bool buyArmy )
@@ -319,6 +373,108 @@ bool AI::Planner::recruitHero( Castle & castle, bool buyArmy )
     return true;
 }
 
+void AI::Planner::scanMap( const PlayerColor myColor, const bool isUnderViewSpell )
+{
+    const int32_t width = world.w();
+    const size_t regionCount = _regions.size();
+
+    // Every row of the map is analyzed separately, the results are merged afterwards in the order of rows.
+    std::vector<std::vector<TileScanResult>> rowResults( static_cast<size_t>( world.h() ) );
+
+    getWorkerPool().parallelFor( rowResults.size(), [&rowResults, width, regionCount, myColor, isUnderViewSpell]( const size_t rowId, const size_t /* threadId */ ) {
+        std::vector<TileScanResult> & results = rowResults[rowId];
+
+        const int32_t rowStart = static_cast<int32_t>( rowId ) * width;
+
+        for ( int32_t idx = rowStart; idx < rowStart + width; ++idx ) {
+            const Maps::Tile & tile = world.getTile( idx );
+            MP2::MapObjectType objectType = tile.getMainObjectType();
+
+            const uint32_t regionID = tile.GetRegion();
+            if ( regionID >= regionCount ) {
+                assert( 0 );
+                continue;
+            }
+
+            if ( !isUnderViewSpell && tile.isFog( myColor ) ) {
+                continue;
+            }
+
+            if ( !MP2::isInGameActionObject( objectType ) ) {
+                continue;
+            }
+
+            TileScanResult & result = results.emplace_back();
+            result.index = idx;
+            result.regionID = regionID;
+            result.objectType = objectType;
+
+            if ( objectType == MP2::OBJ_HERO ) {
+                const Heroes * hero = tile.getHero();
+                assert( hero != nullptr );
+
+                if ( hero->GetColor() == myColor && !hero->Modes( Heroes::PATROL ) ) {
+                    result.friendlyHeroWisdomLevel = hero->GetLevelSkill( Skill::Secondary::WISDOM );
+                }
+
+                // This hero can be in a castle
+                objectType = tile.getMainObjectType( false );
+            }
+
+            if ( objectType == MP2::OBJ_CASTLE ) {
+                const Castle * castle = world.getCastleEntrance( Maps::GetPoint( idx ) );
+                assert( castle != nullptr );
+
+                if ( castle->isFriends( myColor ) ) {
+                    result.isFriendlyCastle = true;
+                }
+                else if ( castle->GetColor() != PlayerColor::NONE ) {
+                    result.isEnemyCastle = true;
+                }
+            }
+
+            result.enemyArmy = getEnemyArmyOnTile( myColor, tile );
+        }
+    } );
+
+    for ( const std::vector<TileScanResult> & results : rowResults ) {
+        for ( const TileScanResult & result : results ) {
+            if ( const auto [dummy, inserted] = _mapActionObjects.try_emplace( result.index, result.objectType ); !inserted ) {
+                assert( 0 );
+            }
+
+            RegionStats & stats = _regions[result.regionID];
+
+            if ( result.friendlyHeroWisdomLevel ) {
+                ++stats.friendlyHeroes;
+
+                if ( *result.friendlyHeroWisdomLevel + 2 > stats.spellLevel ) {
+                    stats.spellLevel = *result.friendlyHeroWisdomLevel + 2;
+                }
+            }
+
+            if ( result.isFriendlyCastle ) {
+                ++stats.friendlyCastles;
+            }
+            else if ( result.isEnemyCastle ) {
+                ++stats.enemyCastles;
+            }
+
+            if ( result.enemyArmy ) {
+                assert( result.enemyArmy->index == result.index );
+
+                if ( const auto [dummy, inserted] = _enemyArmies.try_emplace( result.index, *result.enemyArmy ); !inserted ) {
+                    assert( 0 );
+                }
+
+                if ( stats.highestThreat < result.enemyArmy->strength ) {
+                    stats.highestThreat = result.enemyArmy->strength;
+                }
+            }
+        }
+    }
+}
+
 void AI::Planner::evaluateRegionSafety()
 {
     std::vector<std::pair<size_t, int>> regionsToCheck;
@@ -431,25 +587,103 @@ std::set<int> AI::Planner::findCastlesInDanger( const Kingdom & kingdom )
 {
     std::set<int> castlesInDanger;
 
+    const VecCastles & castles = kingdom.GetCastles();
+    if ( castles.empty() || _enemyArmies.empty() ) {
+        return castlesInDanger;
+    }
+
     // Since we are estimating danger for a castle and we need to know if an enemy hero can reach it
     // if no our heroes exist. So we are temporary removing them from the map.
     const TemporaryHeroEraser heroEraser( kingdom.GetHeroes() );
 
-    const AIWorldPathfinderStateRestorer pathfinderStateRestorer( _pathfinder );
-
-    // Use the "optimistic" pathfinder settings for enemy armies - minimal army advantage, minimal reserve of spell points
-    _pathfinder.setMinimalArmyStrengthAdvantage( ARMY_ADVANTAGE_DESPERATE );
-    _pathfinder.setSpellPointsReserveRatio( 0.0 );
+    std::vector<const EnemyArmy *> enemyArmies;
+    enemyArmies.reserve( _enemyArmies.size() );
 
     for ( const auto & [dummy, enemyArmy] : _enemyArmies ) {
-        for ( const Castle * castle : kingdom.GetCastles() ) {
+        enemyArmies.push_back( &enemyArmy );
+    }
+
+    const PlayerColor kingdomColor = kingdom.GetColor();
+    const size_t castleCount = castles.size();
+
+    // Distances from every enemy army to every castle. Zero distance means that the enemy army is not a threat to the castle.
+    std::vector<uint32_t> distances( enemyArmies.size() * castleCount, 0 );
+
+    const auto fillDistances = [&castles, &enemyArmies, &distances, castleCount]( const size_t armyId, const std::vector<uint32_t> & distanceField ) {
+        for ( size_t castleId = 0; castleId < castleCount; ++castleId ) {
+            const Castle * castle = castles[castleId];
+            if ( castle == nullptr || isTooFarToBeThreat( *castle, *enemyArmies[armyId] ) ) {
+                continue;
+            }
+
+            distances[armyId * castleCount + castleId] = distanceField[castle->GetIndex()];
+        }
+    };
+
+    // Distance fields that are not cached yet and the enemy armies they are needed for.
+    std::vector<DistanceFieldCache::Key> missingFieldKeys;
+    std::vector<size_t> missingFieldArmyIds;
+
+    for ( size_t armyId = 0; armyId < enemyArmies.size(); ++armyId ) {
+        const EnemyArmy & enemyArmy = *enemyArmies[armyId];
+
+        // Skip precise distance check if army is too far to be a threat
+        if ( std::all_of( castles.begin(), castles.end(),
+                          [&enemyArmy]( const Castle * castle ) { return castle == nullptr || isTooFarToBeThreat( *castle, enemyArmy ); } ) ) {
+            continue;
+        }
+
+        // Use the "optimistic" pathfinder settings for enemy armies - minimal army advantage, minimal reserve of spell points
+        const DistanceFieldCache::Key key = getThreatDistanceFieldKey( kingdomColor, enemyArmy, ARMY_ADVANTAGE_DESPERATE, 0.0 );
+
+        if ( const std::vector<uint32_t> * distanceField = _threatDistanceFields.find( key, _worldChangeGeneration ); distanceField != nullptr ) {
+            fillDistances( armyId, *distanceField );
+            continue;
+        }
+
+        missingFieldKeys.push_back( key );
+        missingFieldArmyIds.push_back( armyId );
+    }
+
+    if ( !missingFieldKeys.empty() ) {
+        MultiThreading::WorkerPool & workerPool = getWorkerPool();
+
+        for ( AIWorldPathfinder & pathfinder : _workerPathfinders ) {
+            // The game world might have changed since the last use of this pathfinder.
+            pathfinder.reset();
+
+            // Settings must match the keys of the missing distance fields.
+            pathfinder.setMinimalArmyStrengthAdvantage( ARMY_ADVANTAGE_DESPERATE );
+            pathfinder.setSpellPointsReserveRatio( 0.0 );
+        }
+
+        // Missing distance fields are calculated in parallel.
+        std::vector<std::vector<uint32_t>> missingFields( missingFieldKeys.size() );
+
+        workerPool.parallelFor( missingFieldKeys.size(), [this, &missingFieldKeys, &missingFields]( const size_t fieldId, const size_t threadId ) {
+            assert( threadId < _workerPathfinders.size() );
+
+            missingFields[fieldId] = calculateThreatDistanceField( _workerPathfinders[threadId], missingFieldKeys[fieldId] );
+        } );
+
+        for ( size_t fieldId = 0; fieldId < missingFieldKeys.size(); ++fieldId ) {
+            fillDistances( missingFieldArmyIds[fieldId], missingFields[fieldId] );
+
+            _threatDistanceFields.insert( missingFieldKeys[fieldId], _worldChangeGeneration, std::move( missingFields[fieldId] ) );
+        }
+    }
+
+    // Priority targets are updated on this thread in the same order as the enemy armies are stored.
+    for ( size_t armyId = 0; armyId < enemyArmies.size(); ++armyId ) {
+        for ( size_t castleId = 0; castleId < castleCount; ++castleId ) {
+            const Castle * castle = castles[castleId];
             if ( castle == nullptr ) {
                 // How is it even possible? Check the logic!
                 assert( 0 );
                 continue;
             }
 
-            if ( updateIndividualPriorityForCastle( *castle, enemyArmy ) ) {
+            if ( updateIndividualPriorityForCastle( *castle, *enemyArmies[armyId], distances[armyId * castleCount + castleId] ) ) {
                 castlesInDanger.insert( castle->GetIndex() );
             }
         }
@@ -498,30 +732,42 @@ void AI::Planner::updatePriorityForCastle( const Castle & castle )
     }
 }
 
-bool AI::Planner::updateIndividualPriorityForCastle( const Castle & castle, const EnemyArmy & enemyArmy )
+uint32_t AI::Planner::getThreatDistance( const Castle & castle, const EnemyArmy & enemyArmy )
 {
-    // 30 tiles, roughly how much maxed out hero can move in a turn.
-    const uint32_t threatDistanceLimit = 3000;
+    // Skip precise distance check if army is too far to be a threat
+    if ( isTooFarToBeThreat( castle, enemyArmy ) ) {
+        return 0;
+    }
 
-    const int32_t castleIndex = castle.GetIndex();
+    const DistanceFieldCache::Key key
+        = getThreatDistanceFieldKey( castle.GetColor(), enemyArmy, _pathfinder.getMinimalArmyStrengthAdvantage(), _pathfinder.getSpellPointsReserveRatio() );
 
-    // Skip precise distance check if army is too far to be a threat
-    if ( Maps::GetApproximateDistance( enemyArmy.index, castleIndex ) * Maps::Ground::fastestMovePenalty > threatDistanceLimit ) {
-        return false;
+    if ( const std::vector<uint32_t> * distanceField = _threatDistanceFields.find( key, _worldChangeGeneration ); distanceField != nullptr ) {
+        return ( *distanceField )[castle.GetIndex()];
     }
 
-    // When estimating the distance using the pathfinder, it should be taken into account that although the enemy army may be close to the castle, the castle
-    // may still be invisible to the enemy army due to the fog of war, therefore, it is necessary to use an assessment of the path from the castle owner's point
-    // of view, who obviously sees both the castle and the enemy army at the same time.
-    //
-    // Of course, on the other hand, it may be the other way around - the enemy army may have access to some path that is not yet visible to the castle owner,
-    // but since the castle owner doesn't know about this for sure, using this option smacks of cheating.
-    const uint32_t dist = _pathfinder.getDistance( enemyArmy.index, castleIndex, castle.GetColor(), enemyArmy.strength );
-    if ( dist == 0 || dist >= threatDistanceLimit ) {
+    std::vector<uint32_t> distanceField = calculateThreatDistanceField( _pathfinder, key );
+    const uint32_t distance = distanceField[castle.GetIndex()];
+
+    _threatDistanceFields.insert( key, _worldChangeGeneration, std::move( distanceField ) );
+
+    return distance;
+}
+
+bool AI::Planner::updateIndividualPriorityForCastle( const Castle & castle, const EnemyArmy & enemyArmy )
+{
+    return updateIndividualPriorityForCastle( castle, enemyArmy, getThreatDistance( castle, enemyArmy ) );
+}
+
+bool AI::Planner::updateIndividualPriorityForCastle( const Castle & castle, const EnemyArmy & enemyArmy, const uint32_t distance )
+{
+    if ( distance == 0 || distance >= threatDistanceLimit ) {
         return false;
     }
 
-    uint32_t daysToReach = ( dist + enemyArmy.movePoints - 1 ) / enemyArmy.movePoints;
+    const int32_t castleIndex = castle.GetIndex();
+
+    uint32_t daysToReach = ( distance + enemyArmy.movePoints - 1 ) / enemyArmy.movePoints;
     if ( daysToReach > 3 ) {
         // It is too far away. Ignore it.
         return false;
@@ -654,6 +900,10 @@ fheroes2::GameMode AI::Planner::KingdomTurn( Kingdom & kingdom )
     _priorityTargets.clear();
     _enemyArmies.clear();
 
+    // Not all changes made since the last turn (like the growth of monsters) are reported to the planner
+    _threatDistanceFields.clear();
+    _enemyHeroDistanceFields.clear();
+
     // Clear the tile army strength cache because the strength of the respective armies might have changed since last time
     _tileArmyStrengthValues.clear();
 
@@ -712,76 +962,12 @@ fheroes2::GameMode AI::Planner::KingdomTurn( Kingdom & kingdom )
         return true;
     }();
 
-    const int mapSize = world.w() * world.h();
-
-    for ( int idx = 0; idx < mapSize; ++idx ) {
-        const Maps::Tile & tile = world.getTile( idx );
-        MP2::MapObjectType objectType = tile.getMainObjectType();
-
-        const uint32_t regionID = tile.GetRegion();
-        if ( regionID >= _regions.size() ) {
-            assert( 0 );
-            continue;
-        }
-
-        RegionStats & stats = _regions[regionID];
-        if ( !isUnderViewSpell && tile.isFog( myColor ) ) {
-            continue;
-        }
-
-        if ( !MP2::isInGameActionObject( objectType ) ) {
-            continue;
-        }
-
-        if ( const auto [dummy, inserted] = _mapActionObjects.try_emplace( idx, objectType ); !inserted ) {
-            assert( 0 );
-        }
-
-        if ( objectType == MP2::OBJ_HERO ) {
-            const Heroes * hero = tile.getHero();
-            assert( hero != nullptr );
-
-            if ( hero->GetColor() == myColor && !hero->Modes( Heroes::PATROL ) ) {
-                ++stats.friendlyHeroes;
-
-                const int wisdomLevel = hero->GetLevelSkill( Skill::Secondary::WISDOM );
-                if ( wisdomLevel + 2 > stats.spellLevel ) {
-                    stats.spellLevel = wisdomLevel + 2;
-                }
-            }
-
-            // This hero can be in a castle
-            objectType = tile.getMainObjectType( false );
-        }
-
-        if ( objectType == MP2::OBJ_CASTLE ) {
-            const Castle * castle = world.getCastleEntrance( Maps::GetPoint( idx ) );
-            assert( castle != nullptr );
-
-            if ( castle->isFriends( myColor ) ) {
-                ++stats.friendlyCastles;
-            }
-            else if ( castle->GetColor() != PlayerColor::NONE ) {
-                ++stats.enemyCastles;
-            }
-        }
-
-        const auto enemyArmy = getEnemyArmyOnTile( myColor, tile );
-        if ( enemyArmy ) {
-            assert( enemyArmy->index == idx );
-
-            if ( const auto [dummy, inserted] = _enemyArmies.try_emplace( idx, *enemyArmy ); !inserted ) {
-                assert( 0 );
-            }
-
-            if ( stats.highestThreat < enemyArmy->strength ) {
-                stats.highestThreat = enemyArmy->strength;
-            }
-        }
-    }
+    scanMap( myColor, isUnderViewSpell );
 
     DEBUG_LOG( DBG_AI, DBG_TRACE, Color::String( myColor ) << " found " << _mapActionObjects.size() << " valid objects" )
 
+    prefillTileArmyStrengthValues();
+
     evaluateRegionSafety();
 
     updateKingdomBudget( kingdom );
@@ -922,6 +1108,13 @@ fheroes2::GameMode AI::Planner::KingdomTurn( Kingdom & kingdom )
 
     status.resetAITurnProgress();
 
+    DEBUG_LOG( DBG_AI, DBG_INFO,
+               Color::String( myColor ) << " threat distance field cache: " << _threatDistanceFields.getHitCount() << " hits, "
+                                        << _threatDistanceFields.getMissCount() << " misses in total" )
+    DEBUG_LOG( DBG_AI, DBG_INFO,
+               Color::String( myColor ) << " enemy hero distance field cache: " << _enemyHeroDistanceFields.getHitCount() << " hits, "
+                                        << _enemyHeroDistanceFields.getMissCount() << " misses in total" )
+
     return fheroes2::GameMode::END_TURN;
 }
 
@@ -190,16 +190,17 @@ namespace
     };
 
     std::vector<uint8_t> getDataFromAggFile( const std::string & key, const bool ignoreExpansion );
+    std::pair<const uint8_t *, size_t> getDataViewFromAggFile( const std::string & key, const bool ignoreExpansion );
 
     void LoadWAV( int m82, std::vector<uint8_t> & v )
     {
         DEBUG_LOG( DBG_GAME, DBG_TRACE, M82::GetString( m82 ) )
-        const std::vector<uint8_t> & body = getDataFromAggFile( M82::GetString( m82 ), false );
+        const auto [bodyData, bodySize] = getDataViewFromAggFile( M82::GetString( m82 ), false );
 
-        if ( !body.empty() ) {
+        if ( bodySize > 0 ) {
             RWStreamBuf wavHeader( 44 );
             wavHeader.putLE32( 0x46464952 ); // RIFF marker ("RIFF")
-            wavHeader.putLE32( static_cast<uint32_t>( body.size() ) + 0x24 ); // Total size minus the size of this and previous fields
+            wavHeader.putLE32( static_cast<uint32_t>( bodySize ) + 0x24 ); // Total size minus the size of this and previous fields
             wavHeader.putLE32( 0x45564157 ); // File type header ("WAVE")
             wavHeader.putLE32( 0x20746D66 ); // Format sub-chunk marker ("fmt ")
             wavHeader.putLE32( 0x10 ); // Size of the format sub-chunk
@@ -210,11 +211,11 @@ namespace
             wavHeader.putLE16( 0x01 ); // Block align (BitsPerSample * NumberOfChannels) / 8
             wavHeader.putLE16( 0x08 ); // Bits per sample
             wavHeader.putLE32( 0x61746164 ); // Data sub-chunk marker ("data")
-            wavHeader.putLE32( static_cast<uint32_t>( body.size() ) ); // Size of the data sub-chunk
+            wavHeader.putLE32( static_cast<uint32_t>( bodySize ) ); // Size of the data sub-chunk
 
-            v.reserve( body.size() + 44 );
+            v.reserve( bodySize + 44 );
             v.assign( wavHeader.data(), wavHeader.data() + 44 );
-            v.insert( v.begin() + 44, body.begin(), body.end() );
+            v.insert( v.end(), bodyData, bodyData + bodySize );
         }
     }
 
@@ -505,6 +506,18 @@ namespace
         return g_midiHeroes2AGG.read( key );
     }
 
+    std::pair<const uint8_t *, size_t> getDataViewFromAggFile( const std::string & key, const bool ignoreExpansion )
+    {
+        if ( !ignoreExpansion && g_midiHeroes2xAGG.isGood() ) {
+            const std::pair<const uint8_t *, size_t> view = g_midiHeroes2xAGG.readView( key );
+            if ( view.second > 0 ) {
+                return view;
+            }
+        }
+
+        return g_midiHeroes2AGG.readView( key );
+    }
+
     AsyncSoundManager g_asyncSoundManager;
 
     int PlaySoundImpl( const int m82 )
@@ -71,7 +71,8 @@
 
 namespace
 {
-    Battle::Arena * arena = nullptr;
+    // Every thread has its own current arena so that several battles without interface can be simulated in parallel.
+    thread_local Battle::Arena * arena = nullptr;
 
     template <typename T>
     Battle::Unit * getLastResurrectableUnitFromGraveyardTmpl( const Battle::Graveyard & graveyard, const HeroBase * commander, const int32_t index, const T & spells )
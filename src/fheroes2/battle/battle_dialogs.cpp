@@ -895,6 +895,8 @@ int Battle::Arena::DialogBattleHero( HeroBase & hero, const bool buttons, Status
 
     const PlayerColor currentColor = GetCurrentColor();
     const bool readonly = ( currentColor != hero.GetColor() || !buttons );
+    // The dialog sprite is used until the dialog is closed.
+    const fheroes2::AGG::SpriteEvictionBlocker spriteEvictionBlocker;
     const fheroes2::Sprite & dialog = fheroes2::AGG::GetICN( ( conf.isEvilInterfaceEnabled() ? ICN::VGENBKGE : ICN::VGENBKG ), 0 );
 
     const fheroes2::Point dialogShadow( 15, 15 );
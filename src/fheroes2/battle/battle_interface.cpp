@@ -5348,6 +5348,8 @@ void Battle::Interface::_redrawActionTeleportSpell( Unit & target, const int32_t
     // Hide the counter.
     target.SwitchAnimation( Monster_Info::STAND_STILL );
 
+    // The unit sprite is used during the whole animation.
+    const fheroes2::AGG::SpriteEvictionBlocker spriteEvictionBlocker;
     const fheroes2::Sprite & unitSprite = fheroes2::AGG::GetICN( target.GetMonsterSprite(), target.GetFrame() );
     fheroes2::Sprite rippleSprite;
     _spriteInsteadCurrentUnit = &rippleSprite;
@@ -5697,6 +5699,8 @@ void Battle::Interface::_redrawActionBloodLustSpell( const Unit & target )
 {
     LocalEvent & le = LocalEvent::Get();
 
+    // The unit sprite is used during the whole animation.
+    const fheroes2::AGG::SpriteEvictionBlocker spriteEvictionBlocker;
     const fheroes2::Sprite & unitSprite = fheroes2::AGG::GetICN( target.GetMonsterSprite(), target.GetFrame() );
 
     fheroes2::Sprite bloodlustEffect( unitSprite );
@@ -5742,6 +5746,8 @@ void Battle::Interface::_redrawActionStoneSpell( const Unit & target )
 {
     LocalEvent & le = LocalEvent::Get();
 
+    // The unit sprite is used during the whole animation.
+    const fheroes2::AGG::SpriteEvictionBlocker spriteEvictionBlocker;
     const fheroes2::Sprite & unitSprite = fheroes2::AGG::GetICN( target.GetMonsterSprite(), target.GetFrame() );
 
     fheroes2::Sprite stoneEffect( unitSprite );
@@ -5864,7 +5870,8 @@ void Battle::Interface::_redrawActionDisruptingRaySpell( Unit & target )
     // Hide the counter.
     target.SwitchAnimation( Monster_Info::STAND_STILL );
 
-    // Part 2 - ripple effect
+    // Part 2 - ripple effect. The unit sprite is used during the whole animation.
+    const fheroes2::AGG::SpriteEvictionBlocker spriteEvictionBlocker;
     const fheroes2::Sprite & unitSprite = fheroes2::AGG::GetICN( target.GetMonsterSprite(), target.GetFrame() );
     fheroes2::Sprite rippleSprite;
     _spriteInsteadCurrentUnit = &rippleSprite;
@@ -42,6 +42,76 @@ namespace
 
 namespace Battle
 {
+    size_t BattlePathfinder::getCacheSlot( const BattleNodeIndex & index )
+    {
+        const auto [headCellIdx, tailCellIdx] = index;
+        assert( Board::isValidIndex( headCellIdx ) );
+
+        if ( tailCellIdx == -1 ) {
+            return static_cast<size_t>( headCellIdx ) * nodesPerCell;
+        }
+
+        assert( tailCellIdx == headCellIdx - 1 || tailCellIdx == headCellIdx + 1 );
+
+        return static_cast<size_t>( headCellIdx ) * nodesPerCell + ( tailCellIdx < headCellIdx ? 1 : 2 );
+    }
+
+    BattleNodeIndex BattlePathfinder::getNodeIndex( const size_t slot )
+    {
+        assert( slot < Board::sizeInCells * nodesPerCell );
+
+        const int32_t headCellIdx = static_cast<int32_t>( slot / nodesPerCell );
+
+        switch ( slot % nodesPerCell ) {
+        case 0:
+            return { headCellIdx, -1 };
+        case 1:
+            return { headCellIdx, headCellIdx - 1 };
+        case 2:
+            return { headCellIdx, headCellIdx + 1 };
+        default:
+            assert( 0 );
+            break;
+        }
+
+        return { -1, -1 };
+    }
+
+    void BattlePathfinder::clearCache()
+    {
+        ++_cacheGeneration;
+
+        // The generation counter has wrapped around, nodes of some very old generation could be mistaken for the nodes of the current one
+        if ( _cacheGeneration == 0 ) {
+            for ( BattleNode & node : _cache ) {
+                node._generation = 0;
+            }
+
+            _cacheGeneration = 1;
+        }
+    }
+
+    const BattleNode * BattlePathfinder::findNode( const BattleNodeIndex & index ) const
+    {
+        const BattleNode & node = _cache[getCacheSlot( index )];
+
+        return node._generation == _cacheGeneration ? &node : nullptr;
+    }
+
+    std::pair<BattleNode &, bool> BattlePathfinder::tryAddNode( const BattleNodeIndex & index )
+    {
+        BattleNode & node = _cache[getCacheSlot( index )];
+
+        if ( node._generation == _cacheGeneration ) {
+            return { node, false };
+        }
+
+        node = {};
+        node._generation = _cacheGeneration;
+
+        return { node, true };
+    }
+
     void BattlePathfinder::reEvaluateIfNeeded( const Unit & unit )
     {
         assert( unit.GetHeadIndex() != -1 && ( unit.isWide() ? unit.GetTailIndex() != -1 : unit.GetTailIndex() == -1 ) );
@@ -73,8 +143,8 @@ namespace Battle
         const Castle * castle = Arena::GetCastle();
         const bool isMoatBuilt = castle && castle->isBuild( BUILD_MOAT );
 
-        _cache.clear();
-        _cache.try_emplace( _pathStart );
+        clearCache();
+        tryAddNode( _pathStart );
 
         // Flying units can land wherever they can fit
         if ( _isFlying ) {
@@ -90,12 +160,12 @@ namespace Battle
                 const int32_t headCellIdx = pos.GetHead()->GetIndex();
                 const int32_t tailCellIdx = pos.GetTail() ? pos.GetTail()->GetIndex() : -1;
 
-                if ( const auto [iter, inserted] = _cache.try_emplace( { headCellIdx, tailCellIdx } ); inserted ) {
+                if ( auto [node, inserted] = tryAddNode( { headCellIdx, tailCellIdx } ); inserted ) {
                     // Wide units can occupy overlapping positions, the distance between which is actually zero,
                     // but since the movement takes place, we will consider the distance equal to 1 in this case
                     const uint32_t distance = std::max( Board::GetDistance( unit.GetPosition(), pos ), 1U );
 
-                    iter->second.update( _pathStart, 1, distance );
+                    node.update( _pathStart, 1, distance );
                 }
             }
 
@@ -132,7 +202,8 @@ namespace Battle
 
         for ( size_t nodesToExploreIdx = 0; nodesToExploreIdx < nodesToExplore.size(); ++nodesToExploreIdx ) {
             const BattleNodeIndex currentNodeIdx = nodesToExplore[nodesToExploreIdx];
-            const BattleNode & currentNode = _cache[currentNodeIdx];
+            const BattleNode & currentNode = _cache[getCacheSlot( currentNodeIdx )];
+            assert( currentNode._generation == _cacheGeneration );
 
             if ( _isWide ) {
                 assert( currentNodeIdx.first != -1 && currentNodeIdx.second != -1 );
@@ -169,7 +240,7 @@ namespace Battle
                     const uint32_t cost = currentNode._cost + ( newNodeIdx == flippedCurrentNodeIdx ? 0 : movementPenalty );
                     const uint32_t distance = currentNode._distance + ( newNodeIdx == flippedCurrentNodeIdx ? 0 : 1 );
 
-                    BattleNode & newNode = _cache[newNodeIdx];
+                    BattleNode & newNode = tryAddNode( newNodeIdx ).first;
                     if ( newNode._from == BattleNodeIndex{ -1, -1 } || newNode._cost > cost ) {
                         newNode.update( currentNodeIdx, cost, distance );
 
@@ -206,7 +277,7 @@ namespace Battle
                     const uint32_t cost = currentNode._cost + movementPenalty;
                     const uint32_t distance = currentNode._distance + 1;
 
-                    BattleNode & newNode = _cache[newNodeIdx];
+                    BattleNode & newNode = tryAddNode( newNodeIdx ).first;
                     if ( newNode._from == BattleNodeIndex{ -1, -1 } || newNode._cost > cost ) {
                         newNode.update( currentNodeIdx, cost, distance );
 
@@ -228,14 +299,12 @@ namespace Battle
 
         const BattleNodeIndex nodeIdx = { position.GetHead()->GetIndex(), position.GetTail() ? position.GetTail()->GetIndex() : -1 };
 
-        const auto iter = _cache.find( nodeIdx );
-        if ( iter == _cache.end() ) {
+        const BattleNode * node = findNode( nodeIdx );
+        if ( node == nullptr ) {
             return false;
         }
 
-        const auto & [index, node] = *iter;
-
-        return ( index == _pathStart || node._from != BattleNodeIndex{ -1, -1 } ) && ( !isOnCurrentTurn || node._cost <= _speed );
+        return ( nodeIdx == _pathStart || node->_from != BattleNodeIndex{ -1, -1 } ) && ( !isOnCurrentTurn || node->_cost <= _speed );
     }
 
     uint32_t BattlePathfinder::getCost( const Unit & unit, const Position & position )
@@ -246,14 +315,13 @@ namespace Battle
 
         const BattleNodeIndex nodeIdx = { position.GetHead()->GetIndex(), position.GetTail() ? position.GetTail()->GetIndex() : -1 };
 
-        const auto iter = _cache.find( nodeIdx );
-        assert( iter != _cache.end() );
+        const BattleNode * node = findNode( nodeIdx );
+        assert( node != nullptr );
 
-        const auto & [index, node] = *iter;
         // MSVC 2017 fails to properly expand the assert() macro without additional parentheses
-        assert( ( index == _pathStart || node._from != BattleNodeIndex{ -1, -1 } ) );
+        assert( ( nodeIdx == _pathStart || node->_from != BattleNodeIndex{ -1, -1 } ) );
 
-        return node._cost;
+        return node->_cost;
     }
 
     uint32_t BattlePathfinder::getDistance( const Unit & unit, const Position & position )
@@ -264,14 +332,13 @@ namespace Battle
 
         const BattleNodeIndex nodeIdx = { position.GetHead()->GetIndex(), position.GetTail() ? position.GetTail()->GetIndex() : -1 };
 
-        const auto iter = _cache.find( nodeIdx );
-        assert( iter != _cache.end() );
+        const BattleNode * node = findNode( nodeIdx );
+        assert( node != nullptr );
 
-        const auto & [index, node] = *iter;
         // MSVC 2017 fails to properly expand the assert() macro without additional parentheses
-        assert( ( index == _pathStart || node._from != BattleNodeIndex{ -1, -1 } ) );
+        assert( ( nodeIdx == _pathStart || node->_from != BattleNodeIndex{ -1, -1 } ) );
 
-        return node._distance;
+        return node->_distance;
     }
 
     Indexes BattlePathfinder::getAllAvailableMoves( const Unit & unit )
@@ -280,7 +347,13 @@ namespace Battle
 
         std::set<int32_t> boardIndexes;
 
-        for ( const auto & [index, node] : _cache ) {
+        for ( size_t slot = 0; slot < _cache.size(); ++slot ) {
+            const BattleNode & node = _cache[slot];
+            if ( node._generation != _cacheGeneration ) {
+                continue;
+            }
+
+            const BattleNodeIndex index = getNodeIndex( slot );
             if ( index == _pathStart || node._from == BattleNodeIndex{ -1, -1 } || node._cost > _speed ) {
                 continue;
             }
@@ -310,21 +383,21 @@ namespace Battle
         BattleNodeIndex lastReachableNodeIdx{ -1, -1 };
         BattleNodeIndex nodeIdx = { position.GetHead()->GetIndex(), position.GetTail() ? position.GetTail()->GetIndex() : -1 };
 
-        for ( auto iter = _cache.find( nodeIdx ); iter != _cache.end(); iter = _cache.find( nodeIdx ) ) {
-            const auto & [index, node] = *iter;
+        for ( const BattleNode * node = findNode( nodeIdx ); node != nullptr; node = findNode( nodeIdx ) ) {
+            const BattleNodeIndex index = nodeIdx;
 
             if ( index == _pathStart ) {
                 break;
             }
 
             // MSVC 2017 fails to properly expand the assert() macro without additional parentheses
-            assert( ( node._from != BattleNodeIndex{ -1, -1 } ) );
+            assert( ( node->_from != BattleNodeIndex{ -1, -1 } ) );
 
-            nodeIdx = node._from;
+            nodeIdx = node->_from;
 
             // A given position may be reachable in principle, but is not reachable on the current turn.
             // Skip the steps that are not reachable on this turn.
-            if ( node._cost > _speed ) {
+            if ( node->_cost > _speed ) {
                 continue;
             }
 
@@ -365,21 +438,21 @@ namespace Battle
 
         BattleNodeIndex nodeIdx = { position.GetHead()->GetIndex(), position.GetTail() ? position.GetTail()->GetIndex() : -1 };
 
-        for ( auto iter = _cache.find( nodeIdx ); iter != _cache.end(); iter = _cache.find( nodeIdx ) ) {
-            const auto & [index, node] = *iter;
+        for ( const BattleNode * node = findNode( nodeIdx ); node != nullptr; node = findNode( nodeIdx ) ) {
+            const BattleNodeIndex index = nodeIdx;
 
             if ( index == _pathStart ) {
                 break;
             }
 
             // MSVC 2017 fails to properly expand the assert() macro without additional parentheses
-            assert( ( node._from != BattleNodeIndex{ -1, -1 } ) );
+            assert( ( node->_from != BattleNodeIndex{ -1, -1 } ) );
 
-            nodeIdx = node._from;
+            nodeIdx = node->_from;
 
             // A given position may be reachable in principle, but is not reachable on the current turn.
             // Skip the steps that are not reachable on this turn.
-            if ( node._cost > _speed ) {
+            if ( node->_cost > _speed ) {
                 continue;
             }
 
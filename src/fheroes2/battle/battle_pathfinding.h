@@ -23,7 +23,6 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
-#include <unordered_map>
 #include <utility>
 
 #include "battle_board.h"
@@ -36,19 +35,6 @@ namespace Battle
 
     using BattleNodeIndex = std::pair<int32_t, int32_t>;
 
-    struct BattleNodeIndexHash final
-    {
-        std::size_t operator()( const BattleNodeIndex & index ) const noexcept
-        {
-            const uint64_t f = index.first;
-            const uint64_t s = index.second;
-
-            std::hash<uint64_t> hasher;
-
-            return hasher( ( f << 32 ) + s );
-        }
-    };
-
     struct BattleNode final
     {
         BattleNodeIndex _from{ -1, -1 };
@@ -59,6 +45,8 @@ namespace Battle
         // The reversal of a wide unit is not considered as a movement. For flying units, this distance is
         // estimated as the straight line distance to the position corresponding to this node.
         uint32_t _distance{ 0 };
+        // The node belongs to the current cache only if this value is equal to the current generation of the cache
+        uint32_t _generation{ 0 };
 
         BattleNode() = default;
 
@@ -106,10 +94,33 @@ namespace Battle
         Position getClosestReachablePosition( const Unit & unit, const Position & position );
 
     private:
+        // Each cell can be occupied by the head of a unit in three ways: by a non-wide unit, or by a wide unit with the tail
+        // to the left or to the right of the head
+        static constexpr size_t nodesPerCell{ 3 };
+
+        // Returns the position of the node with the given index in the cache
+        static size_t getCacheSlot( const BattleNodeIndex & index );
+
+        // Returns the index of the node located in the given position in the cache
+        static BattleNodeIndex getNodeIndex( const size_t slot );
+
         // Rebuilds the graph of available positions for the given unit if necessary (if it is not already cached)
         void reEvaluateIfNeeded( const Unit & unit );
 
-        std::unordered_map<BattleNodeIndex, BattleNode, BattleNodeIndexHash> _cache;
+        // Removes all nodes from the cache
+        void clearCache();
+
+        // Returns the node with the given index or nullptr if there is no such node in the cache
+        const BattleNode * findNode( const BattleNodeIndex & index ) const;
+
+        // Returns the node with the given index, the node is added to the cache if it is not there yet. The second returned
+        // value is true if the node has been added.
+        std::pair<BattleNode &, bool> tryAddNode( const BattleNodeIndex & index );
+
+        // Nodes are stored in a preallocated array covering all possible positions of units on the board. Instead of being
+        // erased from the array, all nodes are invalidated at once by changing the generation of the cache.
+        std::array<BattleNode, Board::sizeInCells * nodesPerCell> _cache{};
+        uint32_t _cacheGeneration{ 1 };
 
         // Parameters of the unit for which the current cache is created
         BattleNodeIndex _pathStart{ -1, -1 };
@@ -0,0 +1,218 @@
+/***************************************************************************
+ *   fheroes2: https://github.com/ihhub/fheroes2                           *
+ *   Copyright (C) 2025                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "battle_simulator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <vector>
+
+#include "army.h"
+#include "army_troop.h"
+#include "battle.h"
+#include "battle_arena.h"
+#include "battle_army.h"
+#include "color.h"
+#include "game.h"
+#include "logging.h"
+#include "players.h"
+#include "rand.h"
+#include "settings.h"
+#include "thread.h"
+#include "world.h"
+
+namespace
+{
+    const PlayerColor attackerColor = PlayerColor::BLUE;
+    const PlayerColor defenderColor = PlayerColor::RED;
+
+    // The same tile as in the Battle Only mode: the battle-only map has no castles, so there is never a siege.
+    const int32_t battleTileIndex = 1;
+
+    struct SideOutcome
+    {
+        bool isWinner{ false };
+        double strengthLoss{ 0 };
+        std::vector<uint32_t> killedMonsters;
+    };
+
+    struct BattleOutcome
+    {
+        SideOutcome attacker;
+        SideOutcome defender;
+    };
+
+    SideOutcome getSideOutcome( const Battle::Force & force, const Army & army, const uint32_t result )
+    {
+        SideOutcome outcome;
+        outcome.isWinner = ( result & Battle::RESULT_WINS );
+
+        const Troops killedTroops = force.GetKilledTroops();
+        outcome.killedMonsters.reserve( killedTroops.Size() );
+
+        for ( size_t i = 0; i < killedTroops.Size(); ++i ) {
+            const Troop * troop = killedTroops.GetTroop( i );
+            assert( troop != nullptr );
+
+            outcome.killedMonsters.push_back( troop->GetCount() );
+        }
+
+        // Army::GetStrength() takes the commander and the morale into account, compare only the raw strength of the troops.
+        const double initialStrength = army.Troops::GetStrength();
+        if ( initialStrength > 0 ) {
+            outcome.strengthLoss = std::min( killedTroops.GetStrength() / initialStrength, 1.0 );
+        }
+
+        return outcome;
+    }
+
+    BattleOutcome simulateBattle( const Troops & attackerTroops, const Troops & defenderTroops, const uint32_t seed )
+    {
+        Army attackerArmy;
+        attackerArmy.Assign( attackerTroops );
+        attackerArmy.SetColor( attackerColor );
+
+        Army defenderArmy;
+        defenderArmy.Assign( defenderTroops );
+        defenderArmy.SetColor( defenderColor );
+
+        Rand::PCG32 randomGenerator( seed );
+        Battle::Arena arena( attackerArmy, defenderArmy, battleTileIndex, false, randomGenerator );
+
+        while ( arena.BattleValid() ) {
+            arena.Turns();
+        }
+
+        const Battle::Result & result = arena.GetResult();
+
+        // Forces keep the initial number of monsters in the armies until they are synchronized, which never happens here.
+        return { getSideOutcome( arena.GetForce1(), attackerArmy, result.army1 ), getSideOutcome( arena.GetForce2(), defenderArmy, result.army2 ) };
+    }
+
+    void addSideOutcome( Battle::SimulationSideStats & stats, const SideOutcome & outcome )
+    {
+        if ( outcome.isWinner ) {
+            ++stats.wins;
+        }
+
+        stats.strengthLosses.push_back( outcome.strengthLoss );
+
+        if ( stats.killedMonsters.empty() ) {
+            stats.killedMonsters.resize( outcome.killedMonsters.size(), 0 );
+        }
+
+        assert( outcome.killedMonsters.size() == stats.killedMonsters.size() );
+
+        for ( size_t i = 0; i < outcome.killedMonsters.size(); ++i ) {
+            stats.killedMonsters[i] += outcome.killedMonsters[i];
+        }
+    }
+}
+
+double Battle::SimulationSideStats::getWinRate() const
+{
+    if ( strengthLosses.empty() ) {
+        return 0;
+    }
+
+    return static_cast<double>( wins ) / static_cast<double>( strengthLosses.size() );
+}
+
+double Battle::SimulationSideStats::getLossPercentile( const double percentile ) const
+{
+    if ( strengthLosses.empty() ) {
+        return 0;
+    }
+
+    assert( percentile >= 0 && percentile <= 1 );
+
+    std::vector<double> losses = strengthLosses;
+
+    const size_t idx = std::min( static_cast<size_t>( percentile * static_cast<double>( losses.size() ) ), losses.size() - 1 );
+
+    std::nth_element( losses.begin(), losses.begin() + static_cast<std::ptrdiff_t>( idx ), losses.end() );
+
+    return losses[idx];
+}
+
+void Battle::prepareSimulationWorld()
+{
+    Settings & conf = Settings::Get();
+
+    conf.SetGameType( Game::TYPE_BATTLEONLY );
+
+    world.generateBattleOnlyMap();
+
+    conf.GetPlayers().Init( attackerColor | defenderColor );
+    world.InitKingdoms();
+
+    for ( const PlayerColor color : { attackerColor, defenderColor } ) {
+        Players::SetPlayerControl( color, CONTROL_AI );
+    }
+
+    conf.SetCurrentColor( PlayerColor::NONE );
+}
+
+Battle::SimulationResult Battle::simulateBattles( const Troops & attackerTroops, const Troops & defenderTroops, const uint32_t battleCount, const uint32_t seed,
+                                                  const size_t threadCount /* = 0 */ )
+{
+    // The world must be prepared by prepareSimulationWorld().
+    assert( world.w() > 0 && world.h() > 0 && Players::Get( attackerColor ) != nullptr && Players::Get( defenderColor ) != nullptr );
+
+    SimulationResult result;
+    result.battleCount = battleCount;
+
+    result.attacker.strengthLosses.reserve( battleCount );
+    result.defender.strengthLosses.reserve( battleCount );
+
+    if ( !attackerTroops.isValid() || !defenderTroops.isValid() ) {
+        DEBUG_LOG( DBG_BATTLE, DBG_WARN, "One of the simulated armies is empty" )
+        return result;
+    }
+
+    // Every battle has its own outcome slot so that the merged statistics do not depend on the order in which the battles are finished.
+    std::vector<BattleOutcome> outcomes( battleCount );
+
+    const auto runBattle = [&attackerTroops, &defenderTroops, &outcomes, seed]( const size_t battleId, const size_t /* threadId */ ) {
+        outcomes[battleId] = simulateBattle( attackerTroops, defenderTroops, seed + static_cast<uint32_t>( battleId ) );
+    };
+
+    if ( threadCount == 1 ) {
+        for ( size_t battleId = 0; battleId < outcomes.size(); ++battleId ) {
+            runBattle( battleId, 0 );
+        }
+    }
+    else {
+        MultiThreading::WorkerPool workerPool( threadCount == 0 ? 0 : threadCount - 1 );
+        workerPool.parallelFor( outcomes.size(), runBattle );
+    }
+
+    for ( const BattleOutcome & outcome : outcomes ) {
+        addSideOutcome( result.attacker, outcome.attacker );
+        addSideOutcome( result.defender, outcome.defender );
+    }
+
+    DEBUG_LOG( DBG_BATTLE, DBG_INFO,
+               "Simulated " << battleCount << " battles, attacker wins: " << result.attacker.wins << ", defender wins: " << result.defender.wins )
+
+    return result;
+}
@@ -0,0 +1,67 @@
+/***************************************************************************
+ *   fheroes2: https://github.com/ihhub/fheroes2                           *
+ *   Copyright (C) 2025                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Troops;
+
+namespace Battle
+{
+    struct SimulationSideStats
+    {
+        // Returns the share of the battles won by this side, in range [0, 1].
+        double getWinRate() const;
+
+        // Returns the share of the initial army strength lost in the given percentile of the battles.
+        double getLossPercentile( const double percentile ) const;
+
+        uint32_t wins{ 0 };
+
+        // The share of the initial army strength lost in every battle, in range [0, 1]. Battles are stored in the order of their seeds.
+        std::vector<double> strengthLosses;
+
+        // The total number of killed monsters of every valid troop of the initial army over all battles, in the order of the troops.
+        // Only the first Army::maximumTroopCount troops of the given troops take part in the battles.
+        std::vector<uint64_t> killedMonsters;
+    };
+
+    struct SimulationResult
+    {
+        uint32_t battleCount{ 0 };
+
+        SimulationSideStats attacker;
+        SimulationSideStats defender;
+    };
+
+    // Replaces the current world by a tiny battle-only map and sets up two AI-controlled players for the simulated armies.
+    // Must be called once before simulateBattles().
+    void prepareSimulationWorld();
+
+    // Runs the given number of auto-combat battles between the armies without any interface. Every battle uses its own random
+    // generator seeded by ( seed + battle number ), so the result depends only on the armies, the battle count and the seed and
+    // does not depend on the number of threads. If the thread count is 0 then it is chosen based on the number of hardware threads.
+    // Armies have no commanders: troops are copied into new armies for every battle so the given troops are never modified.
+    SimulationResult simulateBattles( const Troops & attackerTroops, const Troops & defenderTroops, const uint32_t battleCount, const uint32_t seed,
+                                      const size_t threadCount = 0 );
+}
@@ -0,0 +1,290 @@
+/***************************************************************************
+ *   fheroes2: https://github.com/ihhub/fheroes2                           *
+ *   Copyright (C) 2025                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "battle_snapshot.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "battle.h"
+#include "battle_arena.h"
+#include "battle_army.h"
+#include "battle_cell.h"
+#include "battle_troop.h"
+#include "monster_info.h"
+#include "spell.h"
+
+namespace
+{
+    // Modes which affect the outcome of the actions simulated by the snapshot.
+    const uint32_t trackedModes = Battle::TR_RESPONDED | Battle::TR_MOVED | Battle::CAP_MIRRORIMAGE | Battle::SP_HYPNOTIZE | Battle::SP_BLIND | Battle::IS_PARALYZE_MAGIC;
+
+    uint32_t getTrackedModes( const Battle::Unit & unit )
+    {
+        uint32_t modes = 0;
+
+        for ( uint32_t mode = 1; mode != 0; mode <<= 1 ) {
+            if ( ( trackedModes & mode ) && unit.Modes( mode ) ) {
+                modes |= mode;
+            }
+        }
+
+        return modes;
+    }
+
+    double getExpectedDamagePerMonster( const Battle::Unit & attacker, const Battle::Unit & defender, const bool isRangedAttack )
+    {
+        assert( attacker.GetCount() > 0 );
+
+        const double damage = [&attacker, &defender, isRangedAttack]() -> double {
+            if ( attacker.Modes( Battle::SP_CURSE ) ) {
+                return attacker.CalculateMinDamage( defender, isRangedAttack );
+            }
+
+            if ( attacker.Modes( Battle::SP_BLESS ) ) {
+                return attacker.CalculateMaxDamage( defender, isRangedAttack );
+            }
+
+            return ( static_cast<double>( attacker.CalculateMinDamage( defender, isRangedAttack ) ) + attacker.CalculateMaxDamage( defender, isRangedAttack ) ) / 2;
+        }();
+
+        return damage / attacker.GetCount();
+    }
+}
+
+Battle::Snapshot::Snapshot( const Arena & arena )
+{
+    auto data = std::make_shared<SharedData>();
+
+    std::vector<const Unit *> units;
+    units.reserve( arena.GetForce1().size() + arena.GetForce2().size() );
+
+    for ( const Force * force : { &arena.GetForce1(), &arena.GetForce2() } ) {
+        for ( const Unit * unit : *force ) {
+            assert( unit != nullptr );
+
+            if ( !unit->isValid() ) {
+                continue;
+            }
+
+            units.push_back( unit );
+        }
+    }
+
+    assert( units.size() <= maxUnitCount );
+
+    _unitCount = units.size();
+
+    data->units.reserve( _unitCount );
+    data->meleeDamagePerMonster.resize( _unitCount * _unitCount, -1 );
+    data->rangedDamagePerMonster.resize( _unitCount * _unitCount, -1 );
+
+    for ( size_t i = 0; i < _unitCount; ++i ) {
+        const Unit & unit = *units[i];
+
+        UnitInfo & info = data->units.emplace_back();
+        info.uid = unit.GetUID();
+        info.monsterHitPoints = unit.Monster::GetHitPoints();
+        info.monsterStrength = unit.GetMonsterStrength();
+        info.color = unit.GetArmyColor();
+        info.isDoubleMeleeAttack = unit.isAbilityPresent( fheroes2::MonsterAbilityType::DOUBLE_MELEE_ATTACK );
+        info.isDoubleShooting = unit.isAbilityPresent( fheroes2::MonsterAbilityType::DOUBLE_SHOOTING );
+        info.isIgnoringRetaliation = unit.isIgnoringRetaliation();
+        info.isAlwaysRetaliating = unit.isAbilityPresent( fheroes2::MonsterAbilityType::ALWAYS_RETALIATE );
+
+        UnitState & state = _units[i];
+        state.hitPoints = unit.GetHitPoints();
+        state.count = unit.GetCount();
+        state.modes = getTrackedModes( unit );
+        state.shots = unit.GetShots();
+        state.headIndex = unit.GetHeadIndex();
+        state.tailIndex = unit.GetTailIndex();
+    }
+
+    data->arenaUnits = std::move( units );
+
+    _data = std::move( data );
+}
+
+int32_t Battle::Snapshot::getUnitId( const uint32_t uid ) const
+{
+    const std::vector<UnitInfo> & units = _data->units;
+
+    const auto iter = std::find_if( units.begin(), units.end(), [uid]( const UnitInfo & info ) { return info.uid == uid; } );
+    if ( iter == units.end() ) {
+        return -1;
+    }
+
+    return static_cast<int32_t>( iter - units.begin() );
+}
+
+const Battle::Snapshot::UnitState & Battle::Snapshot::getUnitState( const int32_t unitId ) const
+{
+    assert( unitId >= 0 && static_cast<size_t>( unitId ) < _unitCount );
+
+    return _units[unitId];
+}
+
+double Battle::Snapshot::getStrength( const PlayerColor color ) const
+{
+    double strength = 0;
+
+    for ( size_t i = 0; i < _unitCount; ++i ) {
+        const UnitInfo & info = _data->units[i];
+
+        if ( info.color == color ) {
+            strength += info.monsterStrength * _units[i].count;
+        }
+    }
+
+    return strength;
+}
+
+void Battle::Snapshot::move( const int32_t unitId, const Position & position )
+{
+    assert( position.GetHead() != nullptr );
+
+    UnitState & state = _units[unitId];
+    assert( state.count > 0 );
+
+    state.headIndex = position.GetHead()->GetIndex();
+    state.tailIndex = position.GetTail() ? position.GetTail()->GetIndex() : -1;
+    state.modes |= TR_MOVED;
+}
+
+void Battle::Snapshot::attack( const int32_t attackerId, const int32_t defenderId )
+{
+    assert( attackerId != defenderId );
+
+    UnitState & attacker = _units[attackerId];
+    UnitState & defender = _units[defenderId];
+    assert( attacker.count > 0 && defender.count > 0 );
+
+    const UnitInfo & attackerInfo = _data->units[attackerId];
+    const UnitInfo & defenderInfo = _data->units[defenderId];
+
+    // A blinded unit retaliates with a reduced damage, the blindness itself is removed by the attack
+    const bool isBlindRetaliation = ( defender.modes & SP_BLIND ) != 0;
+
+    _applyDamage( defenderId, _getExpectedDamage( attackerId, defenderId, false ) );
+
+    if ( defender.count > 0 && !attackerInfo.isIgnoringRetaliation && _isRetaliationAllowed( defenderId ) ) {
+        double damage = _getExpectedDamage( defenderId, attackerId, false );
+        if ( isBlindRetaliation ) {
+            damage = damage * ( 100 - Spell( Spell::BLIND ).ExtraValue() ) / 100;
+        }
+
+        _applyDamage( attackerId, damage );
+
+        if ( !defenderInfo.isAlwaysRetaliating ) {
+            defender.modes |= TR_RESPONDED;
+        }
+    }
+
+    if ( attackerInfo.isDoubleMeleeAttack && attacker.count > 0 && defender.count > 0 ) {
+        _applyDamage( defenderId, _getExpectedDamage( attackerId, defenderId, false ) );
+    }
+
+    attacker.modes |= TR_MOVED;
+}
+
+void Battle::Snapshot::shoot( const int32_t attackerId, const int32_t defenderId )
+{
+    assert( attackerId != defenderId );
+
+    UnitState & attacker = _units[attackerId];
+    const UnitState & defender = _units[defenderId];
+    assert( attacker.count > 0 && attacker.shots > 0 && defender.count > 0 );
+
+    _applyDamage( defenderId, _getExpectedDamage( attackerId, defenderId, true ) );
+    --attacker.shots;
+
+    if ( _data->units[attackerId].isDoubleShooting && attacker.shots > 0 && defender.count > 0 ) {
+        _applyDamage( defenderId, _getExpectedDamage( attackerId, defenderId, true ) );
+        --attacker.shots;
+    }
+
+    attacker.modes |= TR_MOVED;
+}
+
+void Battle::Snapshot::skip( const int32_t unitId )
+{
+    _units[unitId].modes |= TR_MOVED;
+}
+
+double Battle::Snapshot::_getExpectedDamage( const int32_t attackerId, const int32_t defenderId, const bool isRangedAttack ) const
+{
+    assert( attackerId != defenderId );
+
+    std::vector<double> & damagePerMonster = isRangedAttack ? _data->rangedDamagePerMonster : _data->meleeDamagePerMonster;
+    double & damage = damagePerMonster[attackerId * _unitCount + defenderId];
+
+    if ( damage < 0 ) {
+        const Unit & attacker = *_data->arenaUnits[attackerId];
+        assert( !isRangedAttack || attacker.isArchers() );
+
+        damage = getExpectedDamagePerMonster( attacker, *_data->arenaUnits[defenderId], isRangedAttack );
+    }
+
+    return damage * _units[attackerId].count;
+}
+
+void Battle::Snapshot::_applyDamage( const int32_t unitId, const double damage )
+{
+    UnitState & state = _units[unitId];
+
+    // The minimum damage is always 1
+    const uint32_t damageToApply = std::max( static_cast<uint32_t>( std::lround( damage ) ), 1U );
+
+    if ( state.modes & IS_PARALYZE_MAGIC ) {
+        if ( !_data->units[unitId].isAlwaysRetaliating ) {
+            state.modes |= TR_RESPONDED;
+        }
+
+        state.modes |= TR_MOVED;
+        state.modes &= ~IS_PARALYZE_MAGIC;
+    }
+
+    if ( state.modes & SP_BLIND ) {
+        state.modes |= TR_MOVED;
+        state.modes &= ~SP_BLIND;
+    }
+
+    // Mirror images are destroyed by any damage
+    if ( damageToApply >= state.hitPoints || ( state.modes & CAP_MIRRORIMAGE ) ) {
+        state.hitPoints = 0;
+        state.count = 0;
+
+        return;
+    }
+
+    state.hitPoints -= damageToApply;
+
+    const uint32_t monsterHitPoints = _data->units[unitId].monsterHitPoints;
+    assert( monsterHitPoints > 0 );
+
+    state.count = ( state.hitPoints + monsterHitPoints - 1 ) / monsterHitPoints;
+}
+
+bool Battle::Snapshot::_isRetaliationAllowed( const int32_t unitId ) const
+{
+    return ( _units[unitId].modes & ( TR_RESPONDED | SP_HYPNOTIZE | SP_BLIND | IS_PARALYZE_MAGIC ) ) == 0;
+}
@@ -0,0 +1,129 @@
+/***************************************************************************
+ *   fheroes2: https://github.com/ihhub/fheroes2                           *
+ *   Copyright (C) 2025                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "battle_board.h"
+#include "color.h"
+
+namespace Battle
+{
+    class Arena;
+    class Unit;
+
+    // A lightweight copy of the state of the units on the battlefield which can be advanced by the battle AI to look ahead
+    // without touching the arena. It contains only the units' positions, hit points, number of shots and modes: there is no
+    // interface, graveyard or animation state. Unit states are stored in a fixed-size array and the data that does not change
+    // during the look-ahead (including the damage table) is shared between all copies of the snapshot, so copying and advancing
+    // a snapshot never allocates memory. The arena must not be changed while the snapshot or any of its copies is in use, and
+    // all of them must be used by the same thread.
+    //
+    // The damage is estimated as the expected damage (without luck) of a unit to another unit at the time the snapshot was taken.
+    // It is calculated only for the pairs of units which actually fight, separately for melee and ranged attacks. Area attacks,
+    // spells, morale and the interaction of mirror images with their owners are not simulated.
+    class Snapshot
+    {
+    public:
+        // Every alive unit occupies at least one cell of the board.
+        static constexpr size_t maxUnitCount = Board::sizeInCells;
+
+        struct UnitState
+        {
+            uint32_t hitPoints{ 0 };
+            uint32_t count{ 0 };
+            uint32_t modes{ 0 };
+            uint32_t shots{ 0 };
+            int32_t headIndex{ -1 };
+            int32_t tailIndex{ -1 };
+        };
+
+        explicit Snapshot( const Arena & arena );
+
+        // Returns the internal id of the unit with the given UID or -1 if this unit is not present in the snapshot.
+        int32_t getUnitId( const uint32_t uid ) const;
+
+        const UnitState & getUnitState( const int32_t unitId ) const;
+
+        size_t getUnitCount() const
+        {
+            return _unitCount;
+        }
+
+        // Returns the total strength of the alive units of the army of the given color.
+        double getStrength( const PlayerColor color ) const;
+
+        // Moves the unit to the given position and marks it as moved.
+        void move( const int32_t unitId, const Position & position );
+
+        // Performs a melee attack including the retaliation and the second strike of units with a double attack.
+        void attack( const int32_t attackerId, const int32_t defenderId );
+
+        // Performs a ranged attack including the second shot of units with a double shooting.
+        void shoot( const int32_t attackerId, const int32_t defenderId );
+
+        // Marks the unit as moved without doing anything.
+        void skip( const int32_t unitId );
+
+    private:
+        struct UnitInfo
+        {
+            uint32_t uid{ 0 };
+            uint32_t monsterHitPoints{ 0 };
+            double monsterStrength{ 0 };
+            PlayerColor color{ PlayerColor::NONE };
+            bool isDoubleMeleeAttack{ false };
+            bool isDoubleShooting{ false };
+            bool isIgnoringRetaliation{ false };
+            // Such units retaliate an unlimited number of times and even when they are paralyzed
+            bool isAlwaysRetaliating{ false };
+        };
+
+        struct SharedData
+        {
+            std::vector<UnitInfo> units;
+
+            // Units of the arena the damage is calculated for.
+            std::vector<const Unit *> arenaUnits;
+
+            // Expected damage of a single monster of the attacking unit to the defending unit, indexed by ( attackerId * unitCount + defenderId ).
+            // Negative values mean that the damage has not been calculated yet.
+            mutable std::vector<double> meleeDamagePerMonster;
+            mutable std::vector<double> rangedDamagePerMonster;
+        };
+
+        double _getExpectedDamage( const int32_t attackerId, const int32_t defenderId, const bool isRangedAttack ) const;
+
+        void _applyDamage( const int32_t unitId, const double damage );
+
+        bool _isRetaliationAllowed( const int32_t unitId ) const;
+
+        std::shared_ptr<const SharedData> _data;
+
+        std::array<UnitState, maxUnitCount> _units{};
+
+        size_t _unitCount{ 0 };
+    };
+}
@@ -500,13 +500,30 @@ uint32_t Battle::Unit::CalculateMaxDamage( const Unit & enemy ) const
     return CalculateDamageUnit( enemy, ArmyTroop::GetDamageMax() );
 }
 
+uint32_t Battle::Unit::CalculateMinDamage( const Unit & enemy, const bool isRangedAttack ) const
+{
+    return _calculateDamageUnit( enemy, ArmyTroop::GetDamageMin(), isRangedAttack );
+}
+
+uint32_t Battle::Unit::CalculateMaxDamage( const Unit & enemy, const bool isRangedAttack ) const
+{
+    return _calculateDamageUnit( enemy, ArmyTroop::GetDamageMax(), isRangedAttack );
+}
+
 uint32_t Battle::Unit::CalculateDamageUnit( const Unit & enemy, double dmg ) const
 {
+    // Melee penalty can be applied either if the archer is blocked by enemy units and cannot shoot,
+    // or if he is not blocked, but was attacked by a friendly unit (for example, in the case of using
+    // Berserk or Hypnotize spells) and deals retaliatory damage
+    return _calculateDamageUnit( enemy, dmg, isArchers() && !isHandFighting() && !isHandFighting( *this, enemy ) );
+}
+
+uint32_t Battle::Unit::_calculateDamageUnit( const Unit & enemy, double dmg, const bool isRangedAttack ) const
+{
+    assert( !isRangedAttack || isArchers() );
+
     if ( isArchers() ) {
-        // Melee penalty can be applied either if the archer is blocked by enemy units and cannot shoot,
-        // or if he is not blocked, but was attacked by a friendly unit (for example, in the case of using
-        // Berserk or Hypnotize spells) and deals retaliatory damage
-        if ( !isHandFighting() && !isHandFighting( *this, enemy ) ) {
+        if ( isRangedAttack ) {
             // Hero's Archery skill may increase damage
             if ( GetCommander() ) {
                 dmg += ( dmg * GetCommander()->GetSecondarySkillValue( Skill::Secondary::ARCHERY ) / 100 );
@@ -230,6 +230,11 @@ namespace Battle
         uint32_t CalculateMaxDamage( const Unit & enemy ) const;
         uint32_t CalculateDamageUnit( const Unit & enemy, double dmg ) const;
 
+        // Same as above, but the type of the attack is specified explicitly instead of being derived from the current positions of the units.
+        // Only archers can make a ranged attack.
+        uint32_t CalculateMinDamage( const Unit & enemy, const bool isRangedAttack ) const;
+        uint32_t CalculateMaxDamage( const Unit & enemy, const bool isRangedAttack ) const;
+
         // Returns a very rough estimate of the retaliatory damage after this unit receives the damage of the specified value.
         // The returned value is not suitable for accurate calculations, but only for approximate comparison with other units
         // in similar circumstances.
@@ -335,6 +340,8 @@ namespace Battle
         AnimationState animation;
 
     private:
+        uint32_t _calculateDamageUnit( const Unit & enemy, double dmg, const bool isRangedAttack ) const;
+
         // Returns the count of killed troops.
         uint32_t _applyDamage( const uint32_t dmg );
         uint32_t _resurrect( const uint32_t points, const bool allowToExceedInitialCount, const bool isTemporary );
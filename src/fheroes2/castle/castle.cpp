@@ -946,6 +946,12 @@ void Castle::ChangeColor( const PlayerColor newColor )
 {
     SetColor( newColor );
     _army.SetColor( newColor );
+
+    // The castle entrance is passable only for heroes of its own color and its allies.
+    world.invalidatePathfinderTile( GetIndex() );
+
+    // All tiles of the castle (see isPosition() method) are painted with its color on the radar.
+    world.invalidateRadarArea( { center.x - 2, center.y - 1, 5, 2 } );
 }
 
 int Castle::GetLevelMageGuild() const
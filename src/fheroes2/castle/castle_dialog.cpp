@@ -310,7 +310,8 @@ Castle::CastleDialogReturnValue Castle::OpenDialog( const bool openConstructionW
 
     statusBarPosition.x += buttonPrevCastle.area().width;
 
-    // Status bar at the bottom of dialog.
+    // Status bar at the bottom of dialog. Its sprite is used until the dialog is closed.
+    const fheroes2::AGG::SpriteEvictionBlocker spriteEvictionBlocker;
     const fheroes2::Sprite & bar = fheroes2::AGG::GetICN( ICN::SMALLBAR, 0 );
     fheroes2::Copy( bar, 0, 0, display, statusBarPosition.x, statusBarPosition.y, bar.width(), bar.height() );
 
@@ -473,6 +473,8 @@ int Dialog::ArmyInfo( const Troop & troop, int flags, bool isReflected, const in
     const bool isEvilInterface = Settings::Get().isEvilInterfaceEnabled();
 
     const int viewarmy = isEvilInterface ? ICN::VIEWARME : ICN::VIEWARMY;
+    // The dialog sprites are used until the dialog is closed.
+    const fheroes2::AGG::SpriteEvictionBlocker spriteEvictionBlocker;
     const fheroes2::Sprite & sprite_dialog = fheroes2::AGG::GetICN( viewarmy, 0 );
     const fheroes2::Sprite & spriteDialogShadow = fheroes2::AGG::GetICN( viewarmy, 7 );
 
@@ -63,6 +63,7 @@
 #include "embedded_image.h"
 #include "exception.h"
 #include "game.h"
+#include "game_io.h"
 #include "game_logo.h"
 #include "game_video.h"
 #include "game_video_type.h"
@@ -187,7 +188,12 @@ namespace
             fheroes2::RenderProcessor & renderProcessor = fheroes2::RenderProcessor::instance();
 
             display.subscribe( [&renderProcessor]( std::vector<uint8_t> & palette ) { return renderProcessor.preRenderAction( palette ); },
-                               [&renderProcessor]() { renderProcessor.postRenderAction(); } );
+                               [&renderProcessor]() {
+                                   renderProcessor.postRenderAction();
+
+                                   // The rendered frame has been drawn, so the sprites which have not been used for it can be released.
+                                   fheroes2::AGG::evictUnusedSprites();
+                               } );
 
             // Initialize system info renderer.
             _systemInfoRenderer = std::make_unique<fheroes2::SystemInfoRenderer>();
@@ -357,6 +363,8 @@ int main( int argc, char ** argv )
         // Initialize game data.
         Game::Init();
 
+        const Game::AutoSaveInitializer autoSaveInitializer;
+
         if ( conf.isShowIntro() ) {
             fheroes2::showTeamInfo();
 
@@ -369,6 +377,7 @@ int main( int argc, char ** argv )
             const CursorRestorer cursorRestorer( true, Cursor::POINTER );
             const fheroes2::Point pos = conf.getSavedWindowPos();
             Game::mainGameLoop( conf.isFirstGameRun(), isProbablyDemoVersion() );
+            fheroes2::AGG::saveSpriteDiskCache();
             const fheroes2::Point currentPos = display.getWindowPos();
             if ( pos != currentPos ) {
                 conf.setStartWindowPos( currentPos );
@@ -1324,6 +1324,8 @@ fheroes2::GameMode Game::SelectCampaignScenario( const fheroes2::GameMode prevMo
         break;
     }
 
+    // The background image is used until the scenario is chosen.
+    const fheroes2::AGG::SpriteEvictionBlocker spriteEvictionBlocker;
     const fheroes2::Sprite & backgroundImage = fheroes2::AGG::GetICN( backgroundIconID, 0 );
     const int32_t backgroundImageWidth = backgroundImage.width();
     const fheroes2::Point top( ( display.width() - backgroundImageWidth ) / 2, ( display.height() - backgroundImage.height() ) / 2 );
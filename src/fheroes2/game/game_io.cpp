@@ -24,9 +24,14 @@
 #include "game_io.h"
 
 #include <algorithm>
+#include <cassert>
 #include <cctype>
+#include <condition_variable>
 #include <cstdint>
 #include <ctime>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <ostream>
 #include <utility>
 
@@ -42,6 +47,7 @@
 #include "serialize.h"
 #include "settings.h"
 #include "system.h"
+#include "thread.h"
 #include "translations.h"
 #include "ui_dialog.h"
 #include "ui_font.h"
@@ -103,19 +109,194 @@ namespace
     {
         return stream >> hdr.status >> hdr.info >> hdr.gameType;
     }
+
+    bool writeSaveHeader( OStreamBase & stream )
+    {
+        const Settings & conf = Settings::Get();
+
+        // Always use the latest version of the file save format
+        Game::SetVersionOfCurrentSaveFile( CURRENT_FORMAT_VERSION );
+        const uint16_t saveFileVersion = CURRENT_FORMAT_VERSION;
+
+        stream << SAV2ID3 << std::to_string( saveFileVersion ) << saveFileVersion
+               << HeaderSAV( conf.getCurrentMapInfo(), conf.GameType(), world.GetDay(), world.GetWeek(), world.GetMonth() );
+
+        return !stream.fail();
+    }
+
+    bool writeSaveData( OStreamBase & stream )
+    {
+        stream << World::Get() << Settings::Get() << GameOver::Result::Get();
+        if ( stream.fail() ) {
+            return false;
+        }
+
+        if ( Settings::Get().isCampaignGameType() ) {
+            stream << Campaign::CampaignSaveData::Get();
+        }
+
+        // End-of-data marker
+        stream << SAV2ID3;
+
+        return !stream.fail();
+    }
+
+    // Compresses the serialized autosaves and writes them to the disk on a worker thread. Only one autosave can be in flight at a
+    // time: a new autosave waits until the previous one is written, so autosaves never pile up in memory.
+    class AsyncAutoSaveManager final : public MultiThreading::AsyncManager
+    {
+    public:
+        void pushTask( std::string filePath, std::unique_ptr<RWStreamBuf> headerStream, std::unique_ptr<RWStreamBuf> dataStream )
+        {
+            assert( headerStream && dataStream );
+
+            createWorker();
+
+            std::unique_lock<std::mutex> lock( _mutex );
+
+            _completionNotification.wait( lock, [this] { return !_task && !_isTaskInProgress; } );
+
+            _task.emplace( std::move( filePath ), std::move( headerStream ), std::move( dataStream ) );
+
+            notifyWorker();
+        }
+
+        void waitForCompletion()
+        {
+            std::unique_lock<std::mutex> lock( _mutex );
+
+            _completionNotification.wait( lock, [this] { return !_task && !_isTaskInProgress; } );
+        }
+
+    private:
+        struct AutoSaveTask
+        {
+            AutoSaveTask() = default;
+
+            AutoSaveTask( std::string path, std::unique_ptr<RWStreamBuf> header, std::unique_ptr<RWStreamBuf> data )
+                : filePath( std::move( path ) )
+                , headerStream( std::move( header ) )
+                , dataStream( std::move( data ) )
+            {
+                // Do nothing.
+            }
+
+            std::string filePath;
+            std::unique_ptr<RWStreamBuf> headerStream;
+            std::unique_ptr<RWStreamBuf> dataStream;
+        };
+
+        std::optional<AutoSaveTask> _task;
+        AutoSaveTask _currentTask;
+
+        bool _isTaskInProgress{ false };
+
+        std::condition_variable _completionNotification;
+
+        // This method is called by the worker thread and is protected by _mutex
+        bool prepareTask() override
+        {
+            if ( !_task ) {
+                return false;
+            }
+
+            std::swap( _currentTask, *_task );
+            _task.reset();
+
+            _isTaskInProgress = true;
+
+            return true;
+        }
+
+        // This method is called by the worker thread, but is not protected by _mutex
+        void executeTask() override
+        {
+            // This method is also called after the last prepareTask() call which didn't provide a task.
+            if ( !_currentTask.dataStream ) {
+                return;
+            }
+
+            _writeAutoSave( _currentTask );
+
+            _currentTask = {};
+
+            {
+                const std::scoped_lock<std::mutex> lock( _mutex );
+
+                _isTaskInProgress = false;
+            }
+
+            _completionNotification.notify_all();
+        }
+
+        static void _writeAutoSave( const AutoSaveTask & task )
+        {
+            // The autosave is written to a temporary file which then replaces the previous autosave, so an interrupted write never
+            // leaves a corrupted autosave behind.
+            const std::string tempFilePath = task.filePath + ".tmp";
+
+            {
+                StreamFile fileStream;
+                fileStream.setBigendian( true );
+
+                if ( !fileStream.open( tempFilePath, "wb" ) ) {
+                    ERROR_LOG( "Error opening the file " << tempFilePath )
+                    return;
+                }
+
+                fileStream.putRaw( task.headerStream->data(), task.headerStream->size() );
+
+                Compression::ZipOStream zipStream( fileStream );
+                zipStream.putRaw( task.dataStream->data(), task.dataStream->size() );
+
+                if ( fileStream.fail() || zipStream.fail() || !zipStream.finish() ) {
+                    ERROR_LOG( "Error writing the file " << tempFilePath )
+
+                    fileStream.close();
+                    System::Unlink( tempFilePath );
+
+                    return;
+                }
+            }
+
+            if ( !System::Rename( tempFilePath, task.filePath ) ) {
+                ERROR_LOG( "Error renaming the file " << tempFilePath << " to " << task.filePath )
+
+                System::Unlink( tempFilePath );
+            }
+        }
+    };
+
+    AsyncAutoSaveManager autoSaveManager;
 }
 
 bool Game::AutoSave()
 {
-    return Game::Save( System::concatPath( GetSaveDir(), autoSaveName + GetSaveFileExtension() ), true );
+    const std::string filePath = System::concatPath( GetSaveDir(), autoSaveName + GetSaveFileExtension() );
+
+    DEBUG_LOG( DBG_GAME, DBG_INFO, filePath )
+
+    // Only the serialization of the game state into memory is done on the calling thread, the compression and disk I/O are done
+    // in the background.
+    auto headerStream = std::make_unique<RWStreamBuf>();
+    headerStream->setBigendian( true );
+
+    auto dataStream = std::make_unique<RWStreamBuf>();
+    dataStream->setBigendian( true );
+
+    if ( !writeSaveHeader( *headerStream ) || !writeSaveData( *dataStream ) ) {
+        return false;
+    }
+
+    autoSaveManager.pushTask( filePath, std::move( headerStream ), std::move( dataStream ) );
+
+    return true;
 }
 
-bool Game::Save( const std::string & filePath, const bool autoSave /* = false */ )
+bool Game::Save( const std::string & filePath )
 {
     DEBUG_LOG( DBG_GAME, DBG_INFO, filePath )
 
-    const Settings & conf = Settings::Get();
-
     StreamFile fileStream;
     fileStream.setBigendian( true );
 
@@ -124,38 +305,19 @@ bool Game::Save( const std::string & filePath, const bool autoSave /* = false */
         return false;
     }
 
-    // Always use the latest version of the file save format
-    SetVersionOfCurrentSaveFile( CURRENT_FORMAT_VERSION );
-    uint16_t saveFileVersion = CURRENT_FORMAT_VERSION;
-
-    // Header
-    fileStream << SAV2ID3 << std::to_string( saveFileVersion ) << saveFileVersion
-               << HeaderSAV( conf.getCurrentMapInfo(), conf.GameType(), world.GetDay(), world.GetWeek(), world.GetMonth() );
-    if ( fileStream.fail() ) {
+    if ( !writeSaveHeader( fileStream ) ) {
         return false;
     }
 
-    RWStreamBuf dataStream;
+    // The game data is compressed while it is being serialized, so it is never kept in memory as a whole.
+    Compression::ZipOStream dataStream( fileStream );
     dataStream.setBigendian( true );
 
-    dataStream << World::Get() << Settings::Get() << GameOver::Result::Get();
-    if ( dataStream.fail() ) {
-        return false;
-    }
-
-    if ( conf.isCampaignGameType() ) {
-        dataStream << Campaign::CampaignSaveData::Get();
-    }
-
-    // End-of-data marker
-    dataStream << SAV2ID3;
-    if ( dataStream.fail() || !Compression::zipStreamBuf( dataStream, fileStream ) ) {
+    if ( !writeSaveData( dataStream ) || !dataStream.finish() ) {
         return false;
     }
 
-    if ( !autoSave ) {
-        Game::SetLastSaveName( filePath );
-    }
+    Game::SetLastSaveName( filePath );
 
     return true;
 }
@@ -164,6 +326,9 @@ fheroes2::GameMode Game::Load( const std::string & filePath )
 {
     DEBUG_LOG( DBG_GAME, DBG_INFO, filePath )
 
+    // The autosave being written in the background might be the one that is going to be loaded.
+    autoSaveManager.waitForCompletion();
+
     const auto showGenericErrorMessage = []() { fheroes2::showStandardTextMessage( _( "Error" ), _( "The save file is corrupted." ), Dialog::OK ); };
 
     StreamFile fileStream;
@@ -227,10 +392,10 @@ fheroes2::GameMode Game::Load( const std::string & filePath )
         return fheroes2::GameMode::CANCEL;
     }
 
-    RWStreamBuf dataStream;
+    Compression::UnzipIStream dataStream( fileStream );
     dataStream.setBigendian( true );
 
-    if ( !Compression::unzipStream( fileStream, dataStream ) ) {
+    if ( dataStream.fail() ) {
         showGenericErrorMessage();
         return fheroes2::GameMode::CANCEL;
     }
@@ -413,6 +578,12 @@ std::string Game::GetSaveFileExtension( const int gameType )
     return ".savm";
 }
 
+Game::AutoSaveInitializer::~AutoSaveInitializer()
+{
+    autoSaveManager.waitForCompletion();
+    autoSaveManager.stopWorker();
+}
+
 bool Game::SaveCompletedCampaignScenario()
 {
     return Save( System::concatPath( GetSaveDir(), GetSaveFileBaseName() ) + "_Complete" + GetSaveFileExtension() );
@@ -46,8 +46,21 @@ namespace Game
     std::string GetSaveFileExtension();
     std::string GetSaveFileExtension( const int gameType );
 
+    // The autosave is serialized on the calling thread and is then compressed and written to the disk in the background. If
+    // the previous autosave is still being written, waits for its completion first. Returns false if the serialization fails.
     bool AutoSave();
-    bool Save( const std::string & filePath, const bool autoSave = false );
+    bool Save( const std::string & filePath );
+
+    // Makes sure that all autosaves are written to the disk and stops the background worker on destruction.
+    class AutoSaveInitializer
+    {
+    public:
+        AutoSaveInitializer() = default;
+        AutoSaveInitializer( const AutoSaveInitializer & ) = delete;
+        AutoSaveInitializer & operator=( const AutoSaveInitializer & ) = delete;
+
+        ~AutoSaveInitializer();
+    };
 
     // Returns GameMode::CANCEL in case of failure.
     fheroes2::GameMode Load( const std::string & filePath );
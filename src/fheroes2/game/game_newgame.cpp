@@ -310,6 +310,9 @@ fheroes2::GameMode Game::NewPriceOfLoyaltyCampaign()
     fheroes2::Display & display = fheroes2::Display::instance();
     const fheroes2::Point roiOffset( ( display.width() - display.DEFAULT_WIDTH ) / 2, ( display.height() - display.DEFAULT_HEIGHT ) / 2 );
 
+    // These sprites are drawn again in the event loop.
+    const fheroes2::AGG::SpriteEvictionBlocker spriteEvictionBlocker;
+
     const fheroes2::Sprite & background = fheroes2::AGG::GetICN( ICN::X_IVY, 1 );
     fheroes2::Blit( background, 0, 0, display, roiOffset.x, roiOffset.y, background.width(), background.height() );
 
@@ -778,6 +778,10 @@ fheroes2::GameMode Interface::AdventureMap::StartGame()
             if ( kingdom.isPlay() ) {
                 DEBUG_LOG( DBG_GAME, DBG_INFO, world.DateString() << ", color: " << Color::String( playerColor ) << ", resource: " << kingdom.GetFunds().String() )
 
+                // Not all changes made during the turns of other players and at the beginning of a new day or week (like the growth
+                // of monsters or changes in the strength of armies) are reported to the pathfinders, so they are evaluated from scratch.
+                world.resetPathfinder();
+
                 _radar.SetHide( true );
                 _radar.SetRedraw( REDRAW_RADAR_CURSOR );
 
@@ -418,6 +418,12 @@ void Interface::GameArea::Redraw( fheroes2::Image & dst, int flag, bool isPuzzle
     const bool renderFog = ( flag & LEVEL_FOG ) == LEVEL_FOG;
 #endif
 
+    // Terrain and static background objects are taken from the cache. Puzzle images hide some objects so they are always rendered directly.
+    const bool useTerrainCache = !isPuzzleDraw && dst.singleLayer();
+    if ( useTerrainCache ) {
+        _terrainCache.render( dst, tileROI, *this );
+    }
+
     // Render terrain.
     for ( int32_t y = 0; y < tileROI.height; ++y ) {
         fheroes2::Point offset( tileROI.x, tileROI.y + y );
@@ -432,7 +438,7 @@ void Interface::GameArea::Redraw( fheroes2::Image & dst, int flag, bool isPuzzle
                 if ( offset.x < 0 || offset.x >= worldWidth ) {
                     Maps::redrawEmptyTile( dst, offset, *this );
                 }
-                else {
+                else if ( !useTerrainCache ) {
                     const Maps::Tile & tile = world.getTile( offset.x, offset.y );
                     // Do not render terrain on the tiles fully covered with the fog.
                     if ( !renderFog || tile.getFogDirection() != DIRECTION_ALL ) {
@@ -606,6 +612,10 @@ void Interface::GameArea::Redraw( fheroes2::Image & dst, int flag, bool isPuzzle
                 continue;
             }
 
+            if ( useTerrainCache && _terrainCache.isBottomLayerRendered( x + offset ) ) {
+                continue;
+            }
+
             // Draw roads, rivers and cracks.
             redrawBottomLayerObjects( tile, dst, isPuzzleDraw, *this, Maps::TERRAIN_LAYER );
 
@@ -30,6 +30,7 @@
 #include <vector>
 
 #include "image.h"
+#include "interface_terrain_cache.h"
 #include "math_base.h"
 #include "mp2.h"
 #include "timing.h"
@@ -289,6 +290,9 @@ namespace Interface
         // This member needs to be mutable because it is modified during rendering.
         mutable std::vector<std::shared_ptr<BaseObjectAnimationInfo>> _animationInfo;
 
+        // This member needs to be mutable because it is modified during rendering.
+        mutable TerrainChunkCache _terrainCache;
+
         fheroes2::Point _lastMouseDragPosition;
         fheroes2::Point _mousePositionForFastScroll;
         bool _mouseDraggingInitiated{ false };
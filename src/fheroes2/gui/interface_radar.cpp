@@ -24,7 +24,9 @@
 #include "interface_radar.h"
 
 #include <cassert>
+#include <cstddef>
 #include <cstring>
+#include <vector>
 
 #include "agg_image.h"
 #include "castle.h"
@@ -137,6 +139,107 @@ namespace
 
         return false;
     }
+
+    struct RadarRevealRules
+    {
+        PlayerColorsSet playerColor{ 0 };
+        bool revealAll{ false };
+        bool revealMines{ false };
+        bool revealHeroes{ false };
+        bool revealTowns{ false };
+        bool revealArtifacts{ false };
+        bool revealResources{ false };
+        bool revealOnlyVisible{ false };
+    };
+
+    // Returns the color of the tile on the radar map. Tiles which should not be shown are black.
+    uint8_t getRadarTileColor( const Maps::Tile & tile, const int32_t x, const int32_t y, const RadarRevealRules & rules )
+    {
+        const bool visibleTile = rules.revealAll || !tile.isFog( rules.playerColor );
+
+        uint8_t fillColor = COLOR_BLACK;
+
+        const MP2::MapObjectType objectType = tile.getMainObjectType( rules.revealOnlyVisible || rules.revealHeroes );
+        switch ( objectType ) {
+        case MP2::OBJ_HERO: {
+            if ( visibleTile || rules.revealHeroes ) {
+                const Heroes * hero = world.GetHeroes( { x, y } );
+                if ( hero ) {
+                    return GetPaletteIndexFromColor( hero->GetColor() );
+                }
+            }
+            return COLOR_BLACK;
+        }
+        case MP2::OBJ_LIGHTHOUSE:
+        case MP2::OBJ_ALCHEMIST_LAB:
+        case MP2::OBJ_MINE:
+        case MP2::OBJ_SAWMILL:
+            // TODO: Why Lighthouse is in this category? Verify the logic!
+            if ( visibleTile || rules.revealMines ) {
+                return GetPaletteIndexFromColor( world.ColorCapturedObject( tile.GetIndex() ) );
+            }
+            return COLOR_BLACK;
+        case MP2::OBJ_NON_ACTION_LIGHTHOUSE:
+        case MP2::OBJ_NON_ACTION_ALCHEMIST_LAB:
+        case MP2::OBJ_NON_ACTION_MINE:
+        case MP2::OBJ_NON_ACTION_SAWMILL:
+            // TODO: Why Lighthouse is in this category? Verify the logic!
+            if ( visibleTile || rules.revealMines ) {
+                const int32_t mainTileIndex = Maps::Tile::getIndexOfMainTile( tile );
+                if ( mainTileIndex >= 0 ) {
+                    return GetPaletteIndexFromColor( world.ColorCapturedObject( mainTileIndex ) );
+                }
+            }
+            return COLOR_BLACK;
+        case MP2::OBJ_ARTIFACT:
+            return ( visibleTile || rules.revealArtifacts ) ? COLOR_GRAY : COLOR_BLACK;
+        case MP2::OBJ_RESOURCE:
+            return ( visibleTile || rules.revealResources ) ? COLOR_GRAY : COLOR_BLACK;
+        default:
+            if ( visibleTile ) {
+                // Castles and Towns can be partially covered by other non-action objects so we need to rely on special storage of castle's tiles.
+                if ( !getCastleColor( fillColor, { x, y } ) ) {
+                    // This is a visible tile and not covered by other objects, so fill it with the ground tile data.
+                    if ( tile.isRoad() ) {
+                        fillColor = COLOR_ROAD;
+                    }
+                    else {
+                        fillColor = GetPaletteIndexFromGround( tile.GetGround() );
+
+                        if ( objectType == MP2::OBJ_MOUNTAINS || objectType == MP2::OBJ_TREES ) {
+                            fillColor += 3;
+                        }
+                    }
+                }
+            }
+            else if ( rules.revealTowns ) {
+                getCastleColor( fillColor, { x, y } );
+            }
+            break;
+        }
+
+        return fillColor;
+    }
+
+    // Fills the area of the tile on the radar map which can be bigger than one pixel for small maps.
+    void renderRadarTile( fheroes2::Image & radar, const double zoom, const int32_t x, const int32_t y, const uint8_t fillColor )
+    {
+        const int32_t radarWidth = radar.width();
+
+        uint8_t * radarX = radar.image() + static_cast<size_t>( y * zoom ) * radarWidth + static_cast<size_t>( x * zoom );
+
+        if ( zoom > 1.0 ) {
+            const size_t radarXStep = static_cast<size_t>( ( x + 1 ) * zoom ) - static_cast<size_t>( x * zoom );
+            const size_t radarYStep = static_cast<size_t>( ( y + 1 ) * zoom ) - static_cast<size_t>( y * zoom );
+
+            for ( size_t i = 0; i < radarYStep; ++i, radarX += radarWidth ) {
+                std::memset( radarX, fillColor, radarXStep );
+            }
+        }
+        else {
+            *radarX = fillColor;
+        }
+    }
 }
 
 Interface::Radar::Radar( BaseInterface & interface )
@@ -179,6 +282,9 @@ void Interface::Radar::Build()
 {
     SetZoom();
     _roi = { 0, 0, world.w(), world.h() };
+
+    // A new map is loaded so colors of all tiles must be generated again.
+    _tileColors.clear();
 }
 
 void Interface::Radar::SetZoom()
@@ -282,140 +388,99 @@ void Interface::Radar::redrawForEditor( const bool renderMapObjects )
 
 void Interface::Radar::RedrawObjects( const PlayerColorsSet playerColor, const ViewWorldMode flags )
 {
+    RadarRevealRules rules;
+    rules.playerColor = playerColor;
+
 #ifdef WITH_DEBUG
-    const bool revealAll = ( flags == ViewWorldMode::ViewAll ) || IS_DEVEL();
+    rules.revealAll = ( flags == ViewWorldMode::ViewAll ) || IS_DEVEL();
 #else
-    const bool revealAll = flags == ViewWorldMode::ViewAll;
+    rules.revealAll = flags == ViewWorldMode::ViewAll;
 #endif
 
-    uint8_t * radarImage = _map.image();
+    rules.revealMines = rules.revealAll || ( flags == ViewWorldMode::ViewMines );
+    rules.revealHeroes = rules.revealAll || ( flags == ViewWorldMode::ViewHeroes );
+    rules.revealTowns = rules.revealAll || ( flags == ViewWorldMode::ViewTowns );
+    rules.revealArtifacts = rules.revealAll || ( flags == ViewWorldMode::ViewArtifacts );
+    rules.revealResources = rules.revealAll || ( flags == ViewWorldMode::ViewResources );
+    rules.revealOnlyVisible = rules.revealAll || ( flags == ViewWorldMode::OnlyVisible );
 
-    assert( _roi.x >= 0 && _roi.y >= 0 && ( _roi.width + _roi.x ) <= world.w() && ( _roi.height + _roi.y ) <= world.h() );
+    const int32_t worldWidth = world.w();
+    const int32_t worldHeight = world.h();
 
-    // Fill the radar map with black color ( 0 ) only if we are redrawing the entire map.
-    if ( _roi.x == 0 && _roi.y == 0 && _roi.width == world.w() && _roi.height == world.h() ) {
-        std::memset( radarImage, COLOR_BLACK, static_cast<size_t>( area.width ) * area.height );
+    assert( _roi.x >= 0 && _roi.y >= 0 && ( _roi.width + _roi.x ) <= worldWidth && ( _roi.height + _roi.y ) <= worldHeight );
+
+    bool isFullRoi = ( _roi.x == 0 && _roi.y == 0 && _roi.width == worldWidth && _roi.height == worldHeight );
+
+    // Only the adventure map radar is redrawn many times for the same player and mode so only this radar keeps colors of all tiles.
+    const bool useTileColors = ( _radarType == RadarType::WorldMap && flags == ViewWorldMode::OnlyVisible );
+    const size_t tileCount = static_cast<size_t>( worldWidth ) * static_cast<size_t>( worldHeight );
+
+    if ( useTileColors && _tileColorsPlayer == playerColor && _tileColors.size() == tileCount ) {
+        // Only the tiles changed since the previous redraw together with the requested area are updated.
+        std::vector<int32_t> tiles = world.takeInvalidatedRadarTiles();
+
+        if ( !isFullRoi ) {
+            for ( int32_t y = _roi.y; y < _roi.y + _roi.height; ++y ) {
+                for ( int32_t x = _roi.x; x < _roi.x + _roi.width; ++x ) {
+                    tiles.push_back( y * worldWidth + x );
+                }
+            }
+        }
+
+        for ( const int32_t tileIndex : tiles ) {
+            const int32_t x = tileIndex % worldWidth;
+            const int32_t y = tileIndex / worldWidth;
+
+            const uint8_t fillColor = getRadarTileColor( world.getTile( tileIndex ), x, y, rules );
+            if ( fillColor != _tileColors[tileIndex] ) {
+                _tileColors[tileIndex] = fillColor;
+                renderRadarTile( _map, _zoom, x, y, fillColor );
+            }
+        }
+
+        _roi = { 0, 0, worldWidth, worldHeight };
+        return;
     }
 
-    const bool revealMines = revealAll || ( flags == ViewWorldMode::ViewMines );
-    const bool revealHeroes = revealAll || ( flags == ViewWorldMode::ViewHeroes );
-    const bool revealTowns = revealAll || ( flags == ViewWorldMode::ViewTowns );
-    const bool revealArtifacts = revealAll || ( flags == ViewWorldMode::ViewArtifacts );
-    const bool revealResources = revealAll || ( flags == ViewWorldMode::ViewResources );
-    const bool revealOnlyVisible = revealAll || ( flags == ViewWorldMode::OnlyVisible );
+    if ( useTileColors ) {
+        // All tiles are going to be rendered so the changes made before are not needed.
+        world.takeInvalidatedRadarTiles();
 
-    const int32_t radarWidth = _map.width();
+        _tileColors.assign( tileCount, COLOR_BLACK );
+        _tileColorsPlayer = playerColor;
 
-    const bool isZoomIn = _zoom > 1.0;
+        _roi = { 0, 0, worldWidth, worldHeight };
+        isFullRoi = true;
+    }
+
+    // Fill the radar map with black color ( 0 ) only if we are redrawing the entire map.
+    if ( isFullRoi ) {
+        std::memset( _map.image(), COLOR_BLACK, static_cast<size_t>( area.width ) * area.height );
+    }
 
     const int32_t maxRoiX = _roi.width + _roi.x;
     const int32_t maxRoiY = _roi.height + _roi.y;
 
-    const uint8_t * radarYEnd = nullptr;
-
     for ( int32_t y = _roi.y; y < maxRoiY; ++y ) {
-        uint8_t * radarY = radarImage + static_cast<size_t>( y * _zoom ) * radarWidth;
-        if ( isZoomIn ) {
-            radarYEnd = radarImage + static_cast<size_t>( ( y + 1 ) * _zoom ) * radarWidth;
-        }
-
         for ( int32_t x = _roi.x; x < maxRoiX; ++x ) {
-            const Maps::Tile & tile = world.getTile( x, y );
-            const bool visibleTile = revealAll || !tile.isFog( playerColor );
-
-            uint8_t fillColor = 0;
-
-            const MP2::MapObjectType objectType = tile.getMainObjectType( revealOnlyVisible || revealHeroes );
-            switch ( objectType ) {
-            case MP2::OBJ_HERO: {
-                if ( visibleTile || revealHeroes ) {
-                    const Heroes * hero = world.GetHeroes( { x, y } );
-                    if ( hero ) {
-                        fillColor = GetPaletteIndexFromColor( hero->GetColor() );
-                        break;
-                    }
-                }
-                continue;
-            }
-            case MP2::OBJ_LIGHTHOUSE:
-            case MP2::OBJ_ALCHEMIST_LAB:
-            case MP2::OBJ_MINE:
-            case MP2::OBJ_SAWMILL:
-                // TODO: Why Lighthouse is in this category? Verify the logic!
-                if ( visibleTile || revealMines ) {
-                    fillColor = GetPaletteIndexFromColor( world.ColorCapturedObject( tile.GetIndex() ) );
-                    break;
-                }
-                continue;
-            case MP2::OBJ_NON_ACTION_LIGHTHOUSE:
-            case MP2::OBJ_NON_ACTION_ALCHEMIST_LAB:
-            case MP2::OBJ_NON_ACTION_MINE:
-            case MP2::OBJ_NON_ACTION_SAWMILL:
-                // TODO: Why Lighthouse is in this category? Verify the logic!
-                if ( visibleTile || revealMines ) {
-                    const int32_t mainTileIndex = Maps::Tile::getIndexOfMainTile( tile );
-                    if ( mainTileIndex >= 0 ) {
-                        fillColor = GetPaletteIndexFromColor( world.ColorCapturedObject( mainTileIndex ) );
-                        break;
-                    }
-                }
-                continue;
-            case MP2::OBJ_ARTIFACT:
-                if ( visibleTile || revealArtifacts ) {
-                    fillColor = COLOR_GRAY;
-                    break;
-                }
-                continue;
-            case MP2::OBJ_RESOURCE:
-                if ( visibleTile || revealResources ) {
-                    fillColor = COLOR_GRAY;
-                    break;
-                }
-                continue;
-            default:
-                if ( visibleTile ) {
-                    // Castles and Towns can be partially covered by other non-action objects so we need to rely on special storage of castle's tiles.
-                    if ( !getCastleColor( fillColor, { x, y } ) ) {
-                        // This is a visible tile and not covered by other objects, so fill it with the ground tile data.
-                        if ( tile.isRoad() ) {
-                            fillColor = COLOR_ROAD;
-                        }
-                        else {
-                            fillColor = GetPaletteIndexFromGround( tile.GetGround() );
+            const int32_t tileIndex = y * worldWidth + x;
+            const uint8_t fillColor = getRadarTileColor( world.getTile( tileIndex ), x, y, rules );
 
-                            if ( objectType == MP2::OBJ_MOUNTAINS || objectType == MP2::OBJ_TREES ) {
-                                fillColor += 3;
-                            }
-                        }
-                    }
-                }
-                else if ( revealTowns ) {
-                    getCastleColor( fillColor, { x, y } );
-                }
-                else {
-                    // Non visible tile, we have already black radar so skip the render of this tile.
-                    continue;
-                }
+            if ( useTileColors ) {
+                _tileColors[tileIndex] = fillColor;
             }
 
-            const size_t offsetX = static_cast<size_t>( x * _zoom );
-            uint8_t * radarX = radarY + offsetX;
-            if ( isZoomIn ) {
-                const uint8_t * radarXEnd = radarYEnd + offsetX;
-                const size_t radarXStep = static_cast<size_t>( ( x + 1 ) * _zoom ) - offsetX;
-
-                for ( ; radarX != radarXEnd; radarX += radarWidth ) {
-                    std::memset( radarX, fillColor, radarXStep );
-                }
-            }
-            else {
-                *radarX = fillColor;
+            if ( isFullRoi && fillColor == COLOR_BLACK ) {
+                // The radar map is already black.
+                continue;
             }
+
+            renderRadarTile( _map, _zoom, x, y, fillColor );
         }
     }
 
     // Reset ROI to full radar image to be able to redraw the mini-map without calling 'SetMapRedraw()'.
-    _roi = { 0, 0, world.w(), world.h() };
+    _roi = { 0, 0, worldWidth, worldHeight };
 }
 
 // Redraw radar cursor. RoiRectangle is a rectangle in tile unit of the current radar view.
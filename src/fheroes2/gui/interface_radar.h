@@ -24,6 +24,7 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
 
 #include "color.h"
 #include "image.h"
@@ -96,6 +97,11 @@ namespace Interface
         BaseInterface & _interface;
 
         fheroes2::Image _map;
+
+        // Radar map colors of all tiles for the player used in the last OnlyVisible mode redraw. Only the changed tiles are rendered again.
+        std::vector<uint8_t> _tileColors;
+        PlayerColorsSet _tileColorsPlayer{ 0 };
+
         fheroes2::MovableSprite _cursorArea;
         fheroes2::Rect _roi;
         double _zoom{ 1.0 };
@@ -0,0 +1,197 @@
+/***************************************************************************
+ *   fheroes2: https://github.com/ihhub/fheroes2                           *
+ *   Copyright (C) 2025                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "interface_terrain_cache.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#include "interface_gamearea.h"
+#include "maps_tiles.h"
+#include "maps_tiles_render.h"
+#include "ui_constants.h"
+#include "world.h"
+
+namespace
+{
+    // The size of a chunk side in tiles.
+    const int32_t chunkSize = 8;
+
+    // Chunks which are not visible anymore are kept for a while in case of scrolling back. The limit is never less than this value.
+    const size_t minCachedChunkCount = 64;
+
+    void addToHash( uint64_t & hash, const uint32_t value )
+    {
+        // FNV-1a hash.
+        hash ^= value;
+        hash *= 0x100000001b3ULL;
+    }
+}
+
+namespace Interface
+{
+    void TerrainChunkCache::render( fheroes2::Image & output, const fheroes2::Rect & tileRoi, const GameArea & area )
+    {
+        const int32_t worldWidth = world.w();
+        const int32_t worldHeight = world.h();
+
+        if ( _worldSize.width != worldWidth || _worldSize.height != worldHeight ) {
+            clear();
+
+            _worldSize = { worldWidth, worldHeight };
+            _staticTiles.resize( static_cast<size_t>( worldWidth ) * static_cast<size_t>( worldHeight ), 0 );
+        }
+
+        const int32_t minX = std::max( tileRoi.x, 0 );
+        const int32_t minY = std::max( tileRoi.y, 0 );
+        const int32_t maxX = std::min( tileRoi.x + tileRoi.width, worldWidth );
+        const int32_t maxY = std::min( tileRoi.y + tileRoi.height, worldHeight );
+
+        if ( minX >= maxX || minY >= maxY ) {
+            return;
+        }
+
+        ++_frameId;
+
+        const int32_t chunkColumns = ( worldWidth + chunkSize - 1 ) / chunkSize;
+        const fheroes2::Rect & windowRoi = area.GetROI();
+
+        size_t visibleChunkCount = 0;
+
+        for ( int32_t chunkY = minY / chunkSize; chunkY <= ( maxY - 1 ) / chunkSize; ++chunkY ) {
+            for ( int32_t chunkX = minX / chunkSize; chunkX <= ( maxX - 1 ) / chunkSize; ++chunkX ) {
+                const fheroes2::Rect chunkTileRoi{ chunkX * chunkSize, chunkY * chunkSize, std::min( chunkSize, worldWidth - chunkX * chunkSize ),
+                                                   std::min( chunkSize, worldHeight - chunkY * chunkSize ) };
+
+                const uint64_t hash = _updateChunkTiles( chunkTileRoi, area );
+
+                Chunk & chunk = _chunks[chunkY * chunkColumns + chunkX];
+                if ( chunk.image.empty() || chunk.hash != hash ) {
+                    _renderChunk( chunk, chunkTileRoi );
+                    chunk.hash = hash;
+                }
+
+                chunk.lastUsedFrameId = _frameId;
+                ++visibleChunkCount;
+
+                const fheroes2::Point chunkOffset = area.GetRelativeTilePosition( chunkTileRoi.getPosition() );
+                const fheroes2::Rect chunkRoi{ chunkOffset.x, chunkOffset.y, chunk.image.width(), chunk.image.height() };
+                const fheroes2::Rect overlappedRoi = windowRoi ^ chunkRoi;
+
+                fheroes2::Copy( chunk.image, overlappedRoi.x - chunkRoi.x, overlappedRoi.y - chunkRoi.y, output, overlappedRoi.x, overlappedRoi.y, overlappedRoi.width,
+                                overlappedRoi.height );
+            }
+        }
+
+        _removeUnusedChunks( std::max( 2 * visibleChunkCount, minCachedChunkCount ) );
+    }
+
+    uint64_t TerrainChunkCache::_updateChunkTiles( const fheroes2::Rect & chunkTileRoi, const GameArea & area )
+    {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+
+        const int32_t worldWidth = _worldSize.width;
+
+        for ( int32_t y = chunkTileRoi.y; y < chunkTileRoi.y + chunkTileRoi.height; ++y ) {
+            for ( int32_t x = chunkTileRoi.x; x < chunkTileRoi.x + chunkTileRoi.width; ++x ) {
+                const int32_t tileIndex = y * worldWidth + x;
+                const Maps::Tile & tile = world.getTile( tileIndex );
+
+                const bool isStatic = Maps::isBottomLayerStatic( tile, area );
+                _staticTiles[tileIndex] = isStatic ? 1 : 0;
+
+                addToHash( hash, tile.getTerrainImageIndex() );
+                addToHash( hash, tile.getTerrainFlags() );
+                addToHash( hash, isStatic ? 1 : 0 );
+
+                if ( !isStatic ) {
+                    // Only terrain image of the tile is a part of the chunk.
+                    continue;
+                }
+
+                const auto addPart = [&hash]( const Maps::ObjectPart & part ) {
+                    if ( part.layerType == Maps::TERRAIN_LAYER || part.layerType == Maps::BACKGROUND_LAYER ) {
+                        addToHash( hash, ( static_cast<uint32_t>( part.layerType ) << 16 ) | ( static_cast<uint32_t>( part.icnType ) << 8 ) | part.icnIndex );
+                    }
+                };
+
+                for ( const auto & part : tile.getGroundObjectParts() ) {
+                    addPart( part );
+                }
+
+                if ( tile.getMainObjectPart().icnType != MP2::OBJ_ICN_TYPE_UNKNOWN ) {
+                    addPart( tile.getMainObjectPart() );
+                }
+            }
+        }
+
+        return hash;
+    }
+
+    void TerrainChunkCache::_renderChunk( Chunk & chunk, const fheroes2::Rect & chunkTileRoi ) const
+    {
+        chunk.image.resize( chunkTileRoi.width * fheroes2::tileWidthPx, chunkTileRoi.height * fheroes2::tileWidthPx );
+        chunk.image._disableTransformLayer();
+
+        const int32_t worldWidth = _worldSize.width;
+
+        for ( int32_t y = 0; y < chunkTileRoi.height; ++y ) {
+            for ( int32_t x = 0; x < chunkTileRoi.width; ++x ) {
+                const int32_t tileIndex = ( chunkTileRoi.y + y ) * worldWidth + chunkTileRoi.x + x;
+                const Maps::Tile & tile = world.getTile( tileIndex );
+
+                const fheroes2::Point offset{ x * fheroes2::tileWidthPx, y * fheroes2::tileWidthPx };
+
+                const fheroes2::Image & terrain = Maps::getTileSurface( tile );
+                fheroes2::Copy( terrain, 0, 0, chunk.image, offset.x, offset.y, terrain.width(), terrain.height() );
+
+                if ( _staticTiles[tileIndex] != 0 ) {
+                    Maps::redrawStaticBottomLayerObjects( tile, chunk.image, offset );
+                }
+            }
+        }
+    }
+
+    void TerrainChunkCache::_removeUnusedChunks( const size_t maxChunkCount )
+    {
+        if ( _chunks.size() <= maxChunkCount ) {
+            return;
+        }
+
+        std::vector<std::pair<uint32_t, int32_t>> unusedChunks;
+        for ( const auto & [chunkId, chunk] : _chunks ) {
+            if ( chunk.lastUsedFrameId != _frameId ) {
+                unusedChunks.emplace_back( chunk.lastUsedFrameId, chunkId );
+            }
+        }
+
+        // The least recently used chunks are removed first.
+        std::sort( unusedChunks.begin(), unusedChunks.end() );
+
+        for ( const auto & [frameId, chunkId] : unusedChunks ) {
+            if ( _chunks.size() <= maxChunkCount ) {
+                break;
+            }
+
+            _chunks.erase( chunkId );
+        }
+    }
+}
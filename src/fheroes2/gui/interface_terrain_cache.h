@@ -0,0 +1,80 @@
+/***************************************************************************
+ *   fheroes2: https://github.com/ihhub/fheroes2                           *
+ *   Copyright (C) 2025                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "image.h"
+#include "math_base.h"
+
+namespace Interface
+{
+    class GameArea;
+
+    // Terrain images together with roads, streams and other static background objects are rendered into square chunks of tiles.
+    // On every frame the visible chunks are copied to the output instead of rendering each tile separately.
+    // A chunk is rendered again only when any of its tiles has been changed.
+    class TerrainChunkCache
+    {
+    public:
+        // Renders terrain of all tiles within the given area (in tiles) which belong to the world.
+        void render( fheroes2::Image & output, const fheroes2::Rect & tileRoi, const GameArea & area );
+
+        // Returns true if terrain and background layer objects of the tile have been rendered by the last render() call.
+        bool isBottomLayerRendered( const int32_t tileIndex ) const
+        {
+            return tileIndex >= 0 && static_cast<size_t>( tileIndex ) < _staticTiles.size() && _staticTiles[tileIndex] != 0;
+        }
+
+        void clear()
+        {
+            _chunks.clear();
+            _staticTiles.clear();
+            _worldSize = {};
+        }
+
+    private:
+        struct Chunk
+        {
+            fheroes2::Image image;
+            uint64_t hash{ 0 };
+            uint32_t lastUsedFrameId{ 0 };
+        };
+
+        std::map<int32_t, Chunk> _chunks;
+
+        // Tiles whose background layer objects are a part of a chunk image.
+        std::vector<uint8_t> _staticTiles;
+
+        fheroes2::Size _worldSize;
+
+        uint32_t _frameId{ 0 };
+
+        uint64_t _updateChunkTiles( const fheroes2::Rect & chunkTileRoi, const GameArea & area );
+
+        void _renderChunk( Chunk & chunk, const fheroes2::Rect & chunkTileRoi ) const;
+
+        void _removeUnusedChunks( const size_t maxChunkCount );
+    };
+}
@@ -299,8 +299,17 @@ namespace fheroes2
             info += std::to_string( static_cast<int32_t>( ( averageFps - currentFps ) * 10 ) );
         }
 
-        _text.update( std::make_unique<fheroes2::Text>( std::move( info ), fheroes2::FontType::normalWhite() ) );
+        auto text = std::make_unique<fheroes2::Text>( std::move( info ), fheroes2::FontType::normalWhite() );
+
+        fheroes2::Rect textArea = text->area();
+        textArea.x += offsetX;
+        textArea.y += offsetY;
+
+        _text.update( std::move( text ) );
         _text.draw( offsetX, offsetY );
+
+        // During color cycling only areas with cycling colors are rendered so the text area has to be rendered explicitly.
+        fheroes2::Display::instance().updateNextRenderRoi( textArea );
     }
 
     TimedEventValidator::TimedEventValidator( std::function<bool()> verification, const uint64_t delayBeforeFirstUpdateMs, const uint64_t delayBetweenUpdateMs )
@@ -26,6 +26,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <cstdlib>
 #include <ostream>
 
@@ -35,6 +36,8 @@
 #include "heroes.h"
 #include "kingdom.h"
 #include "logging.h"
+#include "maps_fog.h"
+#include "maps_object_index.h"
 #include "maps_tiles.h"
 #include "maps_tiles_helper.h"
 #include "mp2.h"
@@ -59,13 +62,36 @@ namespace
 
     Maps::Indexes MapsIndexesObject( const MP2::MapObjectType objectType, const bool ignoreHeroes )
     {
+        const Maps::ObjectTypeIndex & objectTypeIndex = world.getObjectTypeIndex();
+
         Maps::Indexes result;
-        const int32_t size = static_cast<int32_t>( world.getSize() );
-        for ( int32_t idx = 0; idx < size; ++idx ) {
-            if ( world.getTile( idx ).getMainObjectType( !ignoreHeroes ) == objectType ) {
-                result.push_back( idx );
+
+        if ( !objectTypeIndex.isBuilt() ) {
+            const int32_t size = static_cast<int32_t>( world.getSize() );
+            for ( int32_t idx = 0; idx < size; ++idx ) {
+                if ( world.getTile( idx ).getMainObjectType( !ignoreHeroes ) == objectType ) {
+                    result.push_back( idx );
+                }
+            }
+            return result;
+        }
+
+        if ( !ignoreHeroes || objectType != MP2::OBJ_HERO ) {
+            result = objectTypeIndex.getTiles( objectType );
+        }
+
+        if ( ignoreHeroes ) {
+            // Heroes hide objects they are standing on.
+            for ( const int32_t idx : objectTypeIndex.getTiles( MP2::OBJ_HERO ) ) {
+                if ( world.getTile( idx ).getMainObjectType( false ) == objectType ) {
+                    result.push_back( idx );
+                }
             }
         }
+
+        // Keep the order of the whole map scan.
+        std::sort( result.begin(), result.end() );
+
         return result;
     }
 
@@ -91,6 +117,41 @@ namespace
 
         return squaredDistanceLimit;
     }
+
+    // Circular masks are precomputed for scouting distances up to this one. Larger distances are handled by checking every tile.
+    const int32_t maxPrecomputedScoutingDistance = 32;
+
+    // Returns the largest horizontal distance from the center of the scouting area for every row of it, from the topmost row to the bottommost one.
+    const std::vector<int32_t> & getScoutingAreaRowHalfWidths( const int32_t scoutingDistance )
+    {
+        static const std::vector<std::vector<int32_t>> rowHalfWidths = []() {
+            std::vector<std::vector<int32_t>> result( maxPrecomputedScoutingDistance + 1 );
+
+            for ( int32_t distance = 1; distance <= maxPrecomputedScoutingDistance; ++distance ) {
+                const int32_t squaredScoutingRadiusLimit = getSquaredScoutingRadiusLimit( distance );
+
+                std::vector<int32_t> & halfWidths = result[distance];
+                halfWidths.reserve( 2 * distance + 1 );
+
+                for ( int32_t dy = -distance; dy <= distance; ++dy ) {
+                    int32_t halfWidth = distance;
+                    while ( halfWidth * halfWidth + dy * dy >= squaredScoutingRadiusLimit ) {
+                        --halfWidth;
+                    }
+
+                    // The center of every row is always within the scouting area.
+                    assert( halfWidth >= 0 );
+                    halfWidths.push_back( halfWidth );
+                }
+            }
+
+            return result;
+        }();
+
+        assert( scoutingDistance > 0 && scoutingDistance <= maxPrecomputedScoutingDistance );
+
+        return rowHalfWidths[scoutingDistance];
+    }
 }
 
 struct ComparisonDistance
@@ -401,30 +462,57 @@ void Maps::ClearFog( const int32_t tileIndex, const int32_t scoutingDistance, co
     fheroes2::Point fogRevealMinPos( world.h(), worldWidth );
     fheroes2::Point fogRevealMaxPos( 0, 0 );
 
-    for ( int32_t y = minY; y <= maxY; ++y ) {
-        const int32_t dy = y - center.y;
-        const int32_t dySquared = dy * dy;
-        const int32_t offset = y * worldWidth;
+    const auto revealTile = [&kingdom, &fogRevealMinPos, &fogRevealMaxPos, isAIPlayer, isHumanOrHumanFriend, playerColor, alliedColors]( Maps::Tile & tile ) {
+        if ( isAIPlayer && tile.isFog( playerColor ) ) {
+            AI::Planner::Get().revealFog( tile, kingdom );
+        }
 
-        for ( int32_t x = minX; x <= maxX; ++x ) {
-            const int32_t dx = x - center.x;
-            if ( dx * dx + dySquared < squaredScoutingRadiusLimit ) {
-                Maps::Tile & tile = world.getTile( x + offset );
-                if ( isAIPlayer && tile.isFog( playerColor ) ) {
-                    AI::Planner::Get().revealFog( tile, kingdom );
-                }
+        if ( tile.isFog( alliedColors ) ) {
+            // Clear fog only if it is not already cleared.
+            tile.ClearFog( alliedColors );
 
-                if ( tile.isFog( alliedColors ) ) {
-                    // Clear fog only if it is not already cleared.
-                    tile.ClearFog( alliedColors );
+            if ( isHumanOrHumanFriend ) {
+                // Update fog reveal area points only for human player and his allies.
+                const fheroes2::Point tilePos = Maps::GetPoint( tile.GetIndex() );
 
-                    if ( isHumanOrHumanFriend ) {
-                        // Update fog reveal area points only for human player and his allies.
-                        fogRevealMinPos.x = std::min( fogRevealMinPos.x, x );
-                        fogRevealMinPos.y = std::min( fogRevealMinPos.y, y );
-                        fogRevealMaxPos.x = std::max( fogRevealMaxPos.x, x );
-                        fogRevealMaxPos.y = std::max( fogRevealMaxPos.y, y );
-                    }
+                fogRevealMinPos.x = std::min( fogRevealMinPos.x, tilePos.x );
+                fogRevealMinPos.y = std::min( fogRevealMinPos.y, tilePos.y );
+                fogRevealMaxPos.x = std::max( fogRevealMaxPos.x, tilePos.x );
+                fogRevealMaxPos.y = std::max( fogRevealMaxPos.y, tilePos.y );
+            }
+        }
+    };
+
+    const Maps::FogBitplanes & fogBitplanes = world.getFogBitplanes();
+
+    if ( fogBitplanes.isBuilt() && scoutingDistance <= maxPrecomputedScoutingDistance ) {
+        // Only the fogged tiles have to be visited, so they are taken from the bitplanes of the player and his allies row by row.
+        const std::vector<int32_t> & rowHalfWidths = getScoutingAreaRowHalfWidths( scoutingDistance );
+        const PlayerColorsSet fogColors = alliedColors | playerColor;
+
+        std::vector<int32_t> fogTiles;
+
+        for ( int32_t y = minY; y <= maxY; ++y ) {
+            const int32_t halfWidth = rowHalfWidths[y - center.y + scoutingDistance];
+
+            fogTiles.clear();
+            fogBitplanes.getFogTiles( y, std::max( center.x - halfWidth, minX ), std::min( center.x + halfWidth, maxX ), fogColors, fogTiles );
+
+            for ( const int32_t fogTileIndex : fogTiles ) {
+                revealTile( world.getTile( fogTileIndex ) );
+            }
+        }
+    }
+    else {
+        for ( int32_t y = minY; y <= maxY; ++y ) {
+            const int32_t dy = y - center.y;
+            const int32_t dySquared = dy * dy;
+            const int32_t offset = y * worldWidth;
+
+            for ( int32_t x = minX; x <= maxX; ++x ) {
+                const int32_t dx = x - center.x;
+                if ( dx * dx + dySquared < squaredScoutingRadiusLimit ) {
+                    revealTile( world.getTile( x + offset ) );
                 }
             }
         }
@@ -459,6 +547,21 @@ int32_t Maps::getFogTileCountToBeRevealed( const int32_t tileIndex, const int32_
 
     int32_t tileCount = 0;
 
+    const Maps::FogBitplanes & fogBitplanes = world.getFogBitplanes();
+
+    if ( fogBitplanes.isBuilt() && scoutingDistance <= maxPrecomputedScoutingDistance ) {
+        const std::vector<int32_t> & rowHalfWidths = getScoutingAreaRowHalfWidths( scoutingDistance );
+
+        for ( int32_t y = minY; y <= maxY; ++y ) {
+            const int32_t halfWidth = rowHalfWidths[y - center.y + scoutingDistance];
+
+            tileCount += fogBitplanes.countFogTiles( y, std::max( center.x - halfWidth, minX ), std::min( center.x + halfWidth, maxX ),
+                                                     static_cast<PlayerColorsSet>( playerColor ) );
+        }
+
+        return tileCount;
+    }
+
     for ( int32_t y = minY; y <= maxY; ++y ) {
         const int32_t dy = y - center.y;
         const int32_t dySquared = dy * dy;
@@ -505,14 +608,7 @@ Maps::Indexes Maps::ScanAroundObjectWithDistance( const int32_t center, const ui
 
 bool Maps::doesObjectExistOnMap( const MP2::MapObjectType objectType )
 {
-    const int32_t size = static_cast<int32_t>( world.getSize() );
-    for ( int32_t idx = 0; idx < size; ++idx ) {
-        if ( world.getTile( idx ).getMainObjectType( false ) == objectType ) {
-            return true;
-        }
-    }
-
-    return false;
+    return !MapsIndexesObject( objectType, true ).empty();
 }
 
 Maps::Indexes Maps::GetObjectPositions( const MP2::MapObjectType objectType )
@@ -535,15 +631,39 @@ std::vector<std::pair<int32_t, const Maps::ObjectPart *>> Maps::getObjectParts(
 }
 
 Maps::Indexes Maps::GetObjectPositions( int32_t center, const MP2::MapObjectType objectType, bool ignoreHeroes )
+{
+    return getNearestObjectPositions( center, objectType, world.getSize(), ignoreHeroes );
+}
+
+Maps::Indexes Maps::getNearestObjectPositions( const int32_t center, const MP2::MapObjectType objectType, const size_t maxCount, const bool ignoreHeroes )
 {
     Indexes results = MapsIndexesObject( objectType, ignoreHeroes );
-    std::sort( results.begin(), results.end(), ComparisonDistance( center ) );
+
+    // Tiles at the same distance are ordered by their indexes so the result does not depend on the number of requested tiles.
+    const ComparisonDistance isCloser( center );
+    const auto compare = [&isCloser]( const int32_t index1, const int32_t index2 ) {
+        if ( isCloser( index1, index2 ) ) {
+            return true;
+        }
+
+        return !isCloser( index2, index1 ) && index1 < index2;
+    };
+
+    if ( results.size() > maxCount ) {
+        std::partial_sort( results.begin(), results.begin() + static_cast<ptrdiff_t>( maxCount ), results.end(), compare );
+        results.resize( maxCount );
+    }
+    else {
+        std::sort( results.begin(), results.end(), compare );
+    }
+
     return results;
 }
 
 bool Maps::isTileUnderProtection( const int32_t tileIndex )
 {
-    return world.getTile( tileIndex ).getMainObjectType() == MP2::OBJ_MONSTER ? true : !getMonstersProtectingTile( tileIndex ).empty();
+    // A tile with a monster is always protected by this monster.
+    return world.getProtectingMonsterDirections( tileIndex ) != Direction::UNKNOWN;
 }
 
 Maps::Indexes Maps::getMonstersProtectingTile( const int32_t tileIndex, const bool checkObjectOnTile /* = true */ )
@@ -552,22 +672,39 @@ Maps::Indexes Maps::getMonstersProtectingTile( const int32_t tileIndex, const bo
         return {};
     }
 
+    const int directions = checkObjectOnTile ? world.getProtectingMonsterDirections( tileIndex ) : calculateProtectingMonsterDirections( tileIndex, false );
+    if ( directions == Direction::UNKNOWN ) {
+        return {};
+    }
+
     Indexes result;
+    result.reserve( 9 );
+
+    // Monsters are listed row by row starting from the top left corner.
+    for ( const int direction : { Direction::TOP_LEFT, Direction::TOP, Direction::TOP_RIGHT, Direction::LEFT, Direction::CENTER, Direction::RIGHT, Direction::BOTTOM_LEFT,
+                                  Direction::BOTTOM, Direction::BOTTOM_RIGHT } ) {
+        if ( ( directions & direction ) == 0 ) {
+            continue;
+        }
+
+        result.push_back( direction == Direction::CENTER ? tileIndex : GetDirectionIndex( tileIndex, direction ) );
+    }
+
+    return result;
+}
+
+int Maps::calculateProtectingMonsterDirections( const int32_t tileIndex, const bool checkObjectOnTile )
+{
+    assert( isValidAbsIndex( tileIndex ) );
 
     const Maps::Tile & tile = world.getTile( tileIndex );
 
     // If a tile contains an object that you can interact with without visiting this tile, then this interaction doesn't trigger a monster attack...
     if ( checkObjectOnTile && MP2::isNeedStayFront( tile.getMainObjectType() ) ) {
         // ... unless the tile itself contains a monster
-        if ( tile.getMainObjectType() == MP2::OBJ_MONSTER ) {
-            result.push_back( tileIndex );
-        }
-
-        return result;
+        return tile.getMainObjectType() == MP2::OBJ_MONSTER ? Direction::CENTER : Direction::UNKNOWN;
     }
 
-    result.reserve( 9 );
-
     const int width = world.w();
     const int x = tileIndex % width;
     const int y = tileIndex / width;
@@ -605,49 +742,51 @@ Maps::Indexes Maps::getMonstersProtectingTile( const int32_t tileIndex, const bo
         return false;
     };
 
-    const auto validateAndAdd = [&result, &isProtectedBy]( const int monsterTileIndex ) {
-        if ( isProtectedBy( monsterTileIndex ) ) {
-            result.push_back( monsterTileIndex );
+    int directions = Direction::UNKNOWN;
+
+    const auto validateAndAdd = [tileIndex, &directions, &isProtectedBy]( const int direction ) {
+        if ( isProtectedBy( GetDirectionIndex( tileIndex, direction ) ) ) {
+            directions |= direction;
         }
     };
 
     if ( y > 0 ) {
         if ( x > 0 ) {
-            validateAndAdd( tileIndex - width - 1 );
+            validateAndAdd( Direction::TOP_LEFT );
         }
 
-        validateAndAdd( tileIndex - width );
+        validateAndAdd( Direction::TOP );
 
         if ( x < width - 1 ) {
-            validateAndAdd( tileIndex - width + 1 );
+            validateAndAdd( Direction::TOP_RIGHT );
         }
     }
 
     if ( x > 0 ) {
-        validateAndAdd( tileIndex - 1 );
+        validateAndAdd( Direction::LEFT );
     }
 
     if ( tile.getMainObjectType() == MP2::OBJ_MONSTER ) {
-        result.push_back( tileIndex );
+        directions |= Direction::CENTER;
     }
 
     if ( x < width - 1 ) {
-        validateAndAdd( tileIndex + 1 );
+        validateAndAdd( Direction::RIGHT );
     }
 
     if ( y < world.h() - 1 ) {
         if ( x > 0 ) {
-            validateAndAdd( tileIndex + width - 1 );
+            validateAndAdd( Direction::BOTTOM_LEFT );
         }
 
-        validateAndAdd( tileIndex + width );
+        validateAndAdd( Direction::BOTTOM );
 
         if ( x < width - 1 ) {
-            validateAndAdd( tileIndex + width + 1 );
+            validateAndAdd( Direction::BOTTOM_RIGHT );
         }
     }
 
-    return result;
+    return directions;
 }
 
 uint32_t Maps::GetApproximateDistance( const int32_t pos1, const int32_t pos2 )
@@ -24,6 +24,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <utility>
 #include <vector>
@@ -91,6 +92,10 @@ namespace Maps
     // tile without triggering a monster attack.
     Indexes getMonstersProtectingTile( const int32_t tileIndex, const bool checkObjectOnTile = true );
 
+    // Returns a combination of directions from the tile to the monsters protecting it, including Direction::CENTER if the tile
+    // contains a monster itself. The result is always calculated from the current state of the tiles.
+    int calculateProtectingMonsterDirections( const int32_t tileIndex, const bool checkObjectOnTile );
+
     // This function always ignores heroes.
     bool doesObjectExistOnMap( const MP2::MapObjectType objectType );
 
@@ -100,8 +105,12 @@ namespace Maps
     // This is a very slow function by performance. Use it only while loading a map.
     std::vector<std::pair<int32_t, const ObjectPart *>> getObjectParts( const MP2::MapObjectType objectType );
 
+    // Returns tiles sorted by distance to the center tile.
     Indexes GetObjectPositions( int32_t center, const MP2::MapObjectType objectType, bool ignoreHeroes );
 
+    // Returns no more than the given number of the nearest to the center tiles, sorted by distance.
+    Indexes getNearestObjectPositions( const int32_t center, const MP2::MapObjectType objectType, const size_t maxCount, const bool ignoreHeroes );
+
     void ClearFog( const int32_t tileIndex, const int32_t scoutingDistance, const PlayerColor playerColor );
     int32_t getFogTileCountToBeRevealed( const int32_t tileIndex, const int32_t scoutingDistance, const PlayerColor playerColor );
 
@@ -0,0 +1,179 @@
+/***************************************************************************
+ *   fheroes2: https://github.com/ihhub/fheroes2                           *
+ *   Copyright (C) 2025                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "maps_fog.h"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+
+#include "maps_tiles.h"
+
+namespace
+{
+    const int32_t bitsPerWord = 64;
+
+    // Player colors in the order of their bitplanes.
+    const std::array<PlayerColor, 6> planeColors{ PlayerColor::BLUE,   PlayerColor::GREEN,  PlayerColor::RED,
+                                                  PlayerColor::YELLOW, PlayerColor::ORANGE, PlayerColor::PURPLE };
+
+    int countBits( uint64_t value )
+    {
+        // Counting bits in parallel within the word as std::popcount() is not available in C++17.
+        value = value - ( ( value >> 1 ) & 0x5555555555555555 );
+        value = ( value & 0x3333333333333333 ) + ( ( value >> 2 ) & 0x3333333333333333 );
+        value = ( value + ( value >> 4 ) ) & 0x0F0F0F0F0F0F0F0F;
+
+        return static_cast<int>( ( value * 0x0101010101010101 ) >> 56 );
+    }
+
+    // Returns the mask of bits of the word which belong to [minX, maxX] columns.
+    uint64_t getColumnMask( const int32_t wordId, const int32_t minX, const int32_t maxX )
+    {
+        uint64_t mask = ~static_cast<uint64_t>( 0 );
+
+        if ( wordId == minX / bitsPerWord ) {
+            mask &= mask << ( minX % bitsPerWord );
+        }
+        if ( wordId == maxX / bitsPerWord ) {
+            mask &= ~static_cast<uint64_t>( 0 ) >> ( bitsPerWord - 1 - maxX % bitsPerWord );
+        }
+
+        return mask;
+    }
+}
+
+namespace Maps
+{
+    void FogBitplanes::build( const std::vector<Tile> & tiles, const int32_t width )
+    {
+        clear();
+
+        if ( width <= 0 || tiles.empty() ) {
+            return;
+        }
+
+        assert( tiles.size() % width == 0 );
+
+        _width = width;
+        _wordsPerRow = ( width + bitsPerWord - 1 ) / bitsPerWord;
+
+        const int32_t height = static_cast<int32_t>( tiles.size() ) / width;
+
+        for ( size_t colorId = 0; colorId < _planes.size(); ++colorId ) {
+            _planes[colorId].resize( static_cast<size_t>( _wordsPerRow ) * height, 0 );
+        }
+
+        for ( const Tile & tile : tiles ) {
+            const int32_t tileIndex = tile.GetIndex();
+            const size_t wordOffset = static_cast<size_t>( tileIndex / width ) * _wordsPerRow + ( tileIndex % width ) / bitsPerWord;
+            const uint64_t bit = static_cast<uint64_t>( 1 ) << ( ( tileIndex % width ) % bitsPerWord );
+
+            for ( size_t colorId = 0; colorId < _planes.size(); ++colorId ) {
+                if ( tile.isFog( planeColors[colorId] ) ) {
+                    _planes[colorId][wordOffset] |= bit;
+                }
+            }
+        }
+    }
+
+    void FogBitplanes::clear()
+    {
+        _width = 0;
+        _wordsPerRow = 0;
+
+        for ( std::vector<uint64_t> & plane : _planes ) {
+            plane.clear();
+        }
+    }
+
+    void FogBitplanes::clearFog( const int32_t tileIndex, const PlayerColorsSet colors )
+    {
+        if ( !isBuilt() ) {
+            return;
+        }
+
+        assert( tileIndex >= 0 );
+
+        const size_t wordOffset = static_cast<size_t>( tileIndex / _width ) * _wordsPerRow + ( tileIndex % _width ) / bitsPerWord;
+        const uint64_t bit = static_cast<uint64_t>( 1 ) << ( ( tileIndex % _width ) % bitsPerWord );
+
+        for ( size_t colorId = 0; colorId < _planes.size(); ++colorId ) {
+            if ( colors & planeColors[colorId] ) {
+                assert( wordOffset < _planes[colorId].size() );
+
+                _planes[colorId][wordOffset] &= ~bit;
+            }
+        }
+    }
+
+    int32_t FogBitplanes::countFogTiles( const int32_t y, const int32_t minX, const int32_t maxX, const PlayerColorsSet colors ) const
+    {
+        assert( isBuilt() );
+        assert( minX >= 0 && minX <= maxX && maxX < _width );
+
+        const size_t rowOffset = static_cast<size_t>( y ) * _wordsPerRow;
+        const int32_t lastWordId = maxX / bitsPerWord;
+
+        int32_t tileCount = 0;
+
+        for ( int32_t wordId = minX / bitsPerWord; wordId <= lastWordId; ++wordId ) {
+            tileCount += countBits( _getFogWord( rowOffset + wordId, colors ) & getColumnMask( wordId, minX, maxX ) );
+        }
+
+        return tileCount;
+    }
+
+    void FogBitplanes::getFogTiles( const int32_t y, const int32_t minX, const int32_t maxX, const PlayerColorsSet colors, std::vector<int32_t> & tiles ) const
+    {
+        assert( isBuilt() );
+        assert( minX >= 0 && minX <= maxX && maxX < _width );
+
+        const size_t rowOffset = static_cast<size_t>( y ) * _wordsPerRow;
+        const int32_t lastWordId = maxX / bitsPerWord;
+
+        for ( int32_t wordId = minX / bitsPerWord; wordId <= lastWordId; ++wordId ) {
+            uint64_t word = _getFogWord( rowOffset + wordId, colors ) & getColumnMask( wordId, minX, maxX );
+
+            while ( word != 0 ) {
+                // The number of bits below the lowest set bit is its position in the word.
+                const int32_t bitId = countBits( ( word & ( ~word + 1 ) ) - 1 );
+                word &= word - 1;
+
+                tiles.push_back( y * _width + wordId * bitsPerWord + bitId );
+            }
+        }
+    }
+
+    uint64_t FogBitplanes::_getFogWord( const size_t wordOffset, const PlayerColorsSet colors ) const
+    {
+        uint64_t word = 0;
+
+        for ( size_t colorId = 0; colorId < _planes.size(); ++colorId ) {
+            if ( colors & planeColors[colorId] ) {
+                assert( wordOffset < _planes[colorId].size() );
+
+                word |= _planes[colorId][wordOffset];
+            }
+        }
+
+        return word;
+    }
+}
@@ -0,0 +1,66 @@
+/***************************************************************************
+ *   fheroes2: https://github.com/ihhub/fheroes2                           *
+ *   Copyright (C) 2025                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "color.h"
+
+namespace Maps
+{
+    class Tile;
+
+    // Fog of the world map stored as one bit per tile for every player color. Rows of the map are packed into 64-bit words,
+    // so fog of many tiles can be checked at once. The bitplanes mirror the fog of tiles and have to be updated every time the fog is cleared.
+    class FogBitplanes
+    {
+    public:
+        void build( const std::vector<Tile> & tiles, const int32_t width );
+
+        void clear();
+
+        bool isBuilt() const
+        {
+            return _width > 0;
+        }
+
+        void clearFog( const int32_t tileIndex, const PlayerColorsSet colors );
+
+        // Returns the number of tiles in [minX, maxX] columns of the row which are covered by fog for any of the given colors.
+        int32_t countFogTiles( const int32_t y, const int32_t minX, const int32_t maxX, const PlayerColorsSet colors ) const;
+
+        // Appends indexes of tiles in [minX, maxX] columns of the row which are covered by fog for any of the given colors. Indexes are appended in ascending order.
+        void getFogTiles( const int32_t y, const int32_t minX, const int32_t maxX, const PlayerColorsSet colors, std::vector<int32_t> & tiles ) const;
+
+    private:
+        // Returns fog bits of the word of the row for any of the given colors.
+        uint64_t _getFogWord( const size_t wordOffset, const PlayerColorsSet colors ) const;
+
+        int32_t _width{ 0 };
+        int32_t _wordsPerRow{ 0 };
+
+        // Bitplane for every player color from blue to purple.
+        std::array<std::vector<uint64_t>, 6> _planes;
+    };
+}
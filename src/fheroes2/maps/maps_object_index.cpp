@@ -0,0 +1,93 @@
+/***************************************************************************
+ *   fheroes2: https://github.com/ihhub/fheroes2                           *
+ *   Copyright (C) 2025                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "maps_object_index.h"
+
+#include <cassert>
+#include <cstddef>
+
+#include "maps_tiles.h"
+#include "mp2.h"
+
+namespace Maps
+{
+    void ObjectTypeIndex::build( const std::vector<Tile> & tiles )
+    {
+        clear();
+
+        _tilePositions.resize( tiles.size() );
+
+        for ( const Tile & tile : tiles ) {
+            assert( tile.GetIndex() >= 0 && static_cast<size_t>( tile.GetIndex() ) < tiles.size() );
+
+            _add( tile.GetIndex(), tile.getMainObjectType() );
+        }
+    }
+
+    void ObjectTypeIndex::update( const int32_t tileIndex, const MP2::MapObjectType previousType, const MP2::MapObjectType newType )
+    {
+        if ( previousType == newType || !isBuilt() ) {
+            return;
+        }
+
+        assert( tileIndex >= 0 && static_cast<size_t>( tileIndex ) < _tilePositions.size() );
+
+        _remove( tileIndex, previousType );
+        _add( tileIndex, newType );
+    }
+
+    const std::vector<int32_t> & ObjectTypeIndex::getTiles( const MP2::MapObjectType objectType ) const
+    {
+        if ( objectType >= _tiles.size() ) {
+            static const std::vector<int32_t> noTiles;
+            return noTiles;
+        }
+
+        return _tiles[objectType];
+    }
+
+    void ObjectTypeIndex::_add( const int32_t tileIndex, const MP2::MapObjectType objectType )
+    {
+        if ( objectType >= _tiles.size() ) {
+            _tiles.resize( static_cast<size_t>( objectType ) + 1 );
+        }
+
+        std::vector<int32_t> & tiles = _tiles[objectType];
+
+        _tilePositions[tileIndex] = static_cast<uint32_t>( tiles.size() );
+        tiles.push_back( tileIndex );
+    }
+
+    void ObjectTypeIndex::_remove( const int32_t tileIndex, const MP2::MapObjectType objectType )
+    {
+        assert( objectType < _tiles.size() );
+
+        std::vector<int32_t> & tiles = _tiles[objectType];
+
+        const uint32_t position = _tilePositions[tileIndex];
+        assert( position < tiles.size() && tiles[position] == tileIndex );
+
+        // The last tile takes the place of the removed one.
+        tiles[position] = tiles.back();
+        _tilePositions[tiles[position]] = position;
+
+        tiles.pop_back();
+    }
+}
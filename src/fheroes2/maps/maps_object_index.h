@@ -0,0 +1,68 @@
+/***************************************************************************
+ *   fheroes2: https://github.com/ihhub/fheroes2                           *
+ *   Copyright (C) 2025                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace MP2
+{
+    enum MapObjectType : uint16_t;
+}
+
+namespace Maps
+{
+    class Tile;
+
+    // Tiles of the world map grouped by their main object type. It allows to find all objects of a certain type without scanning the whole map.
+    // The index has to be updated every time the main object type of a tile is changed.
+    class ObjectTypeIndex
+    {
+    public:
+        void build( const std::vector<Tile> & tiles );
+
+        void clear()
+        {
+            _tiles.clear();
+            _tilePositions.clear();
+        }
+
+        bool isBuilt() const
+        {
+            return !_tilePositions.empty();
+        }
+
+        void update( const int32_t tileIndex, const MP2::MapObjectType previousType, const MP2::MapObjectType newType );
+
+        // Returns indexes of all tiles with the given main object type in no particular order.
+        const std::vector<int32_t> & getTiles( const MP2::MapObjectType objectType ) const;
+
+    private:
+        void _add( const int32_t tileIndex, const MP2::MapObjectType objectType );
+        void _remove( const int32_t tileIndex, const MP2::MapObjectType objectType );
+
+        // Tile indexes for every object type.
+        std::vector<std::vector<int32_t>> _tiles;
+
+        // Position of every tile in the list of its object type to remove it in constant time.
+        std::vector<uint32_t> _tilePositions;
+    };
+}
@@ -498,16 +498,20 @@ MP2::MapObjectType Maps::Tile::_getMainObjectTypeUnderHero() const
 
 void Maps::Tile::setMainObjectType( const MP2::MapObjectType objectType )
 {
+    world.updateObjectTypeIndex( _index, _mainObjectType, objectType );
+
     _mainObjectType = objectType;
 
-    world.resetPathfinder();
+    world.updateMonsterProtection( _index );
+    world.invalidatePathfinderTile( _index );
+    world.invalidateRadarTile( _index );
 }
 
 void Maps::Tile::setBoat( const int direction, const PlayerColor color )
 {
     if ( _mainObjectPart.icnType != MP2::OBJ_ICN_TYPE_UNKNOWN ) {
         // It is important to preserve the order of objects for rendering purposes. Therefore, the main object should go to the front of objects.
-        _groundObjectPart.emplace_front( _mainObjectPart );
+        _groundObjectPart.insert( _groundObjectPart.begin(), _mainObjectPart );
     }
 
     // If this assertion blows up then you are trying to put a boat on land!
@@ -829,11 +833,12 @@ void Maps::Tile::sortObjectParts()
 
     // Push everything to the container and sort it by level.
     if ( _mainObjectPart.icnType != MP2::OBJ_ICN_TYPE_UNKNOWN ) {
-        _groundObjectPart.emplace_front( _mainObjectPart );
+        _groundObjectPart.insert( _groundObjectPart.begin(), _mainObjectPart );
     }
 
     // Sort by internal layers.
-    _groundObjectPart.sort( []( const auto & left, const auto & right ) { return ( left.layerType > right.layerType ); } );
+    // The sorting must be stable to keep the order of object parts on the same layer.
+    std::stable_sort( _groundObjectPart.begin(), _groundObjectPart.end(), []( const auto & left, const auto & right ) { return ( left.layerType > right.layerType ); } );
 
     if ( !_groundObjectPart.empty() ) {
         auto highestPriorityPartIter = _groundObjectPart.end();
@@ -1247,8 +1252,8 @@ void Maps::Tile::updateFlag( const PlayerColor color, const uint8_t objectSprite
     // Flag deletion or installation must be done in relation to object UID as flag is attached to the object.
     if ( color == PlayerColor::NONE ) {
         const auto isFlag = [uid]( const auto & part ) { return part._uid == uid && part.icnType == MP2::OBJ_ICN_TYPE_FLAG32; };
-        _groundObjectPart.remove_if( isFlag );
-        _topObjectPart.remove_if( isFlag );
+        _groundObjectPart.erase( std::remove_if( _groundObjectPart.begin(), _groundObjectPart.end(), isFlag ), _groundObjectPart.end() );
+        _topObjectPart.erase( std::remove_if( _topObjectPart.begin(), _topObjectPart.end(), isFlag ), _topObjectPart.end() );
         return;
     }
 
@@ -1419,14 +1424,16 @@ bool Maps::Tile::removeObjectPartsByUID( const uint32_t objectUID )
         isObjectPartRemoved = true;
     }
 
+    const auto isObjectPart = [objectUID]( const auto & v ) { return v._uid == objectUID; };
+
     size_t partCountBefore = _groundObjectPart.size();
-    _groundObjectPart.remove_if( [objectUID]( const auto & v ) { return v._uid == objectUID; } );
+    _groundObjectPart.erase( std::remove_if( _groundObjectPart.begin(), _groundObjectPart.end(), isObjectPart ), _groundObjectPart.end() );
     if ( partCountBefore != _groundObjectPart.size() ) {
         isObjectPartRemoved = true;
     }
 
     partCountBefore = _topObjectPart.size();
-    _topObjectPart.remove_if( [objectUID]( const auto & v ) { return v._uid == objectUID; } );
+    _topObjectPart.erase( std::remove_if( _topObjectPart.begin(), _topObjectPart.end(), isObjectPart ), _topObjectPart.end() );
     if ( partCountBefore != _topObjectPart.size() ) {
         isObjectPartRemoved = true;
     }
@@ -1450,6 +1457,12 @@ bool Maps::Tile::removeObjectPartsByUID( const uint32_t objectUID )
             world.getTile( tileIndex ).updatePassability();
         }
 
+        // Monsters might protect the tiles around them differently now.
+        world.updateMonsterProtection( _index );
+        for ( const int32_t tileIndex : tilesAround ) {
+            world.updateMonsterProtection( tileIndex );
+        }
+
         if ( Heroes::isValidId( _occupantHeroId ) ) {
             Heroes * hero = world.GetHeroes( _occupantHeroId );
             if ( hero != nullptr ) {
@@ -1468,8 +1481,10 @@ bool Maps::Tile::removeObjectPartsByUID( const uint32_t objectUID )
 
 void Maps::Tile::removeObjects( const MP2::ObjectIcnType objectIcnType )
 {
-    _groundObjectPart.remove_if( [objectIcnType]( const auto & part ) { return part.icnType == objectIcnType; } );
-    _topObjectPart.remove_if( [objectIcnType]( const auto & part ) { return part.icnType == objectIcnType; } );
+    const auto isObjectIcnType = [objectIcnType]( const auto & part ) { return part.icnType == objectIcnType; };
+
+    _groundObjectPart.erase( std::remove_if( _groundObjectPart.begin(), _groundObjectPart.end(), isObjectIcnType ), _groundObjectPart.end() );
+    _topObjectPart.erase( std::remove_if( _topObjectPart.begin(), _topObjectPart.end(), isObjectIcnType ), _topObjectPart.end() );
 
     if ( _mainObjectPart.icnType == objectIcnType ) {
         _mainObjectPart = {};
@@ -1533,12 +1548,20 @@ void Maps::Tile::updateObjectImageIndex( const uint32_t objectUid, const MP2::Ob
 
 void Maps::Tile::ClearFog( const PlayerColorsSet colors )
 {
+    if ( ( _fogColors & colors ) == 0 ) {
+        // There is no fog to clear, so nothing changes for the pathfinder(s).
+        return;
+    }
+
     _fogColors &= ~colors;
 
+    world.clearFogBitplanes( _index, colors );
+
     // The fog might be cleared even without the hero's movement - for example, the hero can gain a new level of Scouting
     // skill by picking up a Treasure Chest from a nearby tile or buying a map in a Magellan's Maps object using the space
-    // bar button. Reset the pathfinder(s) to make the newly discovered tiles immediately available for this hero.
-    world.resetPathfinder();
+    // bar button. Update the pathfinder(s) to make the newly discovered tiles immediately available for this hero.
+    world.invalidatePathfinderTile( _index );
+    world.invalidateRadarTile( _index );
 }
 
 void Maps::Tile::updateTileObjectIcnIndex( Maps::Tile & tile, const uint32_t uid, const uint8_t newIndex )
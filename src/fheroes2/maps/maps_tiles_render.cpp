@@ -984,6 +984,60 @@ namespace Maps
         }
     }
 
+    bool isBottomLayerStatic( const Tile & tile, const Interface::GameArea & area )
+    {
+        const auto isStaticPart = [&area]( const ObjectPart & part ) {
+            if ( part.layerType != TERRAIN_LAYER && part.layerType != BACKGROUND_LAYER ) {
+                return true;
+            }
+
+            // Flags are changed on object capture and they might go beyond the tile.
+            if ( part.icnType == MP2::OBJ_ICN_TYPE_FLAG32 ) {
+                return false;
+            }
+
+            if ( isObjectPartDirectRenderingRestricted( MP2::getIcnIdFromObjectIcnType( part.icnType ) ) ) {
+                return false;
+            }
+
+            const auto * objectInfo = Maps::getObjectPartByIcn( part.icnType, part.icnIndex );
+            if ( objectInfo != nullptr && objectInfo->animationFrames > 0 ) {
+                return false;
+            }
+
+            return area.getObjectAlphaValue( part._uid ) == 255;
+        };
+
+        for ( const auto & part : tile.getGroundObjectParts() ) {
+            if ( !isStaticPart( part ) ) {
+                return false;
+            }
+        }
+
+        return tile.getMainObjectPart().icnType == MP2::OBJ_ICN_TYPE_UNKNOWN || isStaticPart( tile.getMainObjectPart() );
+    }
+
+    void redrawStaticBottomLayerObjects( const Tile & tile, fheroes2::Image & dst, const fheroes2::Point & offset )
+    {
+        // The order of rendering is the same as in redrawBottomLayerObjects() method. Static tiles do not have flags so no object part is postponed.
+        for ( const ObjectLayerType level : { TERRAIN_LAYER, BACKGROUND_LAYER } ) {
+            for ( const auto & part : tile.getGroundObjectParts() ) {
+                if ( part.layerType != level ) {
+                    continue;
+                }
+
+                const fheroes2::Sprite & sprite = fheroes2::AGG::GetICN( MP2::getIcnIdFromObjectIcnType( part.icnType ), part.icnIndex );
+                fheroes2::Blit( sprite, dst, offset.x + sprite.x(), offset.y + sprite.y() );
+            }
+
+            const auto & mainPart = tile.getMainObjectPart();
+            if ( mainPart.icnType != MP2::OBJ_ICN_TYPE_UNKNOWN && mainPart.layerType == level ) {
+                const fheroes2::Sprite & sprite = fheroes2::AGG::GetICN( MP2::getIcnIdFromObjectIcnType( mainPart.icnType ), mainPart.icnIndex );
+                fheroes2::Blit( sprite, dst, offset.x + sprite.x(), offset.y + sprite.y() );
+            }
+        }
+    }
+
     void drawByObjectIcnType( const Tile & tile, fheroes2::Image & output, const Interface::GameArea & area, const MP2::ObjectIcnType objectIcnType )
     {
         const fheroes2::Point & tileOffset = Maps::GetPoint( tile.GetIndex() );
@@ -61,6 +61,12 @@ namespace Maps
 
     void redrawBottomLayerObjects( const Tile & tile, fheroes2::Image & dst, bool isPuzzleDraw, const Interface::GameArea & area, const uint8_t level );
 
+    // Returns true if terrain and background layer object parts of the tile are neither animated nor faded so they can be rendered once and reused later.
+    bool isBottomLayerStatic( const Tile & tile, const Interface::GameArea & area );
+
+    // Renders terrain and background layer object parts of a static tile (see isBottomLayerStatic()) with the top-left corner of the tile at the given position.
+    void redrawStaticBottomLayerObjects( const Tile & tile, fheroes2::Image & dst, const fheroes2::Point & offset );
+
     void drawByObjectIcnType( const Tile & tile, fheroes2::Image & output, const Interface::GameArea & area, const MP2::ObjectIcnType objectIcnType );
 
     std::vector<fheroes2::ObjectRenderingInfo> getMonsterSpritesPerTile( const Tile & tile, const bool isEditorMode );
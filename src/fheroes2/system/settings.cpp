@@ -31,6 +31,7 @@
 #include <CoreFoundation/CoreFoundation.h>
 #endif
 
+#include "agg_image.h"
 #include "cursor.h"
 #include "difficulty.h"
 #include "game.h"
@@ -293,6 +294,20 @@ bool Settings::Read( const std::string & filePath )
         _controllerPointerSpeed = std::clamp( config.IntParams( "controller pointer speed" ), 0, 100 );
     }
 
+    if ( config.Exists( "sprite memory limit" ) ) {
+        _spriteMemoryLimit = std::clamp( config.IntParams( "sprite memory limit" ), 0, 4096 );
+        fheroes2::AGG::setSpriteMemoryLimit( static_cast<size_t>( _spriteMemoryLimit ) * 1024 * 1024 );
+    }
+
+    if ( config.Exists( "sprite disk cache" ) ) {
+        _isSpriteDiskCacheEnabled = config.StrParams( "sprite disk cache" ) == "on";
+
+        if ( _isSpriteDiskCacheEnabled ) {
+            fheroes2::AGG::enableSpriteDiskCache( System::concatPath( System::GetDataDirectory( "fheroes2" ), System::concatPath( "files", "cache" ) ),
+                                                  GetVersion() );
+        }
+    }
+
     if ( config.Exists( "first time game run" ) && config.StrParams( "first time game run" ) == "off" ) {
         resetFirstGameRun();
     }
@@ -501,6 +516,12 @@ std::string Settings::String() const
     os << std::endl << "# controller pointer speed: 0 - 100" << std::endl;
     os << "controller pointer speed = " << _controllerPointerSpeed << std::endl;
 
+    os << std::endl << "# memory limit in MB for the images which can be reloaded on demand (for devices with little RAM): 0 - 4096. 0 means no limit" << std::endl;
+    os << "sprite memory limit = " << _spriteMemoryLimit << std::endl;
+
+    os << std::endl << "# store generated images on disk to speed up subsequent game starts: on/off" << std::endl;
+    os << "sprite disk cache = " << ( _isSpriteDiskCacheEnabled ? "on" : "off" ) << std::endl;
+
     os << std::endl << "# first time game run (show additional hints): on/off" << std::endl;
     os << "first time game run = " << ( _gameOptions.Modes( GAME_FIRST_RUN ) ? "on" : "off" ) << std::endl;
 
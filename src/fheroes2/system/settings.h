@@ -423,6 +423,9 @@ private:
     int music_volume;
     MusicSource _musicType;
     int _controllerPointerSpeed;
+    // In megabytes, 0 means no limit.
+    int _spriteMemoryLimit{ 0 };
+    bool _isSpriteDiskCacheEnabled{ false };
     int heroes_speed;
     int ai_speed;
     int scroll_speed;
@@ -26,6 +26,7 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <cstddef>
 #include <limits>
 #include <optional>
 #include <ostream>
@@ -59,6 +60,7 @@
 #include "save_format_version.h"
 #include "serialize.h"
 #include "settings.h"
+#include "thread.h"
 #include "tools.h"
 #include "translations.h"
 #include "ui_font.h"
@@ -67,6 +69,9 @@
 
 namespace
 {
+    // Objects are updated at the beginning of a week by groups of tiles of this size.
+    constexpr size_t weeklyUpdateTileGroupSize = 1024;
+
     bool isTileBlockedForSettingMonster( const int32_t tileId, const int32_t radius, const std::set<int32_t> & excludeTiles )
     {
         const MapsIndexes & indexes = Maps::getAroundIndexes( tileId, radius );
@@ -139,6 +144,13 @@ namespace
 
         return count;
     }
+
+    // All tiles of a captured object are painted with the owner's color on the radar. Objects are never bigger than this area around their main tile.
+    fheroes2::Rect getCapturedObjectRadarArea( const int32_t tileIndex )
+    {
+        const fheroes2::Point center = Maps::GetPoint( tileIndex );
+        return { center.x - 2, center.y - 3, 5, 5 };
+    }
 }
 
 MapBaseObject * MapObjects::get( const uint32_t uid ) const
@@ -273,6 +285,10 @@ void CapturedObjects::ResetColor( const PlayerColor color )
 
         objectColor = PlayerColor::NONE;
         world.getTile( tileIndex ).setOwnershipFlag( objectType, objectColor );
+
+        // Ownership affects the passability of the object for heroes of different colors.
+        world.invalidatePathfinderTile( tileIndex );
+        world.invalidateRadarArea( getCapturedObjectRadarArea( tileIndex ) );
     }
 }
 
@@ -300,6 +316,11 @@ void World::Defaults()
     vec_castles.Init();
 }
 
+World::~World()
+{
+    Reset();
+}
+
 void World::Reset()
 {
     width = 0;
@@ -337,6 +358,13 @@ void World::Reset()
     heroIdAsLossCondition = Heroes::UNKNOWN;
 
     _seed = 0;
+
+    _invalidatedRadarTiles.clear();
+    _isRadarTileInvalidated.clear();
+
+    _objectTypeIndex.clear();
+    _protectingMonsterDirections.clear();
+    _fogBitplanes.clear();
 }
 
 void World::generateBattleOnlyMap()
@@ -512,11 +540,7 @@ void World::NewWeek()
 {
     // update objects
     if ( week > 1 ) {
-        for ( Maps::Tile & tile : vec_tiles ) {
-            if ( MP2::isWeekLife( tile.getMainObjectType( false ) ) || tile.getMainObjectType() == MP2::OBJ_MONSTER ) {
-                updateObjectInfoTile( tile, false );
-            }
-        }
+        _updateObjectsForNewWeek();
     }
 
     // Reset RECRUIT mode for all heroes at once
@@ -533,6 +557,37 @@ void World::NewWeek()
     }
 }
 
+void World::_updateObjectsForNewWeek()
+{
+    // An object only changes its own tile, so groups of tiles are updated in parallel. Every group uses its own random generator
+    // which depends only on the position of the group on the map, so the result does not depend on the number of threads.
+    const uint32_t weekSeed = Rand::Get( 0, std::numeric_limits<uint32_t>::max() );
+    const size_t groupCount = ( vec_tiles.size() + weeklyUpdateTileGroupSize - 1 ) / weeklyUpdateTileGroupSize;
+
+    _getWorkerPool().parallelFor( groupCount, [this, weekSeed]( const size_t groupId, const size_t /* threadId */ ) {
+        const Rand::ThreadRandomDeviceOverride randomDeviceOverride( Rand::PCG32( weekSeed, groupId ) );
+
+        const size_t groupEnd = std::min( vec_tiles.size(), ( groupId + 1 ) * weeklyUpdateTileGroupSize );
+
+        for ( size_t tileId = groupId * weeklyUpdateTileGroupSize; tileId < groupEnd; ++tileId ) {
+            Maps::Tile & tile = vec_tiles[tileId];
+
+            if ( MP2::isWeekLife( tile.getMainObjectType( false ) ) || tile.getMainObjectType() == MP2::OBJ_MONSTER ) {
+                updateObjectInfoTile( tile, false );
+            }
+        }
+    } );
+}
+
+MultiThreading::WorkerPool & World::_getWorkerPool()
+{
+    if ( !_workerPool ) {
+        _workerPool = std::make_unique<MultiThreading::WorkerPool>();
+    }
+
+    return *_workerPool;
+}
+
 void World::NewMonth()
 {
     if ( month > 1 && GetWeekType().GetType() == WeekName::MONSTERS ) {
@@ -561,12 +616,20 @@ void World::_monthOfMonstersAction( const Monster & mons )
 
     // First we scan for Heroes, Castles and Monsters to exclude these from tiles and nearby tiles.
     // We must do this prior to checking the possibility for a monster to spawn in order to properly perform the check on nearby tiles.
-    std::for_each( vec_tiles.cbegin(), vec_tiles.cend(), [&excludeTiles]( const Maps::Tile & tile ) {
-        const MP2::MapObjectType objectType = tile.getMainObjectType( true );
-        if ( objectType == MP2::OBJ_CASTLE || objectType == MP2::OBJ_HERO || objectType == MP2::OBJ_MONSTER ) {
-            excludeTiles.emplace( tile.GetIndex() );
+    if ( _objectTypeIndex.isBuilt() ) {
+        for ( const MP2::MapObjectType objectType : { MP2::OBJ_CASTLE, MP2::OBJ_HERO, MP2::OBJ_MONSTER } ) {
+            const std::vector<int32_t> & tiles = _objectTypeIndex.getTiles( objectType );
+            excludeTiles.insert( tiles.begin(), tiles.end() );
         }
-    } );
+    }
+    else {
+        std::for_each( vec_tiles.cbegin(), vec_tiles.cend(), [&excludeTiles]( const Maps::Tile & tile ) {
+            const MP2::MapObjectType objectType = tile.getMainObjectType( true );
+            if ( objectType == MP2::OBJ_CASTLE || objectType == MP2::OBJ_HERO || objectType == MP2::OBJ_MONSTER ) {
+                excludeTiles.emplace( tile.GetIndex() );
+            }
+        } );
+    }
 
     for ( const Maps::Tile & tile : vec_tiles ) {
         if ( tile.isWater() ) {
@@ -870,6 +933,10 @@ void World::CaptureObject( const int32_t index, const PlayerColor color )
     // In example, dwellings can also marked by the player's color.
     map_captureobj.Set( index, objectType, color );
 
+    // Ownership affects the passability of the object for heroes of different colors.
+    invalidatePathfinderTile( index );
+    invalidateRadarArea( getCapturedObjectRadarArea( index ) );
+
     if ( color != PlayerColor::NONE && !( Color::allPlayerColors() & color ) ) {
         return;
     }
@@ -1281,6 +1348,85 @@ void World::resetPathfinder()
     AI::Planner::Get().resetPathfinder();
 }
 
+void World::invalidatePathfinderTile( const int32_t tileIndex )
+{
+    _pathfinder.invalidateTile( tileIndex );
+    AI::Planner::Get().invalidatePathfinderTile( tileIndex );
+}
+
+void World::invalidateRadarTile( const int32_t tileIndex )
+{
+    if ( tileIndex < 0 || static_cast<size_t>( tileIndex ) >= vec_tiles.size() ) {
+        return;
+    }
+
+    if ( _isRadarTileInvalidated.size() != vec_tiles.size() ) {
+        _invalidatedRadarTiles.clear();
+        _isRadarTileInvalidated.assign( vec_tiles.size(), 0 );
+    }
+
+    if ( _isRadarTileInvalidated[tileIndex] != 0 ) {
+        return;
+    }
+
+    _isRadarTileInvalidated[tileIndex] = 1;
+    _invalidatedRadarTiles.push_back( tileIndex );
+}
+
+void World::invalidateRadarArea( const fheroes2::Rect & area )
+{
+    const fheroes2::Rect roi = area ^ fheroes2::Rect( 0, 0, width, height );
+
+    for ( int32_t y = roi.y; y < roi.y + roi.height; ++y ) {
+        for ( int32_t x = roi.x; x < roi.x + roi.width; ++x ) {
+            invalidateRadarTile( y * width + x );
+        }
+    }
+}
+
+std::vector<int32_t> World::takeInvalidatedRadarTiles()
+{
+    for ( const int32_t tileIndex : _invalidatedRadarTiles ) {
+        _isRadarTileInvalidated[tileIndex] = 0;
+    }
+
+    std::vector<int32_t> tiles;
+    std::swap( tiles, _invalidatedRadarTiles );
+
+    return tiles;
+}
+
+void World::updateMonsterProtection( const int32_t tileIndex )
+{
+    if ( _protectingMonsterDirections.empty() ) {
+        // The table has not been built yet.
+        return;
+    }
+
+    const fheroes2::Point center = Maps::GetPoint( tileIndex );
+
+    // The tile can contain a monster protecting any of the tiles around or be protected by them.
+    const fheroes2::Rect roi = fheroes2::Rect( center.x - 1, center.y - 1, 3, 3 ) ^ fheroes2::Rect( 0, 0, width, height );
+
+    for ( int32_t y = roi.y; y < roi.y + roi.height; ++y ) {
+        for ( int32_t x = roi.x; x < roi.x + roi.width; ++x ) {
+            const int32_t index = y * width + x;
+            _protectingMonsterDirections[index] = static_cast<uint16_t>( Maps::calculateProtectingMonsterDirections( index, true ) );
+        }
+    }
+}
+
+int World::getProtectingMonsterDirections( const int32_t tileIndex ) const
+{
+    if ( _protectingMonsterDirections.empty() ) {
+        return Maps::calculateProtectingMonsterDirections( tileIndex, true );
+    }
+
+    assert( tileIndex >= 0 && static_cast<size_t>( tileIndex ) < _protectingMonsterDirections.size() );
+
+    return _protectingMonsterDirections[tileIndex];
+}
+
 void World::updatePassabilities()
 {
     for ( Maps::Tile & tile : vec_tiles ) {
@@ -1304,6 +1450,19 @@ void World::PostLoad( const bool setTilePassabilities, const bool updateUidCount
         updatePassabilities();
     }
 
+    // All object searches below rely on the index of object types.
+    _objectTypeIndex.build( vec_tiles );
+
+    // Passabilities of all tiles must be set before this.
+    _protectingMonsterDirections.clear();
+    _protectingMonsterDirections.reserve( vec_tiles.size() );
+
+    for ( const Maps::Tile & tile : vec_tiles ) {
+        _protectingMonsterDirections.push_back( static_cast<uint16_t>( Maps::calculateProtectingMonsterDirections( tile.GetIndex(), true ) ) );
+    }
+
+    _fogBitplanes.build( vec_tiles, width );
+
     // Cache all tiles that that contain stone liths of a certain type (depending on object sprite index).
     _allTeleports.clear();
 
@@ -1557,6 +1716,11 @@ OStreamBase & operator<<( OStreamBase & stream, const World & w )
 
 IStreamBase & operator>>( IStreamBase & stream, World & w )
 {
+    // These tables belong to the previous map. They are built again after loading.
+    w._objectTypeIndex.clear();
+    w._protectingMonsterDirections.clear();
+    w._fogBitplanes.clear();
+
     static_assert( LAST_SUPPORTED_FORMAT_VERSION < FORMAT_VERSION_1010_RELEASE, "Remove the logic below." );
     if ( Game::GetVersionOfCurrentSaveFile() < FORMAT_VERSION_1010_RELEASE ) {
         uint16_t width = 0;
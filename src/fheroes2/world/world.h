@@ -41,6 +41,8 @@
 #include "heroes.h"
 #include "kingdom.h"
 #include "maps.h"
+#include "maps_fog.h"
+#include "maps_object_index.h"
 #include "maps_objects.h"
 #include "maps_tiles.h"
 #include "math_base.h"
@@ -60,6 +62,11 @@ namespace MP2
     enum MapObjectType : uint16_t;
 }
 
+namespace MultiThreading
+{
+    class WorkerPool;
+}
+
 namespace Route
 {
     class Step;
@@ -195,10 +202,7 @@ public:
     World( const World & other ) = delete;
     World( World && other ) = delete;
 
-    ~World()
-    {
-        Reset();
-    }
+    ~World();
 
     World & operator=( const World & other ) = delete;
     World & operator=( World && other ) = delete;
@@ -427,6 +431,45 @@ public:
     uint32_t getDistance( const Heroes & hero, int targetIndex );
     std::list<Route::Step> getPath( const Heroes & hero, int targetIndex );
     void resetPathfinder();
+    // Notifies the pathfinders that the tile has been changed, so they can re-evaluate only the affected part of the map
+    void invalidatePathfinderTile( const int32_t tileIndex );
+
+    // Notifies the radar that the tile might look differently on it, so only the affected tiles of the radar map can be updated
+    void invalidateRadarTile( const int32_t tileIndex );
+    void invalidateRadarArea( const fheroes2::Rect & area );
+
+    // Returns indexes of all tiles invalidated for the radar since the previous call of this method.
+    std::vector<int32_t> takeInvalidatedRadarTiles();
+
+    // Must be called on every change of the main object type of a tile.
+    void updateObjectTypeIndex( const int32_t tileIndex, const MP2::MapObjectType previousType, const MP2::MapObjectType newType )
+    {
+        _objectTypeIndex.update( tileIndex, previousType, newType );
+    }
+
+    // The index is built when a map or a saved game is loaded. Until then it is empty.
+    const Maps::ObjectTypeIndex & getObjectTypeIndex() const
+    {
+        return _objectTypeIndex;
+    }
+
+    // Must be called after every change of the object type or passability of a tile as monsters protect the tiles around them.
+    void updateMonsterProtection( const int32_t tileIndex );
+
+    // Returns directions from the tile to the monsters protecting it. See Maps::calculateProtectingMonsterDirections() for details.
+    int getProtectingMonsterDirections( const int32_t tileIndex ) const;
+
+    // Must be called every time the fog of a tile is cleared.
+    void clearFogBitplanes( const int32_t tileIndex, const PlayerColorsSet colors )
+    {
+        _fogBitplanes.clearFog( tileIndex, colors );
+    }
+
+    // The bitplanes are built when a map or a saved game is loaded. Until then they are empty.
+    const Maps::FogBitplanes & getFogBitplanes() const
+    {
+        return _fogBitplanes;
+    }
 
     void ComputeStaticAnalysis();
 
@@ -456,6 +499,10 @@ private:
     void Defaults();
     void Reset();
     void _monthOfMonstersAction( const Monster & mons );
+    void _updateObjectsForNewWeek();
+
+    // Returns the pool of threads to update the world. The pool is created on the first call.
+    MultiThreading::WorkerPool & _getWorkerPool();
     bool ProcessNewMP2Map( const std::string & filename, const bool checkPoLObjects );
     void PostLoad( const bool setTilePassabilities, const bool updateUidCounterToMaximum );
 
@@ -506,6 +553,19 @@ private:
     double _landRoughness{ 1.0 };
     std::vector<MapRegion> _regions;
     PlayerWorldPathfinder _pathfinder;
+
+    std::vector<int32_t> _invalidatedRadarTiles;
+    // Marks tiles already present in the list above to avoid duplicates.
+    std::vector<uint8_t> _isRadarTileInvalidated;
+
+    Maps::ObjectTypeIndex _objectTypeIndex;
+
+    // Directions to the monsters protecting every tile. The table is built when a map or a saved game is loaded.
+    std::vector<uint16_t> _protectingMonsterDirections;
+
+    Maps::FogBitplanes _fogBitplanes;
+
+    std::unique_ptr<MultiThreading::WorkerPool> _workerPool;
 };
 
 OStreamBase & operator<<( OStreamBase & stream, const CapturedObject & obj );
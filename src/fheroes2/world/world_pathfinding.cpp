@@ -24,6 +24,7 @@
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
+#include <functional>
 #include <set>
 #include <tuple>
 #include <utility>
@@ -53,6 +54,9 @@
 
 namespace
 {
+    // If too many tiles have been changed since the last evaluation of the map, then it is faster to re-evaluate the whole map.
+    const size_t maxInvalidatedTileCount = 64;
+
     bool isTileAvailableForWalkThrough( const int tileIndex, const bool fromWater )
     {
         const Maps::Tile & tile = world.getTile( tileIndex );
@@ -78,8 +82,9 @@ namespace
         const MP2::MapObjectType objectType = tile.getMainObjectType();
 
         const auto isTileAccessible = [color, armyStrength, minimalAdvantage, &tile]() {
-            // Creating an Army instance is a relatively heavy operation, so cache it to speed up calculations
-            static Army tileArmy;
+            // Creating an Army instance is a relatively heavy operation, so cache it to speed up calculations. AI pathfinders
+            // can be used by multiple threads at the same time, so every thread has its own instance.
+            thread_local Army tileArmy;
             tileArmy.setFromTile( tile );
 
             const PlayerColor tileArmyColor = tileArmy.GetColor();
@@ -297,8 +302,9 @@ namespace
         }
 
         for ( const int32_t monsterIndex : Maps::getMonstersProtectingTile( tileIndex ) ) {
-            // Creating an Army instance is a relatively heavy operation, so cache it to speed up calculations
-            static Army tileArmy;
+            // Creating an Army instance is a relatively heavy operation, so cache it to speed up calculations. AI pathfinders
+            // can be used by multiple threads at the same time, so every thread has its own instance.
+            thread_local Army tileArmy;
             tileArmy.setFromTile( world.getTile( monsterIndex ) );
 
             // Tiles guarded by too powerful wandering monsters are considered inaccessible
@@ -330,11 +336,33 @@ namespace
     }
 }
 
+void WorldPathfinder::invalidateTile( const int32_t tileIndex )
+{
+    assert( Maps::isValidAbsIndex( tileIndex ) );
+
+    // The map has not been evaluated yet, there is nothing to repair.
+    if ( _pathStart == -1 ) {
+        return;
+    }
+
+    // The same tile is often changed several times in a row (e.g. when a hero passes through it).
+    if ( std::find( _invalidatedTiles.begin(), _invalidatedTiles.end(), tileIndex ) != _invalidatedTiles.end() ) {
+        return;
+    }
+
+    if ( _invalidatedTiles.size() >= maxInvalidatedTileCount ) {
+        reset();
+        return;
+    }
+
+    _invalidatedTiles.push_back( tileIndex );
+}
+
 uint32_t WorldPathfinder::getDistance( int targetIndex ) const
 {
-    assert( targetIndex >= 0 && static_cast<size_t>( targetIndex ) < _cache.size() );
+    assert( targetIndex >= 0 && static_cast<size_t>( targetIndex ) < _nodeCost.size() );
 
-    return _cache[targetIndex]._cost;
+    return _nodeCost[targetIndex];
 }
 
 uint32_t WorldPathfinder::getMovementPenalty( const int from, const int to, const int direction ) const
@@ -354,12 +382,10 @@ uint32_t WorldPathfinder::getMovementPenalty( const int from, const int to, cons
     // tile (both in straight and diagonal direction) as long as we have enough movement points
     // to move over our current tile in the straight direction
     if ( getMaxMovePoints( fromTile.isWater() ) > 0 ) {
-        const WorldNode & node = _cache[from];
-
         // No dead ends allowed
-        assert( from == _pathStart || node._from != -1 );
+        assert( from == _pathStart || _nodeFrom[from] != -1 );
 
-        const uint32_t remainingMovePoints = node._remainingMovePoints;
+        const uint32_t remainingMovePoints = _nodeRemainingMovePoints[from];
         const uint32_t fromTilePenalty = fromTile.isRoad() ? Maps::Ground::roadPenalty : Maps::Ground::GetPenalty( fromTile, _pathfindingSkill );
 
         // If we still have enough movement points to move over the source tile in the straight
@@ -379,8 +405,10 @@ void WorldPathfinder::reset()
     // The following optimization will only work correctly for square maps
     assert( world.w() == world.h() );
 
-    if ( const size_t worldSize = world.getSize(); _cache.size() != worldSize ) {
-        _cache.resize( worldSize );
+    if ( const size_t worldSize = world.getSize(); _nodeCost.size() != worldSize ) {
+        _nodeFrom.resize( worldSize );
+        _nodeCost.resize( worldSize );
+        _nodeRemainingMovePoints.resize( worldSize );
 
         const Directions & directions = Direction::All();
         _mapOffset.resize( directions.size() );
@@ -390,34 +418,210 @@ void WorldPathfinder::reset()
         }
     }
 
+    _invalidatedTiles.clear();
+
     _pathStart = -1;
     _color = PlayerColor::NONE;
     _remainingMovePoints = 0;
     _pathfindingSkill = Skill::Level::EXPERT;
 }
 
-void WorldPathfinder::processWorldMap()
+void WorldPathfinder::addNodeToExplore( const int index )
+{
+    _frontier.emplace_back( _nodeCost[index], index );
+    std::push_heap( _frontier.begin(), _frontier.end(), std::greater<>() );
+}
+
+void WorldPathfinder::initializeNodes()
+{
+    assert( _nodeCost.size() == world.getSize() && Maps::isValidAbsIndex( _pathStart ) );
+
+    std::fill( _nodeFrom.begin(), _nodeFrom.end(), -1 );
+    std::fill( _nodeCost.begin(), _nodeCost.end(), 0 );
+    std::fill( _nodeRemainingMovePoints.begin(), _nodeRemainingMovePoints.end(), 0 );
+
+    _frontier.clear();
+    _invalidatedTiles.clear();
+
+    updateNode( _pathStart, -1, 0, _remainingMovePoints );
+    addNodeToExplore( _pathStart );
+}
+
+void WorldPathfinder::exploreNodes()
+{
+    while ( !_frontier.empty() ) {
+        std::pop_heap( _frontier.begin(), _frontier.end(), std::greater<>() );
+
+        const auto [cost, nodeIdx] = _frontier.back();
+        _frontier.pop_back();
+
+        // A cheaper path to this node was found after this entry was added, so the node has either already been processed
+        // using a newer entry or is going to be processed later.
+        if ( cost != _nodeCost[nodeIdx] ) {
+            continue;
+        }
+
+        processCurrentNode( nodeIdx );
+    }
+}
+
+void WorldPathfinder::processInvalidatedTiles()
 {
-    assert( _cache.size() == world.getSize() && Maps::isValidAbsIndex( _pathStart ) );
+    assert( _nodeCost.size() == world.getSize() && Maps::isValidAbsIndex( _pathStart ) );
+
+    enum NodeState : uint8_t
+    {
+        UNCHANGED,
+        INVALIDATED,
+        ADDED_TO_EXPLORE
+    };
+
+    const Directions & directions = Direction::All();
+    const size_t nodeCount = _nodeCost.size();
+
+    // Buffers are kept between the calls to avoid memory allocations on every repair.
+    std::vector<uint8_t> & nodeStates = _repairNodeStates;
+    nodeStates.assign( nodeCount, UNCHANGED );
+
+    std::vector<int32_t> & invalidatedNodes = _repairInvalidatedNodes;
+    invalidatedNodes.clear();
+
+    const auto invalidateNode = [&nodeStates, &invalidatedNodes]( const int32_t index ) {
+        if ( nodeStates[index] == UNCHANGED ) {
+            nodeStates[index] = INVALIDATED;
+            invalidatedNodes.push_back( index );
+        }
+    };
+
+    // The change of the tile affects not only this tile, but also the movement between its neighbors (for example, when sailing
+    // past the corner of the land) and the protection of the neighboring tiles by monsters.
+    for ( const int32_t tileIndex : _invalidatedTiles ) {
+        invalidateNode( tileIndex );
+        resetTileCache( tileIndex );
+
+        for ( size_t i = 0; i < directions.size(); ++i ) {
+            if ( !Maps::isValidDirection( tileIndex, directions[i] ) ) {
+                continue;
+            }
+
+            const int32_t neighborIndex = tileIndex + _mapOffset[i];
+
+            invalidateNode( neighborIndex );
+            resetTileCache( neighborIndex );
+        }
+    }
+
+    _invalidatedTiles.clear();
+
+    // The paths to all the nodes reached through the invalidated nodes are invalid as well. Build the lists of the nodes reached
+    // directly from each node (in the form of a single array of indexes and offsets of each list in it) to find them.
+    std::vector<int32_t> & nextNodeOffsets = _repairNextNodeOffsets;
+    nextNodeOffsets.assign( nodeCount + 1, 0 );
+
+    for ( size_t idx = 0; idx < nodeCount; ++idx ) {
+        if ( const int32_t from = _nodeFrom[idx]; from != -1 ) {
+            ++nextNodeOffsets[from + 1];
+        }
+    }
+
+    for ( size_t idx = 1; idx < nextNodeOffsets.size(); ++idx ) {
+        nextNodeOffsets[idx] += nextNodeOffsets[idx - 1];
+    }
+
+    std::vector<int32_t> & nextNodes = _repairNextNodes;
+    nextNodes.resize( static_cast<size_t>( nextNodeOffsets.back() ) );
 
-    for ( WorldNode & node : _cache ) {
-        node = {};
+    // The offset of every list is used as the insert position, so after this loop it points to the end of the list, which is
+    // the beginning of the next one. Shift the offsets back afterwards.
+    for ( size_t idx = 0; idx < nodeCount; ++idx ) {
+        if ( const int32_t from = _nodeFrom[idx]; from != -1 ) {
+            nextNodes[nextNodeOffsets[from]++] = static_cast<int32_t>( idx );
+        }
+    }
+
+    for ( size_t idx = nodeCount; idx > 0; --idx ) {
+        nextNodeOffsets[idx] = nextNodeOffsets[idx - 1];
+    }
+
+    nextNodeOffsets[0] = 0;
+
+    for ( size_t i = 0; i < invalidatedNodes.size(); ++i ) {
+        const int32_t nodeIdx = invalidatedNodes[i];
+
+        for ( int32_t j = nextNodeOffsets[nodeIdx]; j < nextNodeOffsets[nodeIdx + 1]; ++j ) {
+            invalidateNode( nextNodes[j] );
+        }
     }
 
-    _cache[_pathStart].update( -1, 0, _remainingMovePoints );
+    // The starting node cannot be repaired. The same is true for nodes reached directly from the starting node using spells
+    // (e.g. Town Portal). It also makes no sense to repair most of the map.
+    const bool isFullEvaluationRequired = ( nodeStates[_pathStart] != UNCHANGED ) || ( invalidatedNodes.size() * 2 > nodeCount )
+                                          || std::any_of( invalidatedNodes.begin(), invalidatedNodes.end(), [this]( const int32_t nodeIdx ) {
+                                                 if ( _nodeFrom[nodeIdx] != _pathStart ) {
+                                                     return false;
+                                                 }
 
-    std::vector<int> nodesToExplore;
-    nodesToExplore.push_back( _pathStart );
+                                                 const int direction = Maps::GetDirection( _pathStart, nodeIdx );
 
-    for ( size_t lastProcessedNode = 0; lastProcessedNode < nodesToExplore.size(); ++lastProcessedNode ) {
-        processCurrentNode( nodesToExplore, nodesToExplore[lastProcessedNode] );
+                                                 return direction == Direction::UNKNOWN || !Maps::isValidDirection( _pathStart, direction );
+                                             } );
+    if ( isFullEvaluationRequired ) {
+        processWorldMap();
+        return;
+    }
+
+    for ( const int32_t nodeIdx : invalidatedNodes ) {
+        resetNode( nodeIdx );
+    }
+
+    _frontier.clear();
+
+    const auto addValidNodeToExplore = [this, &nodeStates]( const int32_t index ) {
+        if ( nodeStates[index] != UNCHANGED ) {
+            return;
+        }
+
+        // This node is unreachable
+        if ( index != _pathStart && _nodeFrom[index] == -1 ) {
+            return;
+        }
+
+        nodeStates[index] = ADDED_TO_EXPLORE;
+
+        addNodeToExplore( index );
+    };
+
+    // The invalidated nodes can only be reached again from the valid nodes next to them or from other endpoints of the teleports.
+    for ( const int32_t nodeIdx : invalidatedNodes ) {
+        for ( size_t i = 0; i < directions.size(); ++i ) {
+            if ( Maps::isValidDirection( nodeIdx, directions[i] ) ) {
+                addValidNodeToExplore( nodeIdx + _mapOffset[i] );
+            }
+        }
+
+        for ( const int32_t teleportIdx : world.GetTeleportEndPoints( nodeIdx ) ) {
+            addValidNodeToExplore( teleportIdx );
+        }
+
+        for ( const int32_t whirlpoolIdx : world.GetWhirlpoolEndPoints( nodeIdx ) ) {
+            addValidNodeToExplore( whirlpoolIdx );
+        }
     }
+
+    exploreNodes();
+}
+
+void WorldPathfinder::processWorldMap()
+{
+    initializeNodes();
+    exploreNodes();
 }
 
-void WorldPathfinder::checkAdjacentNodes( std::vector<int> & nodesToExplore, const int currentNodeIdx )
+void WorldPathfinder::checkAdjacentNodes( const int currentNodeIdx )
 {
     const Directions & directions = Direction::All();
-    const WorldNode & currentNode = _cache[currentNodeIdx];
+    const uint32_t currentNodeCost = _nodeCost[currentNodeIdx];
+    const uint32_t currentNodeRemainingMovePoints = _nodeRemainingMovePoints[currentNodeIdx];
     const uint32_t maxMovePoints = getMaxMovePoints( world.getTile( currentNodeIdx ).isWater() );
 
     for ( size_t i = 0; i < directions.size(); ++i ) {
@@ -431,14 +635,12 @@ void WorldPathfinder::checkAdjacentNodes( std::vector<int> & nodesToExplore, con
         }
 
         const uint32_t movementPenalty = getMovementPenalty( currentNodeIdx, newIndex, directions[i] );
-        const uint32_t movementCost = currentNode._cost + movementPenalty;
-
-        WorldNode & newNode = _cache[newIndex];
+        const uint32_t movementCost = currentNodeCost + movementPenalty;
 
-        if ( newNode._from == -1 || newNode._cost > movementCost ) {
-            newNode.update( currentNodeIdx, movementCost, subtractMovePoints( currentNode._remainingMovePoints, movementPenalty, maxMovePoints ) );
+        if ( _nodeFrom[newIndex] == -1 || _nodeCost[newIndex] > movementCost ) {
+            updateNode( newIndex, currentNodeIdx, movementCost, subtractMovePoints( currentNodeRemainingMovePoints, movementPenalty, maxMovePoints ) );
 
-            nodesToExplore.push_back( newIndex );
+            addNodeToExplore( newIndex );
         }
     }
 }
@@ -466,16 +668,19 @@ void PlayerWorldPathfinder::reEvaluateIfNeeded( const Heroes & hero )
 
         processWorldMap();
     }
+    else if ( !_invalidatedTiles.empty() ) {
+        processInvalidatedTiles();
+    }
 }
 
 std::list<Route::Step> PlayerWorldPathfinder::buildPath( const int targetIndex ) const
 {
-    assert( _cache.size() == world.getSize() && Maps::isValidAbsIndex( _pathStart ) && Maps::isValidAbsIndex( targetIndex ) );
+    assert( _nodeCost.size() == world.getSize() && Maps::isValidAbsIndex( _pathStart ) && Maps::isValidAbsIndex( targetIndex ) );
 
     std::list<Route::Step> path;
 
     // Destination is not reachable
-    if ( _cache[targetIndex]._cost == 0 ) {
+    if ( _nodeCost[targetIndex] == 0 ) {
         return path;
     }
 
@@ -488,27 +693,26 @@ std::list<Route::Step> PlayerWorldPathfinder::buildPath( const int targetIndex )
     while ( currentNode != _pathStart ) {
         assert( currentNode != -1 );
 
-        const WorldNode & node = _cache[currentNode];
+        const int from = _nodeFrom[currentNode];
 
-        assert( node._from != -1 );
+        assert( from != -1 );
 
-        const uint32_t cost = node._cost - _cache[node._from]._cost;
+        const uint32_t cost = _nodeCost[currentNode] - _nodeCost[from];
 
-        path.emplace_front( currentNode, node._from, Maps::GetDirection( node._from, currentNode ), cost );
+        path.emplace_front( currentNode, from, Maps::GetDirection( from, currentNode ), cost );
 
         // The path should not pass through the same tile more than once
-        assert( uniqPathIndexes.insert( node._from ).second );
+        assert( uniqPathIndexes.insert( from ).second );
 
-        currentNode = node._from;
+        currentNode = from;
     }
 
     return path;
 }
 
-void PlayerWorldPathfinder::processCurrentNode( std::vector<int> & nodesToExplore, const int currentNodeIdx )
+void PlayerWorldPathfinder::processCurrentNode( const int currentNodeIdx )
 {
     const bool isFirstNode = ( currentNodeIdx == _pathStart );
-    const WorldNode & currentNode = _cache[currentNodeIdx];
     const bool fromWater = world.getTile( _pathStart ).isWater();
 
     if ( !isFirstNode && !isTileAvailableForWalkThrough( currentNodeIdx, fromWater ) ) {
@@ -529,17 +733,16 @@ void PlayerWorldPathfinder::processCurrentNode( std::vector<int> & nodesToExplor
             }
 
             const uint32_t movementPenalty = getMovementPenalty( currentNodeIdx, monsterIndex, direction );
-            const uint32_t movementCost = currentNode._cost + movementPenalty;
+            const uint32_t movementCost = _nodeCost[currentNodeIdx] + movementPenalty;
 
-            WorldNode & monsterNode = _cache[monsterIndex];
-
-            if ( monsterNode._from == -1 || monsterNode._cost > movementCost ) {
-                monsterNode.update( currentNodeIdx, movementCost, subtractMovePoints( currentNode._remainingMovePoints, movementPenalty, maxMovePoints ) );
+            if ( _nodeFrom[monsterIndex] == -1 || _nodeCost[monsterIndex] > movementCost ) {
+                updateNode( monsterIndex, currentNodeIdx, movementCost,
+                            subtractMovePoints( _nodeRemainingMovePoints[currentNodeIdx], movementPenalty, maxMovePoints ) );
             }
         }
     }
     else {
-        checkAdjacentNodes( nodesToExplore, currentNodeIdx );
+        checkAdjacentNodes( currentNodeIdx );
     }
 }
 
@@ -569,6 +772,8 @@ void AIWorldPathfinder::reset()
 
     _townGateCastleIndex = -1;
     _townPortalCastleIndexes.clear();
+
+    _tileFlags.resize( _nodeCost.size() );
 }
 
 void AIWorldPathfinder::reEvaluateIfNeeded( const Heroes & hero )
@@ -651,6 +856,9 @@ void AIWorldPathfinder::reEvaluateIfNeeded( const Heroes & hero )
 
         processWorldMap();
     }
+    else if ( !_invalidatedTiles.empty() ) {
+        processInvalidatedTiles();
+    }
 }
 
 void AIWorldPathfinder::reEvaluateIfNeeded( const int start, const PlayerColor color, const double armyStrength, const uint8_t skill )
@@ -667,53 +875,60 @@ void AIWorldPathfinder::reEvaluateIfNeeded( const int start, const PlayerColor c
 
         processWorldMap();
     }
+    else if ( !_invalidatedTiles.empty() ) {
+        processInvalidatedTiles();
+    }
 }
 
 bool AIWorldPathfinder::isTileAccessibleForAI( const int tileIndex )
 {
-    std::optional<bool> & isAccessible = _cache[tileIndex]._isAccessibleForAI;
-    if ( !isAccessible ) {
-        isAccessible = isTileAccessibleForAIWithArmy( tileIndex, _armyStrength, _minimalArmyStrengthAdvantage );
+    uint8_t & flags = _tileFlags[tileIndex];
+    if ( ( flags & ACCESSIBLE_EVALUATED ) == 0 ) {
+        flags |= ACCESSIBLE_EVALUATED;
+
+        if ( isTileAccessibleForAIWithArmy( tileIndex, _armyStrength, _minimalArmyStrengthAdvantage ) ) {
+            flags |= ACCESSIBLE;
+        }
     }
 
-    return *isAccessible;
+    return ( flags & ACCESSIBLE ) != 0;
 }
 
 bool AIWorldPathfinder::isTileAvailableForWalkThroughForAI( const int tileIndex, const bool fromWater )
 {
-    std::optional<bool> & isAvailableForWalkThrough
-        = fromWater ? _cache[tileIndex]._isAvailableForWalkThroughForAI.fromWater : _cache[tileIndex]._isAvailableForWalkThroughForAI.fromLand;
-    if ( !isAvailableForWalkThrough ) {
-        isAvailableForWalkThrough = isTileAvailableForWalkThroughForAIWithArmy( tileIndex, fromWater, _color, _isArtifactsBagFull, _isEquippedWithSpellBook,
-                                                                                _armyStrength, _minimalArmyStrengthAdvantage );
+    const uint8_t evaluatedFlag = fromWater ? WALK_THROUGH_FROM_WATER_EVALUATED : WALK_THROUGH_FROM_LAND_EVALUATED;
+    const uint8_t availableFlag = fromWater ? WALK_THROUGH_FROM_WATER : WALK_THROUGH_FROM_LAND;
+
+    uint8_t & flags = _tileFlags[tileIndex];
+    if ( ( flags & evaluatedFlag ) == 0 ) {
+        flags |= evaluatedFlag;
+
+        if ( isTileAvailableForWalkThroughForAIWithArmy( tileIndex, fromWater, _color, _isArtifactsBagFull, _isEquippedWithSpellBook, _armyStrength,
+                                                         _minimalArmyStrengthAdvantage ) ) {
+            flags |= availableFlag;
+        }
     }
 
-    return *isAvailableForWalkThrough;
+    return ( flags & availableFlag ) != 0;
 }
 
 void AIWorldPathfinder::processWorldMap()
 {
-    assert( _cache.size() == world.getSize() && Maps::isValidAbsIndex( _pathStart ) );
-
-    for ( WorldNode & node : _cache ) {
-        node = {};
-    }
+    initializeNodes();
 
-    _cache[_pathStart].update( -1, 0, _remainingMovePoints );
+    assert( _tileFlags.size() == _nodeCost.size() );
 
-    std::vector<int> nodesToExplore;
-    nodesToExplore.push_back( _pathStart );
+    std::fill( _tileFlags.begin(), _tileFlags.end(), static_cast<uint8_t>( 0 ) );
 
-    const auto processTownPortal = [this, &nodesToExplore]( const Spell & spell, const int32_t castleIndex ) {
-        assert( castleIndex >= 0 && static_cast<size_t>( castleIndex ) < _cache.size() );
-        assert( castleIndex != _pathStart && _cache[castleIndex]._from == -1 );
+    const auto processTownPortal = [this]( const Spell & spell, const int32_t castleIndex ) {
+        assert( castleIndex >= 0 && static_cast<size_t>( castleIndex ) < _nodeCost.size() );
+        assert( castleIndex != _pathStart && _nodeFrom[castleIndex] == -1 );
 
         const uint32_t cost = spell.movePoints();
         const uint32_t remaining = ( _remainingMovePoints < cost ) ? 0 : _remainingMovePoints - cost;
 
-        _cache[castleIndex].update( _pathStart, cost, remaining );
-
-        nodesToExplore.push_back( castleIndex );
+        updateNode( castleIndex, _pathStart, cost, remaining );
+        addNodeToExplore( castleIndex );
     };
 
     if ( _townGateCastleIndex != -1 ) {
@@ -728,9 +943,7 @@ void AIWorldPathfinder::processWorldMap()
         processTownPortal( Spell::TOWNPORTAL, idx );
     }
 
-    for ( size_t lastProcessedNode = 0; lastProcessedNode < nodesToExplore.size(); ++lastProcessedNode ) {
-        processCurrentNode( nodesToExplore, nodesToExplore[lastProcessedNode] );
-    }
+    exploreNodes();
 }
 
 bool AIWorldPathfinder::isMovementAllowed( const int from, const int direction ) const
@@ -738,10 +951,9 @@ bool AIWorldPathfinder::isMovementAllowed( const int from, const int direction )
     return isMovementAllowedForColor( from, direction, _color, false, _isSummonBoatSpellAvailable );
 }
 
-void AIWorldPathfinder::processCurrentNode( std::vector<int> & nodesToExplore, const int currentNodeIdx )
+void AIWorldPathfinder::processCurrentNode( const int currentNodeIdx )
 {
     const bool isFirstNode = ( currentNodeIdx == _pathStart );
-    WorldNode & currentNode = _cache[currentNodeIdx];
 
     // Always allow movement from the starting point to cover the edge case where we got here before this tile became blocked
     if ( !isFirstNode ) {
@@ -759,15 +971,15 @@ void AIWorldPathfinder::processCurrentNode( std::vector<int> & nodesToExplore, c
 
         if ( !isTileAccessible ) {
             // If we can't move here, then reset the node
-            currentNode.reset();
+            resetNode( currentNodeIdx );
 
             return;
         }
 
         // No dead ends allowed
-        assert( currentNode._from != -1 );
+        assert( _nodeFrom[currentNodeIdx] != -1 );
 
-        const bool fromWater = world.getTile( currentNode._from ).isWater();
+        const bool fromWater = world.getTile( _nodeFrom[currentNodeIdx] ).isWater();
 
         if ( !isTileAvailableForWalkThroughForAI( currentNodeIdx, fromWater ) ) {
             return;
@@ -787,8 +999,8 @@ void AIWorldPathfinder::processCurrentNode( std::vector<int> & nodesToExplore, c
 
     // Check adjacent nodes only if we are either not on the teleport tile, or we got here from another endpoint of this teleport.
     // Do not check them if we came to the tile with a teleport from a neighboring tile (and are going to use it for teleportation).
-    if ( teleports.empty() || std::find( teleports.begin(), teleports.end(), currentNode._from ) != teleports.end() ) {
-        checkAdjacentNodes( nodesToExplore, currentNodeIdx );
+    if ( teleports.empty() || std::find( teleports.begin(), teleports.end(), _nodeFrom[currentNodeIdx] ) != teleports.end() ) {
+        checkAdjacentNodes( currentNodeIdx );
     }
 
     // Special case: movement via teleport
@@ -797,13 +1009,11 @@ void AIWorldPathfinder::processCurrentNode( std::vector<int> & nodesToExplore, c
             continue;
         }
 
-        WorldNode & teleportNode = _cache[teleportIdx];
-
         // Check if the movement is really faster via teleport
-        if ( teleportNode._from == -1 || teleportNode._cost > currentNode._cost ) {
-            teleportNode.update( currentNodeIdx, currentNode._cost, currentNode._remainingMovePoints );
+        if ( _nodeFrom[teleportIdx] == -1 || _nodeCost[teleportIdx] > _nodeCost[currentNodeIdx] ) {
+            updateNode( teleportIdx, currentNodeIdx, _nodeCost[currentNodeIdx], _nodeRemainingMovePoints[currentNodeIdx] );
 
-            nodesToExplore.push_back( teleportIdx );
+            addNodeToExplore( teleportIdx );
         }
     }
 }
@@ -829,12 +1039,12 @@ uint32_t AIWorldPathfinder::getMovementPenalty( const int from, const int to, co
             return regularPenalty;
         }
 
-        const WorldNode & node = _cache[from];
+        const int prevFrom = _nodeFrom[from];
 
         // No dead ends allowed
-        assert( node._from != -1 );
+        assert( prevFrom != -1 );
 
-        const int prevStepDirection = Maps::GetDirection( node._from, from );
+        const int prevStepDirection = Maps::GetDirection( prevFrom, from );
         assert( prevStepDirection != Direction::UNKNOWN && prevStepDirection != Direction::CENTER );
 
         // If we are moving from a tile that we technically cannot stand on, then it means that there was
@@ -850,7 +1060,7 @@ uint32_t AIWorldPathfinder::getMovementPenalty( const int from, const int to, co
         //
         // The real path will not reach this step, so this logic will be used to estimate distances more
         // accurately when choosing whether to move through objects or past them.
-        return regularPenalty + WorldPathfinder::getMovementPenalty( node._from, from, prevStepDirection );
+        return regularPenalty + WorldPathfinder::getMovementPenalty( prevFrom, from, prevStepDirection );
     }();
 
     const uint32_t maxMovePoints = getMaxMovePoints( fromTile.isWater() );
@@ -859,10 +1069,10 @@ uint32_t AIWorldPathfinder::getMovementPenalty( const int from, const int to, co
     // If we perform pathfinding for a real AI-controlled hero on the map, we should correctly calculate
     // movement penalties when this hero overcomes water obstacles using boats.
     if ( maxMovePoints > 0 ) {
-        const WorldNode & node = _cache[from];
-
         // No dead ends allowed
-        assert( from == _pathStart || node._from != -1 );
+        assert( from == _pathStart || _nodeFrom[from] != -1 );
+
+        const uint32_t remainingMovePoints = _nodeRemainingMovePoints[from];
 
         const Maps::Tile & toTile = world.getTile( to );
 
@@ -875,11 +1085,11 @@ uint32_t AIWorldPathfinder::getMovementPenalty( const int from, const int to, co
         if ( isComesOnBoard || isDisembarks ) {
             // If the hero is not able to make this movement this turn, then he will have to spend
             // all the movement points next turn.
-            if ( defaultPenalty > node._remainingMovePoints ) {
+            if ( defaultPenalty > remainingMovePoints ) {
                 return maxMovePoints;
             }
 
-            return node._remainingMovePoints;
+            return remainingMovePoints;
         }
     }
 
@@ -902,8 +1112,8 @@ std::pair<int32_t, bool> AIWorldPathfinder::getFogDiscoveryTile( const Heroes &
 
         TileCharacteristics bestTile;
 
-        for ( size_t idx = 0; idx < _cache.size(); ++idx ) {
-            const uint32_t nodeCost = _cache[idx]._cost;
+        for ( size_t idx = 0; idx < _nodeCost.size(); ++idx ) {
+            const uint32_t nodeCost = _nodeCost[idx];
             if ( nodeCost == 0 ) {
                 continue;
             }
@@ -959,7 +1169,7 @@ std::pair<int32_t, bool> AIWorldPathfinder::getFogDiscoveryTile( const Heroes &
     // If we are unlucky, then we need to do the heavy lifting and consider the accessible tiles that have at least one neighboring tile that is inaccessible to the hero
     // (since there may be unexplored tiles covered with fog on the other side of such an obstacle).
     {
-        const int32_t bestTileIdx = findBestTile( [this]( const int32_t tileIdx ) { return _cache[tileIdx]._cost == 0; } );
+        const int32_t bestTileIdx = findBestTile( [this]( const int32_t tileIdx ) { return _nodeCost[tileIdx] == 0; } );
         if ( bestTileIdx != -1 ) {
             return { bestTileIdx, false };
         }
@@ -994,10 +1204,8 @@ int AIWorldPathfinder::getNearestTileToMove( const Heroes & hero )
             continue;
         }
 
-        const WorldNode & node = _cache[newIndex];
-
         // Tile is directly reachable (in one move) and the hero has enough army to defeat potential guards
-        if ( node._cost > 0 && node._from == start ) {
+        if ( _nodeCost[newIndex] > 0 && _nodeFrom[newIndex] == start ) {
             return newIndex;
         }
     }
@@ -1164,12 +1372,12 @@ bool AIWorldPathfinder::isHeroPossiblyBlockingWay( const Heroes & hero )
 
 std::vector<IndexObject> AIWorldPathfinder::getObjectsOnTheWay( const int targetIndex ) const
 {
-    assert( _cache.size() == world.getSize() && Maps::isValidAbsIndex( _pathStart ) && _color != PlayerColor::NONE && Maps::isValidAbsIndex( targetIndex ) );
+    assert( _nodeCost.size() == world.getSize() && Maps::isValidAbsIndex( _pathStart ) && _color != PlayerColor::NONE && Maps::isValidAbsIndex( targetIndex ) );
 
     std::vector<IndexObject> result;
 
     // Destination is not reachable
-    if ( _cache[targetIndex]._cost == 0 ) {
+    if ( _nodeCost[targetIndex] == 0 ) {
         return result;
     }
 
@@ -1197,7 +1405,7 @@ std::vector<IndexObject> AIWorldPathfinder::getObjectsOnTheWay( const int target
     while ( currentNode != _pathStart ) {
         assert( currentNode != -1 );
 
-        const int from = _cache[currentNode]._from;
+        const int from = _nodeFrom[currentNode];
 
         assert( from != -1 );
 
@@ -1343,12 +1551,12 @@ std::list<Route::Step> AIWorldPathfinder::buildDimensionDoorPath( const int targ
 
 std::list<Route::Step> AIWorldPathfinder::buildPath( const int targetIndex ) const
 {
-    assert( _cache.size() == world.getSize() && Maps::isValidAbsIndex( _pathStart ) && Maps::isValidAbsIndex( targetIndex ) );
+    assert( _nodeCost.size() == world.getSize() && Maps::isValidAbsIndex( _pathStart ) && Maps::isValidAbsIndex( targetIndex ) );
 
     std::list<Route::Step> path;
 
     // Destination is not reachable
-    if ( _cache[targetIndex]._cost == 0 ) {
+    if ( _nodeCost[targetIndex] == 0 ) {
         return path;
     }
 
@@ -1368,18 +1576,18 @@ std::list<Route::Step> AIWorldPathfinder::buildPath( const int targetIndex ) con
             lastValidNode = currentNode;
         }
 
-        const WorldNode & node = _cache[currentNode];
+        const int from = _nodeFrom[currentNode];
 
-        assert( node._from != -1 );
+        assert( from != -1 );
 
-        const uint32_t cost = node._cost - _cache[node._from]._cost;
+        const uint32_t cost = _nodeCost[currentNode] - _nodeCost[from];
 
-        path.emplace_front( currentNode, node._from, Maps::GetDirection( node._from, currentNode ), cost );
+        path.emplace_front( currentNode, from, Maps::GetDirection( from, currentNode ), cost );
 
         // The path should not pass through the same tile more than once
-        assert( uniqPathIndexes.insert( node._from ).second );
+        assert( uniqPathIndexes.insert( from ).second );
 
-        currentNode = node._from;
+        currentNode = from;
     }
 
     // Cut the path to the last valid tile/obstacle
@@ -1395,9 +1603,9 @@ uint32_t AIWorldPathfinder::getDistance( const int start, const int targetIndex,
 {
     reEvaluateIfNeeded( start, color, armyStrength, skill );
 
-    assert( targetIndex >= 0 && static_cast<size_t>( targetIndex ) < _cache.size() );
+    assert( targetIndex >= 0 && static_cast<size_t>( targetIndex ) < _nodeCost.size() );
 
-    return _cache[targetIndex]._cost;
+    return _nodeCost[targetIndex];
 }
 
 void AIWorldPathfinder::setMinimalArmyStrengthAdvantage( const double advantage )
@@ -22,7 +22,6 @@
 
 #include <cstdint>
 #include <list>
-#include <optional>
 #include <utility>
 #include <vector>
 
@@ -37,40 +36,6 @@ namespace Route
     class Step;
 }
 
-struct WorldNode final
-{
-    int _from{ -1 };
-    uint32_t _cost{ 0 };
-    // The number of movement points remaining for the hero after moving to this node
-    uint32_t _remainingMovePoints{ 0 };
-
-    // When calculating tile availability for an AI-controlled player, various relatively heavy computations are
-    // performed, the result of which does not depend on the direction in which the tile is entered. The results
-    // of these calculations can be cached.
-    std::optional<bool> _isAccessibleForAI;
-    struct
-    {
-        std::optional<bool> fromWater;
-        std::optional<bool> fromLand;
-    } _isAvailableForWalkThroughForAI;
-
-    WorldNode() = default;
-
-    void update( const int from, const uint32_t cost, const uint32_t remainingMovePoints )
-    {
-        _from = from;
-        _cost = cost;
-        _remainingMovePoints = remainingMovePoints;
-    }
-
-    void reset()
-    {
-        _from = -1;
-        _cost = 0;
-        _remainingMovePoints = 0;
-    }
-};
-
 // Abstract class that provides basic functionality for navigating the World Map
 class WorldPathfinder
 {
@@ -84,10 +49,52 @@ public:
 
     virtual void reset();
 
+    // Marks the tile as changed. As long as the pathfinding settings remain the same, only the nodes that could be affected
+    // by the changes of the marked tiles are re-evaluated by the next call of reEvaluateIfNeeded() instead of the whole map.
+    void invalidateTile( const int32_t tileIndex );
+
     uint32_t getDistance( int targetIndex ) const;
 
+    // Returns the distances to all tiles of the map calculated during the last evaluation. Unreachable tiles have zero distance.
+    const std::vector<uint32_t> & getDistances() const
+    {
+        return _nodeCost;
+    }
+
 protected:
-    void checkAdjacentNodes( std::vector<int> & nodesToExplore, const int currentNodeIdx );
+    void updateNode( const int index, const int from, const uint32_t cost, const uint32_t remainingMovePoints )
+    {
+        _nodeFrom[index] = from;
+        _nodeCost[index] = cost;
+        _nodeRemainingMovePoints[index] = remainingMovePoints;
+    }
+
+    void resetNode( const int index )
+    {
+        updateNode( index, -1, 0, 0 );
+    }
+
+    // Adds the node to the frontier of nodes to explore using its current cost as a priority
+    void addNodeToExplore( const int index );
+
+    // Resets all nodes and the frontier, then initializes the starting node and adds it to the frontier
+    void initializeNodes();
+
+    // Processes the nodes from the frontier in the order of increasing cost until the frontier is empty
+    void exploreNodes();
+
+    // Re-evaluates the nodes affected by the changes of the invalidated tiles. Falls back to the re-evaluation of the whole
+    // map if the affected nodes cannot be repaired locally.
+    void processInvalidatedTiles();
+
+    // Resets the cached information about the tile which does not depend on the path to this tile. Can be overridden by a
+    // derived class.
+    virtual void resetTileCache( const int /* tileIndex */ )
+    {
+        // Do nothing.
+    }
+
+    void checkAdjacentNodes( const int currentNodeIdx );
 
     virtual void processWorldMap();
 
@@ -96,7 +103,7 @@ protected:
     virtual bool isMovementAllowed( const int from, const int direction ) const;
 
     // Defines the pathfinding rules and should be implemented by a derived class.
-    virtual void processCurrentNode( std::vector<int> & nodesToExplore, const int currentNodeIdx ) = 0;
+    virtual void processCurrentNode( const int currentNodeIdx ) = 0;
 
     // Returns the maximum number of movement points, depending on whether the movement is performed by land or by
     // water. Should be implemented by a derived class.
@@ -109,9 +116,28 @@ protected:
     // overridden by a derived class.
     virtual uint32_t getMovementPenalty( const int from, const int to, const int direction ) const;
 
-    std::vector<WorldNode> _cache;
+    // The state of every node (tile) of the world map is stored in separate arrays, so that the code which needs
+    // only some of the node properties (e.g. the cost) does not load the rest of them into the CPU cache.
+    std::vector<int32_t> _nodeFrom;
+    std::vector<uint32_t> _nodeCost;
+    // The number of movement points remaining for the hero after moving to the node
+    std::vector<uint32_t> _nodeRemainingMovePoints;
+
     std::vector<int> _mapOffset;
 
+    // Binary min-heap of nodes to explore, ordered by cost and then by index. Each entry stores the cost of the node at the
+    // time it was added, so the entries which became obsolete because a cheaper path to the node was found can be skipped.
+    std::vector<std::pair<uint32_t, int32_t>> _frontier;
+
+    // Tiles that have been changed since the last evaluation of the map
+    std::vector<int32_t> _invalidatedTiles;
+
+    // Buffers used by processInvalidatedTiles()
+    std::vector<uint8_t> _repairNodeStates;
+    std::vector<int32_t> _repairInvalidatedNodes;
+    std::vector<int32_t> _repairNextNodeOffsets;
+    std::vector<int32_t> _repairNextNodes;
+
     // The hero properties used by the pathfinder are cached here not just for optimization, but also because some
     // of them may change even if the position of the hero does not change, so it should be possible to compare the
     // old values with the new ones to determine whether the pathfinder cache needs to be recalculated.
@@ -141,7 +167,7 @@ public:
 
 private:
     // Follows regular passability rules (for the human player)
-    void processCurrentNode( std::vector<int> & nodesToExplore, const int currentNodeIdx ) override;
+    void processCurrentNode( const int currentNodeIdx ) override;
 
     // Returns the maximum number of movement points. This class is not intended for planning paths passing both on
     // land and on water at the same time, so the maximum number of movement points corresponding to the type of
@@ -230,7 +256,7 @@ private:
     bool isMovementAllowed( const int from, const int direction ) const override;
 
     // Follows custom passability rules (for the AI)
-    void processCurrentNode( std::vector<int> & nodesToExplore, const int currentNodeIdx ) override;
+    void processCurrentNode( const int currentNodeIdx ) override;
 
     // Returns the maximum number of movement points, depending on whether the movement is performed by land or by
     // water
@@ -242,6 +268,11 @@ private:
     // this hero and it should also have a valid information about the hero's remaining movement points.
     uint32_t getMovementPenalty( const int from, const int to, const int direction ) const override;
 
+    void resetTileCache( const int tileIndex ) override
+    {
+        _tileFlags[tileIndex] = 0;
+    }
+
     // The hero properties used by the pathfinder are cached here not just for optimization, but also because some
     // of them may change even if the position of the hero does not change, so it should be possible to compare the
     // old values with the new ones to determine whether the pathfinder cache needs to be recalculated.
@@ -267,6 +298,21 @@ private:
     int32_t _townGateCastleIndex{ -1 };
     std::vector<int32_t> _townPortalCastleIndexes;
 
+    // When calculating tile availability for an AI-controlled player, various relatively heavy computations are
+    // performed, the result of which does not depend on the direction in which the tile is entered. The results
+    // of these calculations are cached as a set of TileFlag bits per tile.
+    enum TileFlag : uint8_t
+    {
+        ACCESSIBLE_EVALUATED = 0x01,
+        ACCESSIBLE = 0x02,
+        WALK_THROUGH_FROM_LAND_EVALUATED = 0x04,
+        WALK_THROUGH_FROM_LAND = 0x08,
+        WALK_THROUGH_FROM_WATER_EVALUATED = 0x10,
+        WALK_THROUGH_FROM_WATER = 0x20
+    };
+
+    std::vector<uint8_t> _tileFlags;
+
     // Coefficient of the minimum required advantage in army strength in order to be able to "pass through" protected
     // tiles from the AI pathfinder's point of view
     double _minimalArmyStrengthAdvantage{ 1.0 };
@@ -0,0 +1,579 @@
+/***************************************************************************
+ *   fheroes2: https://github.com/ihhub/fheroes2                           *
+ *   Copyright (C) 2025                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+// This is a headless driver of the game engine. It does not create any window, does not initialize the video and audio subsystems and is intended
+// to be used to measure the performance of the AI and world update code on real maps without any rendering being involved and to evaluate
+// the outcomes of battles between arbitrary armies.
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "agg.h"
+#include "ai_planner.h"
+#include "army.h"
+#include "army_troop.h"
+#include "battle_simulator.h"
+#include "castle.h"
+#include "color.h"
+#include "core.h"
+#include "game.h"
+#include "game_interface.h"
+#include "game_mode.h"
+#include "game_over.h"
+#include "heroes.h"
+#include "kingdom.h"
+#include "logging.h"
+#include "maps_fileinfo.h"
+#include "monster.h"
+#include "players.h"
+#include "settings.h"
+#include "system.h"
+#include "timing.h"
+#include "tools.h"
+#include "world.h"
+#include "world_pathfinding.h"
+
+namespace
+{
+    struct GameSimulationStats
+    {
+        uint32_t days{ 0 };
+
+        // Duration of every AI kingdom turn, in milliseconds.
+        std::vector<double> turnDurations;
+
+        // Total duration of the simulation excluding the map loading, in seconds.
+        double totalDuration{ 0 };
+    };
+
+    void printUsage( char ** argv )
+    {
+        const std::string toolName = System::GetFileName( argv[0] );
+
+        std::cerr << toolName << " runs the game engine without any user interface for benchmarking purposes." << std::endl
+                  << "Syntax: " << toolName << " game map_file [max_days [runs]]" << std::endl
+                  << "        " << toolName << " pathfinder map_file [iterations]" << std::endl
+                  << "        " << toolName << " battle attacker_army defender_army [battles [seed [threads]]]" << std::endl
+                  << "Armies are comma-separated lists of monster_id:count pairs, e.g. 12:20,14:5" << std::endl;
+    }
+
+    std::optional<uint32_t> parseCount( const char * value )
+    {
+        char * end = nullptr;
+        const unsigned long result = std::strtoul( value, &end, 10 );
+        if ( end == value || *end != '\0' || result == 0 || result > UINT32_MAX ) {
+            return {};
+        }
+
+        return static_cast<uint32_t>( result );
+    }
+
+    double getPercentile( std::vector<double> values, const double percentile )
+    {
+        if ( values.empty() ) {
+            return 0;
+        }
+
+        assert( percentile >= 0 && percentile <= 1 );
+
+        const size_t idx = std::min( static_cast<size_t>( percentile * static_cast<double>( values.size() ) ), values.size() - 1 );
+
+        std::nth_element( values.begin(), values.begin() + static_cast<std::ptrdiff_t>( idx ), values.end() );
+
+        return values[idx];
+    }
+
+    // Parses an army definition in the "monster_id:count[,monster_id:count...]" format.
+    bool parseArmy( const std::string & definition, Army & army )
+    {
+        size_t troopId = 0;
+        size_t pos = 0;
+
+        while ( pos <= definition.size() ) {
+            const size_t end = std::min( definition.find( ',', pos ), definition.size() );
+            const std::string troopDefinition = definition.substr( pos, end - pos );
+
+            const size_t separator = troopDefinition.find( ':' );
+            if ( separator == std::string::npos || troopId >= Army::maximumTroopCount ) {
+                return false;
+            }
+
+            const auto monsterId = parseCount( troopDefinition.substr( 0, separator ).c_str() );
+            const auto count = parseCount( troopDefinition.substr( separator + 1 ).c_str() );
+            if ( !monsterId || !count ) {
+                return false;
+            }
+
+            const Monster monster( static_cast<int>( *monsterId ) );
+            if ( !monster.isValid() ) {
+                return false;
+            }
+
+            army.GetTroop( troopId )->Set( monster, *count );
+            ++troopId;
+
+            pos = end + 1;
+        }
+
+        return army.isValid();
+    }
+
+    bool loadMap( const std::string & mapFile )
+    {
+        Maps::FileInfo mapInfo;
+
+        const std::string lowerCaseMapFile = StringLower( mapFile );
+        const std::string resurrectionMapExtension( ".fh2m" );
+
+        const bool isResurrectionMap = ( lowerCaseMapFile.size() > resurrectionMapExtension.size()
+                                         && lowerCaseMapFile.compare( lowerCaseMapFile.size() - resurrectionMapExtension.size(), resurrectionMapExtension.size(),
+                                                                      resurrectionMapExtension )
+                                                == 0 );
+        if ( isResurrectionMap ? !mapInfo.readResurrectionMap( mapFile, false ) : !mapInfo.readMP2Map( mapFile, false ) ) {
+            std::cerr << "Cannot read map file " << mapFile << std::endl;
+            return false;
+        }
+
+        Settings & conf = Settings::Get();
+
+        conf.SetGameType( Game::TYPE_STANDARD );
+        conf.setCurrentMapInfo( mapInfo );
+
+        // Every kingdom on the map is controlled by AI.
+        Players & players = conf.GetPlayers();
+        for ( Player * player : players ) {
+            assert( player != nullptr );
+
+            player->SetControl( CONTROL_AI );
+        }
+
+        players.SetStartGame();
+
+        GameOver::Result::Get().Reset();
+
+        const Maps::FileInfo & currentMapInfo = conf.getCurrentMapInfo();
+        const bool isLoaded = ( currentMapInfo.version == GameVersion::RESURRECTION )
+                                  ? world.loadResurrectionMap( currentMapInfo.filename )
+                                  : world.LoadMapMP2( currentMapInfo.filename, ( currentMapInfo.version == GameVersion::SUCCESSION_WARS ) );
+        if ( !isLoaded ) {
+            std::cerr << "Map " << mapFile << " is corrupted" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    // Mimics Interface::AdventureMap::StartGame() for AI-only games, but without rendering, dialogs and the game over checks which require user interaction.
+    // The simulation stops when only one kingdom is left or when the day limit is reached.
+    GameSimulationStats runGame( const uint32_t maxDays )
+    {
+        Settings & conf = Settings::Get();
+
+        GameSimulationStats stats;
+
+        const std::vector<Player *> & players = conf.GetPlayers().getVector();
+
+        for ( const Player * player : players ) {
+            world.ClearFog( player->GetColor() );
+        }
+
+        // The interface still exists because AI code updates the status panel and the game area, but nothing should actually be drawn.
+        const Interface::AdventureMap::RedrawLocker redrawLocker( Interface::AdventureMap::Get() );
+
+        const fheroes2::Time totalTime;
+
+        while ( stats.days < maxDays ) {
+            world.NewDay();
+            ++stats.days;
+
+            for ( const Player * player : players ) {
+                assert( player != nullptr );
+
+                const PlayerColor playerColor = player->GetColor();
+                Kingdom & kingdom = world.GetKingdom( playerColor );
+
+                if ( !kingdom.isPlay() ) {
+                    continue;
+                }
+
+                conf.SetCurrentColor( playerColor );
+
+                const fheroes2::Time turnTime;
+
+                kingdom.ActionNewDayResourceUpdate( nullptr );
+                kingdom.ActionBeforeTurn();
+
+                const fheroes2::GameMode result = AI::Planner::Get().KingdomTurn( kingdom );
+
+                stats.turnDurations.push_back( turnTime.getS() * 1000 );
+
+                if ( result != fheroes2::GameMode::END_TURN ) {
+                    // One of the victory conditions has been met.
+                    stats.totalDuration = totalTime.getS();
+                    return stats;
+                }
+            }
+
+            conf.SetCurrentColor( PlayerColor::NONE );
+
+            const ptrdiff_t activeKingdoms = std::count_if( players.begin(), players.end(), []( const Player * player ) {
+                assert( player != nullptr );
+
+                return world.GetKingdom( player->GetColor() ).isPlay();
+            } );
+            if ( activeKingdoms <= 1 ) {
+                break;
+            }
+        }
+
+        stats.totalDuration = totalTime.getS();
+
+        return stats;
+    }
+
+    void printGameStats( const GameSimulationStats & stats )
+    {
+        double sum = 0;
+        double maxDuration = 0;
+
+        for ( const double duration : stats.turnDurations ) {
+            sum += duration;
+            maxDuration = std::max( maxDuration, duration );
+        }
+
+        const double average = stats.turnDurations.empty() ? 0 : sum / static_cast<double>( stats.turnDurations.size() );
+        const double daysPerSecond = stats.totalDuration > 0 ? stats.days / stats.totalDuration : 0;
+
+        std::cout << std::fixed << std::setprecision( 3 ) << "Days: " << stats.days << ", total time: " << stats.totalDuration << " s, days/s: " << daysPerSecond
+                  << std::endl
+                  << "Turn latency (ms): count " << stats.turnDurations.size() << ", avg " << average << ", p50 " << getPercentile( stats.turnDurations, 0.5 )
+                  << ", p95 " << getPercentile( stats.turnDurations, 0.95 ) << ", max " << maxDuration << std::endl;
+    }
+
+    int simulateGame( const int argc, char ** argv )
+    {
+        assert( argc >= 3 );
+
+        const std::string mapFile = argv[2];
+
+        uint32_t maxDays = 28 * 12;
+        uint32_t runs = 1;
+
+        if ( argc > 3 ) {
+            const auto value = parseCount( argv[3] );
+            if ( !value ) {
+                std::cerr << "Invalid number of days: " << argv[3] << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            maxDays = *value;
+        }
+
+        if ( argc > 4 ) {
+            const auto value = parseCount( argv[4] );
+            if ( !value ) {
+                std::cerr << "Invalid number of runs: " << argv[4] << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            runs = *value;
+        }
+
+        Settings & conf = Settings::Get();
+
+        // Hide all AI hero movements, otherwise AI turns will be slowed down by animation delays.
+        conf.SetAIMoveSpeed( 0 );
+
+        GameSimulationStats total;
+
+        for ( uint32_t run = 1; run <= runs; ++run ) {
+            if ( !loadMap( mapFile ) ) {
+                return EXIT_FAILURE;
+            }
+
+            std::cout << "Run " << run << " of " << runs << ": " << mapFile << std::endl;
+
+            const GameSimulationStats stats = runGame( maxDays );
+            printGameStats( stats );
+
+            total.days += stats.days;
+            total.totalDuration += stats.totalDuration;
+            total.turnDurations.insert( total.turnDurations.end(), stats.turnDurations.begin(), stats.turnDurations.end() );
+        }
+
+        if ( runs > 1 ) {
+            std::cout << "Total:" << std::endl;
+            printGameStats( total );
+        }
+
+        return EXIT_SUCCESS;
+    }
+
+    struct PathfinderStart
+    {
+        int32_t index{ -1 };
+        PlayerColor color{ PlayerColor::NONE };
+        double armyStrength{ 0 };
+    };
+
+    // Measures the time of full-map evaluations of the AI pathfinder starting from every castle and every hero on the map.
+    int benchmarkPathfinder( const int argc, char ** argv )
+    {
+        assert( argc >= 3 );
+
+        const std::string mapFile = argv[2];
+
+        uint32_t iterations = 10;
+
+        if ( argc > 3 ) {
+            const auto value = parseCount( argv[3] );
+            if ( !value ) {
+                std::cerr << "Invalid number of iterations: " << argv[3] << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            iterations = *value;
+        }
+
+        if ( !loadMap( mapFile ) ) {
+            return EXIT_FAILURE;
+        }
+
+        std::vector<PathfinderStart> starts;
+
+        for ( const Player * player : Settings::Get().GetPlayers() ) {
+            assert( player != nullptr );
+
+            const PlayerColor playerColor = player->GetColor();
+            const Kingdom & kingdom = world.GetKingdom( playerColor );
+
+            for ( const Castle * castle : kingdom.GetCastles() ) {
+                assert( castle != nullptr );
+
+                starts.push_back( { castle->GetIndex(), playerColor, castle->GetArmy().GetStrength() } );
+            }
+
+            for ( const Heroes * hero : kingdom.GetHeroes() ) {
+                assert( hero != nullptr );
+
+                starts.push_back( { hero->GetIndex(), playerColor, hero->GetArmy().GetStrength() } );
+            }
+        }
+
+        if ( starts.empty() ) {
+            std::cerr << "There are no castles or heroes on the map " << mapFile << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        AIWorldPathfinder pathfinder;
+
+        std::vector<double> durations;
+        durations.reserve( static_cast<size_t>( iterations ) * starts.size() );
+
+        // Sum of the distances to all reachable tiles, can be used to verify that changes in the pathfinder do not affect its results.
+        uint64_t checksum = 0;
+
+        for ( uint32_t iteration = 0; iteration < iterations; ++iteration ) {
+            for ( const PathfinderStart & start : starts ) {
+                // Reset the pathfinder to force the full-map evaluation.
+                pathfinder.reset();
+
+                const fheroes2::Time evaluationTime;
+
+                pathfinder.getDistance( start.index, start.index, start.color, start.armyStrength );
+
+                durations.push_back( evaluationTime.getS() * 1000 );
+
+                if ( iteration == 0 ) {
+                    for ( int32_t idx = 0; idx < world.w() * world.h(); ++idx ) {
+                        checksum += pathfinder.getDistance( idx );
+                    }
+                }
+            }
+        }
+
+        double sum = 0;
+        for ( const double duration : durations ) {
+            sum += duration;
+        }
+
+        const double average = sum / static_cast<double>( durations.size() );
+
+        std::cout << std::fixed << std::setprecision( 3 ) << "Map: " << mapFile << " (" << world.w() << "x" << world.h() << "), starting points: " << starts.size()
+                  << ", checksum: " << checksum << std::endl
+                  << "Full-map evaluation (ms): count " << durations.size() << ", avg " << average << ", p50 " << getPercentile( durations, 0.5 ) << ", p95 "
+                  << getPercentile( durations, 0.95 ) << ", evaluations/s: " << ( sum > 0 ? static_cast<double>( durations.size() ) * 1000 / sum : 0 )
+                  << std::endl;
+
+        return EXIT_SUCCESS;
+    }
+
+    void printBattleSideStats( const char * sideName, const Army & army, const Battle::SimulationSideStats & stats, const uint32_t battleCount )
+    {
+        double sum = 0;
+        for ( const double loss : stats.strengthLosses ) {
+            sum += loss;
+        }
+
+        const double average = stats.strengthLosses.empty() ? 0 : sum / static_cast<double>( stats.strengthLosses.size() );
+
+        std::cout << sideName << ": " << army.String() << std::endl
+                  << "    win rate " << stats.getWinRate() * 100 << "%, strength loss (%): avg " << average * 100 << ", p10 " << stats.getLossPercentile( 0.1 ) * 100
+                  << ", p50 " << stats.getLossPercentile( 0.5 ) * 100 << ", p90 " << stats.getLossPercentile( 0.9 ) * 100 << std::endl;
+
+        size_t killedId = 0;
+
+        for ( size_t i = 0; i < army.Size(); ++i ) {
+            const Troop * troop = army.GetTroop( i );
+            if ( troop == nullptr || !troop->isValid() ) {
+                continue;
+            }
+
+            assert( killedId < stats.killedMonsters.size() );
+
+            std::cout << "    " << troop->GetName() << ": " << troop->GetCount() << ", average loss "
+                      << static_cast<double>( stats.killedMonsters[killedId] ) / battleCount << std::endl;
+
+            ++killedId;
+        }
+    }
+
+    // Runs a number of auto-combat battles between two armies without commanders and reports the win rates and the distributions of losses.
+    int simulateBattles( const int argc, char ** argv )
+    {
+        if ( argc < 4 ) {
+            printUsage( argv );
+            return EXIT_FAILURE;
+        }
+
+        Army attackerArmy;
+        if ( !parseArmy( argv[2], attackerArmy ) ) {
+            std::cerr << "Invalid attacker army: " << argv[2] << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        Army defenderArmy;
+        if ( !parseArmy( argv[3], defenderArmy ) ) {
+            std::cerr << "Invalid defender army: " << argv[3] << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        uint32_t battleCount = 1000;
+        uint32_t seed = 0;
+        uint32_t threadCount = 0;
+
+        if ( argc > 4 ) {
+            const auto value = parseCount( argv[4] );
+            if ( !value ) {
+                std::cerr << "Invalid number of battles: " << argv[4] << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            battleCount = *value;
+        }
+
+        if ( argc > 5 ) {
+            // Zero is a valid seed.
+            const auto value = ( std::strcmp( argv[5], "0" ) == 0 ) ? std::optional<uint32_t>( 0 ) : parseCount( argv[5] );
+            if ( !value ) {
+                std::cerr << "Invalid seed: " << argv[5] << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            seed = *value;
+        }
+
+        if ( argc > 6 ) {
+            const auto value = parseCount( argv[6] );
+            if ( !value ) {
+                std::cerr << "Invalid number of threads: " << argv[6] << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            threadCount = *value;
+        }
+
+        Battle::prepareSimulationWorld();
+
+        const fheroes2::Time totalTime;
+
+        const Battle::SimulationResult result = Battle::simulateBattles( attackerArmy, defenderArmy, battleCount, seed, threadCount );
+
+        const double duration = totalTime.getS();
+
+        std::cout << std::fixed << std::setprecision( 3 ) << "Battles: " << result.battleCount << ", seed: " << seed << ", total time: " << duration
+                  << " s, battles/s: " << ( duration > 0 ? result.battleCount / duration : 0 ) << std::endl;
+
+        printBattleSideStats( "Attacker", attackerArmy, result.attacker, result.battleCount );
+        printBattleSideStats( "Defender", defenderArmy, result.defender, result.battleCount );
+
+        return EXIT_SUCCESS;
+    }
+}
+
+int main( int argc, char ** argv )
+{
+    if ( argc < 3 ) {
+        printUsage( argv );
+        return EXIT_FAILURE;
+    }
+
+    try {
+        const fheroes2::HardwareInitializer hardwareInitializer;
+        Logging::InitLog();
+
+        Settings::Get().SetProgramPath( argv[0] );
+
+        // No SDL subsystems except the mandatory ones are initialized.
+        const fheroes2::CoreInitializer coreInitializer( {} );
+        const AGG::AGGInitializer aggInitializer;
+
+        Game::Init();
+
+        if ( std::strcmp( argv[1], "game" ) == 0 ) {
+            return simulateGame( argc, argv );
+        }
+
+        if ( std::strcmp( argv[1], "pathfinder" ) == 0 ) {
+            return benchmarkPathfinder( argc, argv );
+        }
+
+        if ( std::strcmp( argv[1], "battle" ) == 0 ) {
+            return simulateBattles( argc, argv );
+        }
+
+        printUsage( argv );
+    }
+    catch ( const std::exception & ex ) {
+        std::cerr << "Exception '" << ex.what() << "' occurred during the simulation." << std::endl;
+    }
+
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,358 @@
+/***************************************************************************
+ *   fheroes2: https://github.com/ihhub/fheroes2                           *
+ *   Copyright (C) 2025                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "agg_file.h"
+#include "image.h"
+#include "image_palette.h"
+#include "image_simd.h"
+#include "image_tool.h"
+#include "math_base.h"
+#include "system.h"
+#include "timing.h"
+
+namespace
+{
+    constexpr int32_t defaultWidth = 1920;
+    constexpr int32_t defaultHeight = 1080;
+    constexpr int32_t defaultIterations = 200;
+
+    // The size of the original game resolution used as a source for scaling.
+    constexpr int32_t originalWidth = 640;
+    constexpr int32_t originalHeight = 480;
+
+    // The size of a big sprite like a castle or a battlefield unit.
+    constexpr int32_t spriteSize = 256;
+
+    struct Benchmark
+    {
+        std::string name;
+
+        // The size of the produced image.
+        fheroes2::Size size;
+
+        // Functions with SIMD fast paths are measured for every supported instruction set.
+        bool hasSimdPaths{ false };
+
+        std::function<void()> run;
+    };
+
+    // Returns the average time of a single run in milliseconds.
+    double measure( const std::function<void()> & run, const int32_t iterations )
+    {
+        // The first run warms up caches.
+        run();
+
+        const fheroes2::Time timer;
+
+        for ( int32_t i = 0; i < iterations; ++i ) {
+            run();
+        }
+
+        return timer.getS() * 1000 / iterations;
+    }
+
+    // Generates a sprite with the typical layout of transform values: an opaque center surrounded by a shadow and transparent pixels.
+    // Colors form short horizontal runs like in most of the game images.
+    fheroes2::Sprite generateSprite( const int32_t width, const int32_t height )
+    {
+        fheroes2::Sprite sprite( width, height );
+
+        for ( int32_t y = 0; y < height; ++y ) {
+            for ( int32_t x = 0; x < width; ++x ) {
+                const size_t offset = static_cast<size_t>( y ) * width + x;
+                const int32_t distance = std::max( std::abs( 2 * x - width ) * height, std::abs( 2 * y - height ) * width );
+
+                uint8_t transform = 0;
+                if ( distance > width * height * 9 / 10 ) {
+                    transform = 1;
+                }
+                else if ( distance > width * height * 8 / 10 ) {
+                    transform = 3;
+                }
+
+                sprite.image()[offset] = static_cast<uint8_t>( ( x / 4 + ( y / 3 ) * 7 ) % 256 );
+                sprite.transform()[offset] = transform;
+            }
+        }
+
+        return sprite;
+    }
+
+    // Encodes the image in the format of non-monochromatic ICN sprites. See decodeICNSprite() function for the description of the format.
+    std::vector<uint8_t> encodeICNSprite( const fheroes2::Image & image )
+    {
+        std::vector<uint8_t> data;
+
+        const int32_t width = image.width();
+
+        for ( int32_t y = 0; y < image.height(); ++y ) {
+            const uint8_t * imageY = image.image() + static_cast<size_t>( y ) * width;
+            const uint8_t * transformY = image.transform() + static_cast<size_t>( y ) * width;
+
+            const auto getRunLength = [width]( const uint8_t * values, const int32_t x, const int32_t maxLength ) {
+                int32_t length = 1;
+                while ( x + length < width && length < maxLength && values[x + length] == values[x] ) {
+                    ++length;
+                }
+                return length;
+            };
+
+            const auto getSameColorLength = [width, imageY, transformY]( const int32_t x, const int32_t maxLength ) {
+                int32_t length = 1;
+                while ( x + length < width && length < maxLength && transformY[x + length] == 0 && imageY[x + length] == imageY[x] ) {
+                    ++length;
+                }
+                return length;
+            };
+
+            int32_t x = 0;
+            while ( x < width ) {
+                const uint8_t transform = transformY[x];
+
+                if ( transform == 1 ) {
+                    const int32_t length = getRunLength( transformY, x, 0x3F );
+                    data.push_back( static_cast<uint8_t>( 0x80 + length ) );
+                    x += length;
+                }
+                else if ( transform > 1 ) {
+                    const int32_t length = getRunLength( transformY, x, 255 );
+                    const uint8_t transformValue = static_cast<uint8_t>( 0x40 | ( ( transform - 2 ) << 2 ) );
+
+                    data.push_back( 0xC0 );
+                    if ( length < 4 ) {
+                        data.push_back( static_cast<uint8_t>( transformValue | length ) );
+                    }
+                    else {
+                        data.push_back( transformValue );
+                        data.push_back( static_cast<uint8_t>( length ) );
+                    }
+                    x += length;
+                }
+                else if ( getSameColorLength( x, 3 ) == 3 ) {
+                    const int32_t length = getSameColorLength( x, 255 );
+                    if ( length < 0x40 ) {
+                        data.push_back( static_cast<uint8_t>( 0xC0 + length ) );
+                    }
+                    else {
+                        data.push_back( 0xC1 );
+                        data.push_back( static_cast<uint8_t>( length ) );
+                    }
+                    data.push_back( imageY[x] );
+                    x += length;
+                }
+                else {
+                    // Pixels are copied as they are until the next run of the same color or a transform value.
+                    int32_t length = 1;
+                    while ( x + length < width && length < 0x7F && transformY[x + length] == 0 && getSameColorLength( x + length, 3 ) < 3 ) {
+                        ++length;
+                    }
+
+                    data.push_back( static_cast<uint8_t>( length ) );
+                    data.insert( data.end(), imageY + x, imageY + x + length );
+                    x += length;
+                }
+            }
+
+            // End of the row.
+            data.push_back( 0x00 );
+        }
+
+        // End of the image.
+        data.push_back( 0x80 );
+
+        return data;
+    }
+
+    void printUsage( const std::string & toolName )
+    {
+        std::cerr << toolName << " measures the performance of the image processing functions of the engine for all supported instruction sets." << std::endl
+                  << "Syntax: " << toolName << " [--csv] [width height [iterations]]" << std::endl
+                  << "--csv          print the results as comma-separated values to track them over time" << std::endl
+                  << "width, height  the size of the screen image, " << defaultWidth << "x" << defaultHeight << " by default" << std::endl
+                  << "iterations     the number of runs of every benchmark, " << defaultIterations << " by default" << std::endl;
+    }
+}
+
+int main( int argc, char ** argv )
+{
+    const std::string toolName = System::GetFileName( argv[0] );
+
+    std::vector<std::string> arguments( argv + 1, argv + argc );
+
+    bool isCsvOutput = false;
+    if ( !arguments.empty() && arguments.front() == "--csv" ) {
+        isCsvOutput = true;
+        arguments.erase( arguments.begin() );
+    }
+
+    if ( arguments.size() != 0 && arguments.size() != 2 && arguments.size() != 3 ) {
+        printUsage( toolName );
+        return EXIT_FAILURE;
+    }
+
+    const int32_t width = ( arguments.size() > 0 ) ? std::atoi( arguments[0].c_str() ) : defaultWidth;
+    const int32_t height = ( arguments.size() > 1 ) ? std::atoi( arguments[1].c_str() ) : defaultHeight;
+    const int32_t iterations = ( arguments.size() > 2 ) ? std::atoi( arguments[2].c_str() ) : defaultIterations;
+
+    if ( width <= 0 || height <= 0 || iterations <= 0 ) {
+        std::cerr << "Image size and number of iterations must be positive" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const size_t pixelCount = static_cast<size_t>( width ) * static_cast<size_t>( height );
+
+    // The content does not affect the performance but it should not be uniform to avoid any unrealistic caching effects.
+    std::vector<uint8_t> image( pixelCount );
+    for ( size_t i = 0; i < pixelCount; ++i ) {
+        image[i] = static_cast<uint8_t>( ( i * 7 + i / 13 ) % 256 );
+    }
+
+    std::vector<uint32_t> palette( 256 );
+    for ( size_t i = 0; i < palette.size(); ++i ) {
+        palette[i] = static_cast<uint32_t>( 0xFF000000 | ( i << 16 ) | ( ( 255 - i ) << 8 ) | ( i * 3 % 256 ) );
+    }
+
+    std::vector<uint32_t> output( pixelCount );
+
+    // The same area as the one used for partial screen updates: the ROI is written to the beginning of the output.
+    const int32_t roiX = width / 4;
+    const int32_t roiY = height / 4;
+    const int32_t roiWidth = width / 2;
+    const int32_t roiHeight = height / 2;
+
+    std::vector<uint8_t> gamePalette( 768 );
+    for ( size_t i = 0; i < gamePalette.size(); ++i ) {
+        gamePalette[i] = static_cast<uint8_t>( ( i * 5 ) % 64 );
+    }
+
+    fheroes2::setGamePalette( gamePalette );
+
+    // Images for the engine functions.
+    fheroes2::Sprite sprite = generateSprite( width, height );
+    std::copy( image.begin(), image.end(), sprite.image() );
+
+    fheroes2::Image display( width, height );
+    display._disableTransformLayer();
+    std::copy( image.rbegin(), image.rend(), display.image() );
+
+    fheroes2::Image layered( width, height );
+    fheroes2::Copy( sprite, layered );
+
+    const std::vector<uint8_t> imagePalette( image.rbegin(), image.rbegin() + 256 );
+
+    // The interface of the original resolution is scaled to the screen size.
+    fheroes2::Image original( originalWidth, originalHeight );
+    original._disableTransformLayer();
+    std::copy( image.begin(), image.begin() + std::min( pixelCount, static_cast<size_t>( originalWidth ) * originalHeight ), original.image() );
+
+    const fheroes2::Sprite bigSprite = generateSprite( spriteSize, spriteSize );
+
+    const std::vector<uint8_t> icnData = encodeICNSprite( bigSprite );
+
+    fheroes2::ICNHeader icnHeader;
+    icnHeader.width = static_cast<uint16_t>( spriteSize );
+    icnHeader.height = static_cast<uint16_t>( spriteSize );
+
+    const fheroes2::Size screenSize{ width, height };
+    const fheroes2::Size spriteArea{ spriteSize, spriteSize };
+
+    const std::vector<Benchmark> benchmarks{
+        { "convert8BitTo32Bit full frame", screenSize, true,
+          [&]() {
+              const int32_t size = static_cast<int32_t>( pixelCount );
+              fheroes2::convert8BitTo32Bit( image.data(), size, output.data(), size, size, 1, palette.data() );
+          } },
+        { "convert8BitTo32Bit ROI", { roiWidth, roiHeight }, true,
+          [&]() {
+              fheroes2::convert8BitTo32Bit( image.data() + roiX + static_cast<size_t>( roiY ) * width, width, output.data(), width, roiWidth, roiHeight,
+                                            palette.data() );
+          } },
+        { "Blit", screenSize, true, [&]() { fheroes2::Blit( sprite, display ); } },
+        { "Blit layered", screenSize, true, [&]() { fheroes2::Blit( sprite, layered ); } },
+        { "AlphaBlit", screenSize, true, [&]() { fheroes2::AlphaBlit( sprite, display, 128 ); } },
+        { "ApplyPalette", screenSize, true, [&]() { fheroes2::ApplyPalette( sprite, display, imagePalette ); } },
+        { "ApplyTransform", screenSize, true, [&]() { fheroes2::ApplyTransform( layered, 0, 0, width, height, 2 ); } },
+        { "Resize", screenSize, false, [&]() { fheroes2::Resize( original, display ); } },
+        { "SubpixelResize", screenSize, false, [&]() { fheroes2::SubpixelResize( original, display ); } },
+        { "Stretch", screenSize, false, [&]() { fheroes2::Stretch( bigSprite, 0, 0, spriteSize, spriteSize, width, height ); } },
+        { "CreateContour", spriteArea, false, [&]() { fheroes2::CreateContour( bigSprite, 10 ); } },
+        { "addShadow", spriteArea, false, [&]() { fheroes2::addShadow( bigSprite, { -4, 4 }, 3 ); } },
+        { "decodeICNSprite", spriteArea, false, [&]() { fheroes2::decodeICNSprite( icnData.data(), icnData.data() + icnData.size(), icnHeader ); } } };
+
+    const std::vector<fheroes2::SimdInstructionSet> supportedInstructionSets = fheroes2::getSupportedSimdInstructionSets();
+
+    // The best instruction set is selected by default.
+    const fheroes2::SimdInstructionSet defaultInstructionSet = fheroes2::getSimdInstructionSet();
+
+    if ( isCsvOutput ) {
+        std::cout << "benchmark,instruction_set,width,height,iterations,time_ms" << std::endl;
+    }
+    else {
+        std::cout << "Screen size: " << width << "x" << height << ", iterations: " << iterations << std::endl;
+    }
+
+    for ( const Benchmark & benchmark : benchmarks ) {
+        if ( !isCsvOutput ) {
+            std::cout << std::endl << benchmark.name << " (" << benchmark.size.width << "x" << benchmark.size.height << ")" << std::endl;
+        }
+
+        const std::vector<fheroes2::SimdInstructionSet> instructionSets
+            = benchmark.hasSimdPaths ? supportedInstructionSets : std::vector<fheroes2::SimdInstructionSet>{ defaultInstructionSet };
+
+        double scalarTime = 0;
+
+        for ( const fheroes2::SimdInstructionSet instructionSet : instructionSets ) {
+            fheroes2::setSimdInstructionSet( instructionSet );
+
+            const double time = measure( benchmark.run, iterations );
+            if ( instructionSet == fheroes2::SimdInstructionSet::NONE ) {
+                scalarTime = time;
+            }
+
+            if ( isCsvOutput ) {
+                std::cout << benchmark.name << "," << fheroes2::getSimdInstructionSetName( instructionSet ) << "," << benchmark.size.width << ","
+                          << benchmark.size.height << "," << iterations << "," << std::fixed << std::setprecision( 4 ) << time << std::endl;
+                continue;
+            }
+
+            std::cout << "    " << std::left << std::setw( 8 ) << fheroes2::getSimdInstructionSetName( instructionSet ) << std::right << std::fixed
+                      << std::setprecision( 3 ) << std::setw( 10 ) << time << " ms";
+
+            if ( benchmark.hasSimdPaths ) {
+                std::cout << std::setprecision( 2 ) << std::setw( 8 ) << scalarTime / time << "x";
+            }
+
+            std::cout << std::endl;
+        }
+
+        fheroes2::setSimdInstructionSet( defaultInstructionSet );
+    }
+
+    return EXIT_SUCCESS;
+}